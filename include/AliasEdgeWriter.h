@@ -1,6 +1,7 @@
 #ifndef ALIASEDGEWRITER_H
 #define ALIASEDGEWRITER_H
 
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/Statistic.h"
 #include "llvm/Analysis/AliasAnalysis.h"
 #include "llvm/Analysis/LoopInfo.h"
@@ -40,6 +41,13 @@ struct AliasEdgeWriter : public llvm::ModulePass {
     static char ID;
     std::map<std::string, uint64_t> Data;
     bool print = false;
+    bool dumpStats = true;
+
+    // Functions analyzed on their own, without a call site
+    std::set<std::string> FunctionNames;
+    // Functions whose memory operations have been paired, the maps hold no
+    // edge of the other ones
+    llvm::SmallPtrSet<const llvm::Function *, 8> AnalyzedFunctions;
 
     llvm::SmallVector<std::pair<uint32_t, uint32_t>, 16> NaiveAliasEdges;
     llvm::SmallVector<std::pair<uint32_t, uint32_t>, 16> AliasEdges;
@@ -61,6 +69,14 @@ struct AliasEdgeWriter : public llvm::ModulePass {
 
     AliasEdgeWriter() : llvm::ModulePass(ID), print(false) {}
 
+    // The functions are expected to be labeled already, no statistics file
+    // is written
+    AliasEdgeWriter(std::set<std::string> FunctionNames)
+        : llvm::ModulePass(ID),
+          print(false),
+          dumpStats(false),
+          FunctionNames(FunctionNames) {}
+
     virtual bool runOnModule(llvm::Module &) override;
     virtual bool doInitialization(llvm::Module &M) override;
     virtual bool doFinalization(llvm::Module &M) override;
@@ -70,6 +86,7 @@ struct AliasEdgeWriter : public llvm::ModulePass {
     llvm::StringRef getPassName() const override { return "AliasEdgeWriter"; }
     virtual void getAnalysisUsage(llvm::AnalysisUsage &AU) const override {
         AU.addRequired<llvm::AAResultsWrapperPass>();
+        AU.setPreservesAll();
     }
 };
 }
@@ -1,13 +1,16 @@
 #ifndef COMMON_H
 #define COMMON_H
 
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/SetVector.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Analysis/LoopInfo.h"
 #include "llvm/Analysis/ScalarEvolution.h"
 #include "llvm/IR/CallSite.h"
 #include "llvm/IR/DebugInfo.h"
+#include "llvm/IR/Dominators.h"
 #include "llvm/IR/InstVisitor.h"
 #include "llvm/IR/LegacyPassManager.h"
 #include "llvm/IR/Module.h"
@@ -15,9 +18,12 @@
 
 #include "NodeType.h"
 
+#include <list>
 #include <map>
+#include <set>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #define WARNING(x)                                                 \
     do {                                                           \
@@ -94,6 +100,68 @@ bool helperReplace(std::string &, const std::string &,
                    std::list<std::pair<uint32_t, uint32_t>> &,
                    const std::string &);
 
+/**
+ * Value of one placeholder inside a TemplateString
+ * Strings are only referenced, so the argument should not outlive the
+ * expression which renders the template.
+ */
+class TemplateArg {
+   public:
+    enum ArgKind { StringArg = 0, OwnedArg, UnsignedArg, SignedArg };
+
+   private:
+    ArgKind kind;
+    llvm::StringRef str;
+    std::string owned;
+    uint64_t unsigned_num;
+    int64_t signed_num;
+
+   public:
+    TemplateArg(const std::string &_v) : kind(StringArg), str(_v) {}
+    TemplateArg(const char *_v) : kind(StringArg), str(_v) {}
+    TemplateArg(llvm::StringRef _v) : kind(StringArg), str(_v) {}
+    TemplateArg(const uint32_t _v) : kind(UnsignedArg), unsigned_num(_v) {}
+    TemplateArg(const int _v) : kind(SignedArg), signed_num(_v) {}
+
+    // Same formats as the list overloads of helperReplace
+    TemplateArg(const std::vector<uint32_t> &, const std::string &);
+    TemplateArg(const std::list<std::pair<uint32_t, uint32_t>> &,
+                const std::string &);
+
+    void write(llvm::raw_ostream &) const;
+};
+
+/**
+ * TemplateString is a printing template with $placeholders that is parsed
+ * only once, it is meant to be kept as a static object next to the print
+ * function using it. The keys are substituted in the given order, exactly
+ * as a sequence of helperReplace calls would do, so keys which are prefix
+ * of each other (e.g. $id and $idx) keep their old behavior.
+ */
+class TemplateString {
+    struct Segment {
+        std::string text;
+        // Index of the key, or -1 for literal text
+        int32_t key;
+    };
+
+    std::vector<Segment> segments;
+    uint32_t num_keys;
+
+   public:
+    TemplateString(const std::string &, std::initializer_list<const char *>);
+
+    void render(llvm::raw_ostream &, std::initializer_list<TemplateArg>) const;
+    std::string render(std::initializer_list<TemplateArg>) const;
+};
+
+/**
+ * Writes the contents to the file only if the file doesn't already have the
+ * same contents, so the timestamp of unchanged outputs is kept.
+ * Returns true if the file has been written.
+ */
+bool writeIfChanged(const std::string &, llvm::StringRef);
+
 /**
  * FUNCTIONS
  */
@@ -215,7 +283,14 @@ class GepInformation : public ModulePass, public InstVisitor<GepInformation> {
     // Function name
     llvm::StringRef function_name;
 
-    GepInformation(llvm::StringRef FN) : ModulePass(ID), function_name(FN) {}
+    // Target functions, all of them are visited in a single traversal
+    std::set<std::string> function_names;
+
+    GepInformation(llvm::StringRef FN)
+        : ModulePass(ID), function_name(FN), function_names({FN.str()}) {}
+
+    GepInformation(std::set<std::string> FNs)
+        : ModulePass(ID), function_name(""), function_names(FNs) {}
 
     bool doInitialization(Module &) override { return false; };
 
@@ -228,6 +303,97 @@ class GepInformation : public ModulePass, public InstVisitor<GepInformation> {
     }
 };
 
+/**
+ * Memory partition of a function. Each bank object gets a memory unit of its
+ * own, memory operations which are not in the object map stay on the shared
+ * memory unit.
+ */
+struct MemoryPartition {
+    // Bank objects in the order they are first accessed
+    llvm::SmallVector<const llvm::Value *, 4> banks;
+
+    // Memory operation -> its bank object or alloca
+    llvm::DenseMap<const llvm::Instruction *, const llvm::Value *> objects;
+};
+
+/**
+ * MemoryBanking splits the memory operations of the target functions by the
+ * object they access. Globals and noalias arguments which no other pointer
+ * can reach are banked, the operations on an alloca go to its scratchpad.
+ */
+class MemoryBanking : public ModulePass {
+   public:
+    static char ID;
+
+    // Target functions, all of them are visited in a single traversal
+    std::set<std::string> function_names;
+
+    std::map<const llvm::Function *, MemoryPartition> Partitions;
+
+    MemoryBanking(std::set<std::string> FNs)
+        : ModulePass(ID), function_names(FNs) {}
+
+    static MemoryPartition partition(llvm::Function &);
+
+    const MemoryPartition *getPartition(const llvm::Function *F) const {
+        auto It = Partitions.find(F);
+        return It == Partitions.end() ? nullptr : &It->second;
+    }
+
+    bool runOnModule(Module &) override;
+
+    void getAnalysisUsage(AnalysisUsage &AU) const override {
+        AU.setPreservesAll();
+    }
+};
+
+/**
+ * Affine access of a streamed load or store, the address moves by stride
+ * bytes on each of the trip count iterations of its loop
+ */
+struct StreamInfo {
+    int32_t stride;
+    uint32_t trip_count;
+};
+
+/**
+ * MemoryStreams finds the loads and stores of the target functions which can
+ * be turned into streams. Their address is an affine function of the
+ * induction variable of a loop with a constant trip count, and no other
+ * access in the loop can touch their object while the stream runs ahead.
+ * NOTE: dandelion doesn't schedule the pass until muIR-lib has the stream
+ * load and store modules.
+ */
+class MemoryStreams : public ModulePass {
+   public:
+    static char ID;
+
+    // Target functions, all of them are visited in a single traversal
+    std::set<std::string> function_names;
+
+    llvm::DenseMap<const llvm::Instruction *, StreamInfo> Streams;
+
+    MemoryStreams(std::set<std::string> FNs)
+        : ModulePass(ID), function_names(FNs) {}
+
+    void findStreams(llvm::Function &, llvm::ScalarEvolution &,
+                     llvm::LoopInfo &, llvm::DominatorTree &);
+
+    const StreamInfo *getStream(const llvm::Instruction *I) const {
+        auto It = Streams.find(I);
+        return It == Streams.end() ? nullptr : &It->second;
+    }
+
+    bool runOnModule(Module &) override;
+
+    void getAnalysisUsage(AnalysisUsage &AU) const override {
+        AU.addRequired<llvm::DominatorTreeWrapperPass>();
+        AU.addRequired<llvm::LoopInfoWrapperPass>();
+        AU.addRequired<llvm::ScalarEvolutionWrapperPass>();
+        AU.setPreservesAll();
+    }
+};
+
 class InstCounter : public llvm::ModulePass {
    public:
     static char ID;
@@ -0,0 +1,52 @@
+#ifndef DANDELION_ARENA_H
+#define DANDELION_ARENA_H
+#include <stdint.h>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "llvm/Support/Allocator.h"
+
+namespace dandelion {
+
+/**
+ * Arena is a bump allocator that owns every object created through it.
+ * Objects are laid out back to back in large slabs and all of them are
+ * released at once when the arena dies, destructors run in reverse creation
+ * order. Objects that are trivially destructible, e.g. edges, don't register
+ * any cleanup at all.
+ */
+class Arena {
+  llvm::BumpPtrAllocator allocator;
+
+  // Cleanup list of the objects which need a destructor call
+  std::vector<std::pair<void*, void (*)(void*)>> destructors;
+
+public:
+  Arena() = default;
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  ~Arena() {
+    for (auto _obj = destructors.rbegin(); _obj != destructors.rend(); ++_obj)
+      _obj->second(_obj->first);
+  }
+
+  template <typename T, typename... Args>
+  T*
+  create(Args&&... args) {
+    auto _obj = new (allocator.Allocate<T>()) T(std::forward<Args>(args)...);
+    if (!std::is_trivially_destructible<T>::value)
+      destructors.emplace_back(_obj, [](void* _ptr) { static_cast<T*>(_ptr)->~T(); });
+    return _obj;
+  }
+
+  size_t
+  getBytesAllocated() const {
+    return allocator.getBytesAllocated();
+  }
+};
+
+}  // namespace dandelion
+
+#endif  // end of DANDELION_ARENA_H
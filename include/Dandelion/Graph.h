@@ -10,6 +10,10 @@
 #include <fstream>
 #include <ostream>
 #include <set>
+#include <unordered_map>
+#include <vector>
+
+#include "llvm/ADT/Hashing.h"
 
 #ifdef __APPLE__
 #include "json/json.h"
@@ -17,6 +21,7 @@
 #include "jsoncpp/json/json.h"
 #endif
 
+#include "Dandelion/Arena.h"
 #include "Dandelion/Edge.h"
 #include "Dandelion/Node.h"
 #include "iterator_range.h"
@@ -25,22 +30,55 @@ using common::GepInfo;
 
 namespace dandelion {
 
-using InstructionList = std::list<std::unique_ptr<InstructionNode>>;
-using ArgumentList    = std::list<std::unique_ptr<ArgumentNode>>;
-using BasicBlockList  = std::list<std::unique_ptr<SuperNode>>;
-using GlobalValueList = std::list<GlobalValueNode>;
-using ConstIntList    = std::list<std::unique_ptr<ConstIntNode>>;
-using ConstFPList     = std::list<std::unique_ptr<ConstFPNode>>;
-using LoopNodeList    = std::list<std::unique_ptr<LoopNode>>;
-using ScratchpadList  = std::list<std::unique_ptr<ScratchpadNode>>;
-using EdgeList        = std::list<std::unique_ptr<Edge>>;
+namespace muir {
+class MuIRFile;
+}
+
+// Nodes and edges are owned by the graph arena, the lists only keep the order
+using InstructionList = std::vector<InstructionNode*>;
+using ArgumentList    = std::vector<ArgumentNode*>;
+using BasicBlockList  = std::vector<SuperNode*>;
+using GlobalValueList = std::vector<GlobalValueNode*>;
+using ConstIntList    = std::vector<ConstIntNode*>;
+using ConstFPList     = std::vector<ConstFPNode*>;
+using LoopNodeList    = std::vector<LoopNode*>;
+using ScratchpadList  = std::vector<ScratchpadNode*>;
+using MemoryBankList  = std::vector<MemoryNode*>;
+using EdgeList        = std::list<Edge*>;
 using Port            = std::pair<Node*, PortID>;
 
+/**
+ * Keys used to index the edge list by its endpoints
+ */
+using PortPair = std::pair<Port, Port>;
+using NodePair = std::pair<const Node*, const Node*>;
+
+struct PortPairHash {
+  size_t
+  operator()(const PortPair& _key) const {
+    return llvm::hash_combine(_key.first.first,
+                              _key.first.second.ID,
+                              _key.second.first,
+                              _key.second.second.ID);
+  }
+};
+
+struct NodePairHash {
+  size_t
+  operator()(const NodePair& _key) const {
+    return llvm::hash_combine(_key.first, _key.second);
+  }
+};
+
 class Graph {
 public:
   NodeInfo graph_info;
 
 private:
+  // Storage of all the nodes and edges of the graph, it has to outlive
+  // the containers below
+  Arena arena;
+
   // Node information
 
   // List of elements inside each graph
@@ -60,8 +98,17 @@ private:
   // List of the edges between nodes inside the graph
   EdgeList edge_list;
 
-  // Memory units inside each graph
+  // Edge lookup tables, the edge list keeps the insertion order
+  // and these tables only point into it
+  std::unordered_map<PortPair, Edge*, PortPairHash> edge_port_index;
+  std::unordered_map<NodePair, std::vector<EdgeList::iterator>, NodePairHash>
+      edge_node_index;
+
+  // Memory units inside each graph, the shared unit and one bank for each
+  // memory object which is accessed on its own
   std::unique_ptr<MemoryNode> memory_unit;
+  MemoryBankList memory_banks;
+  std::unordered_map<const llvm::Value*, MemoryNode*> memory_bank_map;
 
   // Local memories
   ScratchpadList scratchpad_memories;
@@ -72,6 +119,12 @@ private:
   // Loop nodes
   LoopNodeList loop_nodes;
 
+  // Nodes fused away by fuseInstructions until eraseFusedNodes drops them from
+  // the lists, the root of each fused group maps to its fused node and the
+  // other members and the folded constants to nullptr
+  std::unordered_map<const Node*, Node*> fused_nodes;
+  std::set<Node*> fused_parents;
+
   llvm::Function* function_ptr;
 
   // Out interface
@@ -125,7 +178,7 @@ public:
   void printGraph(PrintType);
   void printGraph(PrintType, std::string json_path);
 
-  ScratchpadNode* returnScratchpadMem(AllocaInst* alloca);
+  ScratchpadNode* returnScratchpadMem(const AllocaInst* alloca);
 
   bool
   isEmpty() {
@@ -135,6 +188,18 @@ public:
   getMemoryUnit() const {
     return memory_unit.get();
   }
+  MemoryNode* getMemoryUnit(const llvm::Value* _obj) const;
+  MemoryNode* createMemoryBank(const llvm::Value* _obj);
+
+  /**
+   * The shared unit followed by the banks
+   */
+  std::vector<MemoryNode*>
+  getMemoryUnits() const {
+    std::vector<MemoryNode*> _units{memory_unit.get()};
+    _units.insert(_units.end(), memory_banks.begin(), memory_banks.end());
+    return _units;
+  }
   auto
   getFPUNode() const {
     return floating_point_unit.get();
@@ -259,7 +324,12 @@ public:
   InstructionNode* insertFcmpNode(llvm::FCmpInst&);
   ConstFPNode* insertConstFPNode(llvm::ConstantFP&);
 
-  LoopNode* insertLoopNode(std::unique_ptr<LoopNode>);
+  template <typename... Args>
+  LoopNode*
+  insertLoopNode(Args&&... args) {
+    loop_nodes.push_back(arena.create<LoopNode>(std::forward<Args>(args)...));
+    return loop_nodes.back();
+  }
 
   void breakEdge(Node*, Node*, Node*);
 
@@ -271,6 +341,11 @@ public:
 
   Edge* insertMemoryEdge(Edge::EdgeType, Port src, Port dst);
 
+private:
+  Edge* indexEdge(EdgeList::iterator);
+
+public:
+
   SplitCallNode*
   getSplitCall() const {
     return split_call.get();
@@ -286,7 +361,18 @@ public:
   void optimizationPasses();
   void groundStoreNodes();
   void groundReattachNode();
+
+  FusedComputeNode* fuseInstructions(llvm::ArrayRef<InstructionNode*> members,
+                                     llvm::ArrayRef<ConstIntNode*> constants);
+  void eraseFusedNodes();
   void printMUIR();
+  void printMUIRBinary();
+
+  // Recording the node, edge and port counts in the generator statistics
+  void collectStats();
+
+  // Rebuilding an empty graph from a binary muIR file
+  void loadMUIRBinary(const muir::MuIRFile&);
 
 protected:
   // General print functions with accepting print type
@@ -306,6 +392,7 @@ protected:
   void printDatadependencies(PrintType);
   void printControlDependencies(PrintType);
   void printClosingclass(PrintType);
+  void printFusedModules(PrintType);
   void printLoopEndingDependencies(PrintType _pt);
   void printLoopBranchEdges(PrintType);
   void printLoopHeader(PrintType);
@@ -0,0 +1,91 @@
+#ifndef DANDELION_GRAPHPASSES_H
+#define DANDELION_GRAPHPASSES_H
+#include <stdint.h>
+#include <unordered_map>
+
+#include "Dandelion/PassManager.h"
+
+extern llvm::cl::opt<unsigned> fuseDelay;
+
+namespace dandelion {
+namespace passes {
+
+//===----------------------------------------------------------------------===//
+//                              Analyses
+//===----------------------------------------------------------------------===//
+
+/**
+ * Bitwidth inference finds the widths the integer values of the graph can
+ * take. The widths the graph generator found from the known bits and the
+ * ranges of LLVM are the starting point, the canonical induction variables
+ * are bounded by the trip count of their loop, and the widths are then
+ * propagated forward through the operations until nothing changes.
+ */
+struct BitwidthAnalysis {
+  // Width each narrowed node computes with, the nodes which aren't in it take
+  // all XLEN bits. It's the width of the value of the node except for the
+  // operations which need their operands in full, shifts right, divisions,
+  // remainders and compares, which get the width of their operands.
+  using Result = std::unordered_map<const Node*, uint32_t>;
+
+  static char ID;
+  static const char*
+  getName() {
+    return "bitwidth-analysis";
+  }
+
+  Result run(Graph&, AnalysisManager&);
+};
+
+//===----------------------------------------------------------------------===//
+//                           Transformations
+//===----------------------------------------------------------------------===//
+
+/**
+ * Grounds the data output of the store nodes nothing consumes
+ */
+class GroundStoreNodes : public GraphPass {
+public:
+  const char*
+  getName() const override {
+    return "ground-stores";
+  }
+  PreservedAnalyses run(Graph&, AnalysisManager&) override;
+};
+
+/**
+ * Narrows the integer nodes to the widths BitwidthAnalysis found for them
+ */
+class NarrowWidths : public GraphPass {
+public:
+  const char*
+  getName() const override {
+    return "narrow-widths";
+  }
+  PreservedAnalyses run(Graph&, AnalysisManager&) override;
+};
+
+/**
+ * Operator fusion merges the single consumer chains of combinational integer
+ * operations inside a super node into one FusedComputeNode, so the chain
+ * takes one handshake instead of one for each operation. A chain is grown
+ * from the operation whose value leaves it towards its operands as long as
+ * the estimated delay of its longest path stays within -fuse-delay, and the
+ * constants it uses are folded into its expression.
+ * Each fused node is printed with a module of its own, muIR-lib has no
+ * module for it. The pass runs at -H2 and above, after narrow-widths so the
+ * delays are the narrowed ones.
+ */
+class FuseComputeNodes : public GraphPass {
+public:
+  const char*
+  getName() const override {
+    return "fuse-compute";
+  }
+  PreservedAnalyses run(Graph&, AnalysisManager&) override;
+};
+
+}  // namespace passes
+}  // namespace dandelion
+
+#endif  // end of DANDELION_GRAPHPASSES_H
@@ -0,0 +1,234 @@
+#ifndef DANDELION_MUIRBINARY_H
+#define DANDELION_MUIRBINARY_H
+#include <stdint.h>
+#include <memory>
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/ErrorOr.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+namespace dandelion {
+namespace muir {
+
+/**
+ * Binary muIR format
+ *
+ * The file is a sequence of flat tables of fixed size little endian records:
+ *
+ *   FileHeader
+ *   NodeRecord      nodes[]
+ *   SuperNodeRecord super_nodes[]
+ *   LoopRecord      loops[]
+ *   ArgumentRecord  arguments[]
+ *   EdgeRecord      edges[]
+ *   uint32_t        lists[]
+ *   char            strings[]
+ *
+ * Each table starts at an 8 bytes aligned offset which is kept in the header.
+ * Records point to other nodes by their index in the node table, to strings
+ * by their offset in the string table (null terminated) and to variable size
+ * lists by a ListRef into the lists table. The file can be used directly
+ * from a mapped buffer, nothing has to be parsed to access it.
+ */
+
+const uint32_t Magic   = 0x5249554d;  // "MUIR"
+const uint32_t Version = 6;
+
+// Index of a missing node
+const uint32_t NoNode = ~0U;
+
+enum PortKind {
+  DataInput = 0,
+  DataOutput,
+  ControlInput,
+  ControlOutput,
+  MemoryReadRequest,
+  MemoryReadResponse,
+  MemoryWriteRequest,
+  MemoryWriteResponse,
+  NumPortKinds
+};
+
+struct TableRef {
+  // Offset from the beginning of the file in bytes
+  uint32_t offset;
+  // Number of the records
+  uint32_t count;
+};
+
+struct ListRef {
+  // Index of the first element inside the lists table
+  uint32_t begin;
+  // Number of elements, a PortRef element takes two entries
+  uint32_t count;
+};
+
+struct PortRef {
+  uint32_t node;
+  uint32_t port;
+};
+
+struct FileHeader {
+  uint32_t magic;
+  uint32_t version;
+  // Name of the graph
+  uint32_t name;
+  // Number of the leading node records which belong to the graph lists, the
+  // rest are only reached through the ports of other nodes
+  uint32_t graph_nodes;
+
+  TableRef nodes;
+  TableRef super_nodes;
+  TableRef loops;
+  TableRef arguments;
+  TableRef edges;
+  TableRef lists;
+  TableRef strings;
+};
+
+struct NodeRecord {
+  // Node::NodeType
+  uint32_t kind;
+  // InstructionNode::InstType, ArgumentNode::ArgumentType or
+  // ContainerNode::ContainerType
+  uint32_t sub_kind;
+  // Node::DataType
+  uint32_t data_type;
+  uint32_t id;
+  uint32_t name;
+  // Super node of an instruction, parent loop of a loop or the container
+  // of an argument
+  uint32_t parent;
+  // Source node of an argument or the alloca of a scratchpad
+  uint32_t link;
+  // Printed LLVM instruction
+  uint32_t text;
+  // Chisel expression of a fused compute node
+  uint32_t expression;
+  // Memory access width of loads and stores in bytes
+  uint32_t width;
+  // Narrowed data width of the node in bits, zero for the full XLEN
+  uint32_t data_width;
+  // LLVM opcode of an instruction and the predicate of a compare, the
+  // operation a binary, floating point or compare node prints
+  uint32_t opcode;
+  uint32_t predicate;
+  // Value of a constant, as integer or double bits. Allocas and scratchpads
+  // keep their size in the low and the number of bytes in the high word,
+  // loads and stores their stream trip count and stride
+  uint64_t value;
+
+  // Debug parents of an instruction (uint32_t)
+  ListRef debug_parents;
+  // Offsets and element size of a GEP in bytes (uint32_t)
+  ListRef element_sizes;
+  // Ports of the node in their order (PortRef)
+  ListRef ports[NumPortKinds];
+};
+
+struct SuperNodeRecord {
+  uint32_t node;
+  // SuperNode::SuperNodeType
+  uint32_t type;
+  // Node indices
+  ListRef instructions;
+  ListRef phis;
+  ListRef constants;
+};
+
+struct LoopRecord {
+  uint32_t node;
+  uint32_t parent_loop;
+  uint32_t induction;
+  // Maximum trip count, zero if it's unknown
+  uint32_t trip_count;
+  // Node indices
+  ListRef blocks;
+  // Nodes feeding the carry dependencies
+  ListRef carries;
+};
+
+struct ArgumentRecord {
+  uint32_t node;
+  // SplitCallNode::ArgType
+  uint32_t type;
+};
+
+struct EdgeRecord {
+  // Edge::EdgeType
+  uint32_t type;
+  PortRef src;
+  PortRef tar;
+};
+
+/**
+ * Read only view of a binary muIR file, the buffer is memory mapped and all
+ * the accessors return references into it
+ */
+class MuIRFile {
+  std::unique_ptr<llvm::MemoryBuffer> buffer;
+  const FileHeader* header;
+
+  explicit MuIRFile(std::unique_ptr<llvm::MemoryBuffer> _buffer);
+
+  /**
+   * Checks that every node, string and list index of the records stays inside
+   * its table and that the node kinds are the ones the loader can rebuild
+   */
+  bool verify() const;
+
+  template <typename T>
+  llvm::ArrayRef<T>
+  getTable(const TableRef& _table) const {
+    return llvm::ArrayRef<T>(
+        reinterpret_cast<const T*>(buffer->getBufferStart() + _table.offset),
+        _table.count);
+  }
+
+public:
+  /**
+   * Opens and validates a binary muIR file, the records are read in place so
+   * big endian hosts are refused
+   */
+  static llvm::ErrorOr<std::unique_ptr<MuIRFile>> open(llvm::StringRef path);
+
+  llvm::StringRef
+  getName() const {
+    return getString(header->name);
+  }
+  uint32_t
+  getGraphNodes() const {
+    return header->graph_nodes;
+  }
+
+  llvm::ArrayRef<NodeRecord>
+  nodes() const {
+    return getTable<NodeRecord>(header->nodes);
+  }
+  llvm::ArrayRef<SuperNodeRecord>
+  super_nodes() const {
+    return getTable<SuperNodeRecord>(header->super_nodes);
+  }
+  llvm::ArrayRef<LoopRecord>
+  loops() const {
+    return getTable<LoopRecord>(header->loops);
+  }
+  llvm::ArrayRef<ArgumentRecord>
+  arguments() const {
+    return getTable<ArgumentRecord>(header->arguments);
+  }
+  llvm::ArrayRef<EdgeRecord>
+  edges() const {
+    return getTable<EdgeRecord>(header->edges);
+  }
+
+  llvm::StringRef getString(uint32_t) const;
+  llvm::ArrayRef<uint32_t> getList(const ListRef&) const;
+  llvm::ArrayRef<PortRef> getPorts(const ListRef&) const;
+};
+
+}  // namespace muir
+}  // namespace dandelion
+
+#endif  // end of DANDELION_MUIRBINARY_H
@@ -1,9 +1,14 @@
 #ifndef DANDELION_NODE_H
 #define DANDELION_NODE_H
 #include <stdint.h>
+#include <algorithm>
 #include <list>
 #include <map>
+#include <unordered_map>
+#include <vector>
 
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/Analysis/LoopInfo.h"
 #include "llvm/IR/Argument.h"
 #include "llvm/IR/InstIterator.h"
@@ -24,6 +29,8 @@ using common::FloatingPointIEEE754;
 using common::GepInfo;
 
 extern cl::opt<char> HWoptLevel;
+extern cl::opt<bool> packedMemory;
+extern cl::opt<bool> narrowWidths;
 
 namespace dandelion {
 
@@ -71,19 +78,142 @@ struct PortID {
 
 using PortEntry = std::pair<Node*, PortID>;
 
+/**
+ * PortExpression is the Scala expression of one port of a node. It doesn't
+ * hold any text, streaming it asks the node to write the expression straight
+ * into the output, so connections are emitted without temporary strings.
+ */
+class PortExpression {
+public:
+  enum PortKind {
+    InputEnable,
+    OutputEnable,
+    InputData,
+    OutputData,
+    MemReadInput,
+    MemReadOutput,
+    MemWriteInput,
+    MemWriteOutput
+  };
+
+private:
+  enum ArgKind { NoArg, IndexArg, EntryArg };
+
+  Node* node;
+  PortKind kind;
+  PrintType pt;
+  ArgKind arg;
+  uint32_t index;
+  PortEntry entry;
+
+public:
+  PortExpression(Node* _node, PortKind _kind, PrintType _pt)
+      : node(_node), kind(_kind), pt(_pt), arg(NoArg), index(0) {}
+  PortExpression(Node* _node, PortKind _kind, PrintType _pt, uint32_t _index)
+      : node(_node), kind(_kind), pt(_pt), arg(IndexArg), index(_index) {}
+  PortExpression(Node* _node, PortKind _kind, PrintType _pt, PortEntry _entry)
+      : node(_node), kind(_kind), pt(_pt), arg(EntryArg), index(0), entry(_entry) {}
+
+  void write(llvm::raw_ostream&) const;
+
+  std::string
+  str() const {
+    std::string _text;
+    llvm::raw_string_ostream _os(_text);
+    write(_os);
+    return _os.str();
+  }
+  operator std::string() const {
+    return str();
+  }
+};
+
+inline llvm::raw_ostream&
+operator<<(llvm::raw_ostream& _out, const PortExpression& _port) {
+  _port.write(_out);
+  return _out;
+}
+
+/**
+ * PortList keeps the port entries of one side of a node in insertion order
+ * inside a vector. Next to the entries it keeps a table from each connected
+ * node to the positions it occupies, so looking up a port by its node doesn't
+ * walk the whole list.
+ * NOTE: The node of an entry should only be changed through replaceNode,
+ * otherwise the side table goes stale.
+ */
+class PortList {
+public:
+  using iterator       = std::vector<PortEntry>::iterator;
+  using const_iterator = std::vector<PortEntry>::const_iterator;
+
+private:
+  std::vector<PortEntry> entries;
+  std::unordered_map<const Node*, llvm::SmallVector<uint32_t, 1>> node_index;
+
+  void rebuildIndex();
+
+public:
+  iterator
+  begin() {
+    return entries.begin();
+  }
+  iterator
+  end() {
+    return entries.end();
+  }
+  const_iterator
+  begin() const {
+    return entries.begin();
+  }
+  const_iterator
+  end() const {
+    return entries.end();
+  }
+
+  size_t
+  size() const {
+    return entries.size();
+  }
+  bool
+  empty() const {
+    return entries.empty();
+  }
+
+  PortEntry& operator[](uint32_t _index) {
+    return entries[_index];
+  }
+
+  void push_back(PortEntry);
+  void resize(size_t);
+
+  // Returns the first entry connected to the node or end()
+  iterator find(const Node*);
+  bool contains(const Node*) const;
+  size_t count(const Node*) const;
+  std::list<PortEntry> findAll(const Node*) const;
+
+  void remove(const Node*);
+  void replaceNode(const Node* src, Node* tar);
+  // Replacing the node of every entry with the one the function returns for
+  // it, the entries it returns nullptr for are dropped and the rest are
+  // numbered again by their position
+  void remap(llvm::function_ref<Node*(Node*)>);
+};
+
 struct DataPort {
-  std::list<PortEntry> data_input_port;
-  std::list<PortEntry> data_output_port;
+  PortList data_input_port;
+  PortList data_output_port;
 };
 
 struct ControlPort {
-  std::list<PortEntry> control_input_port;
-  std::list<PortEntry> control_output_port;
+  PortList control_input_port;
+  PortList control_output_port;
 };
 
 struct MemoryPort {
-  std::list<PortEntry> memory_req_port;
-  std::list<PortEntry> memory_resp_port;
+  PortList memory_req_port;
+  PortList memory_resp_port;
 };
 
 struct NodeInfo {
@@ -121,6 +251,10 @@ private:
   // Node information
   NodeInfo info;
 
+  // Node name as a valid Scala identifier, it's sanitized once since every
+  // print function uses it
+  std::string scala_name;
+
   // List of data ports
   DataPort port_data;
 
@@ -131,8 +265,16 @@ private:
   MemoryPort read_port_data;
   MemoryPort write_port_data;
 
+  // Width in bits the node computes its data with, zero keeps the full XLEN.
+  // The data outputs carry this width too, except for a compare which outputs
+  // a single bit whatever width it compares with.
+  uint32_t data_width;
+
 public:  // Public methods
-  Node(NodeType _nt, NodeInfo _ni) : node_type(_nt), info(_ni) {}
+  Node(NodeType _nt, NodeInfo _ni)
+      : node_type(_nt), info(_ni), scala_name(_ni.Name), data_width(0) {
+    std::replace(scala_name.begin(), scala_name.end(), '.', '_');
+  }
 
   NodeInfo
   getInfo() {
@@ -240,10 +382,10 @@ public:  // Public methods
 
   // If there are multiple of the same node added to the list, this function
   // only returns the first PortEntry
-  std::list<PortEntry>::iterator findDataInputNode(Node*);
-  std::list<PortEntry>::iterator findDataOutputNode(Node*);
-  std::list<PortEntry>::iterator findControlInputNode(Node*);
-  std::list<PortEntry>::iterator findControlOutputNode(Node*);
+  PortList::iterator findDataInputNode(Node*);
+  PortList::iterator findDataOutputNode(Node*);
+  PortList::iterator findControlInputNode(Node*);
+  PortList::iterator findControlOutputNode(Node*);
 
   // If there are multiple of the same node added to the list, this function
   // only returns a list of PortEntry
@@ -256,6 +398,7 @@ public:  // Public methods
   void removeNodeDataOutputNode(Node*);
   void removeNodeControlInputNode(Node*);
   void removeNodeControlOutputNode(Node*);
+  void remapControlOutputNodes(llvm::function_ref<Node*(Node*)>);
 
   /// replace two nodes form the control input container
   virtual void replaceControlInputNode(Node* src, Node* tar);
@@ -390,11 +533,35 @@ public:  // Public methods
   getID() {
     return info.ID;
   }
-  std::string
+  const std::string&
   getName() {
     return info.Name;
   }
 
+  /**
+   * Returns the node name with '.' replaced by '_'
+   */
+  const std::string&
+  getScalaName() {
+    return scala_name;
+  }
+
+  uint32_t
+  getDataWidth() const {
+    return data_width;
+  }
+  void
+  setDataWidth(uint32_t _width) {
+    data_width = _width;
+  }
+  /**
+   * Returns true if the node is narrowed below XLEN
+   */
+  bool
+  isNarrowed() const {
+    return data_width != 0 && data_width < XLEN;
+  }
+
   // TODO how to define virtual functions?
   // virtual void printInitilization() {}
 
@@ -426,67 +593,123 @@ public:
     return this->info.Name + std::string(" Definition is Not defined!");
   }
 
-  virtual std::string
-  printInputEnable(PrintType, uint32_t) {
-    return this->info.Name + std::string(" EnableInput with ID Not defined!");
+  /**
+   * Port expressions are written straight into the output stream, the print*
+   * versions wrap them into a PortExpression that can be streamed or turned
+   * into a string
+   */
+  virtual void
+  emitInputEnable(llvm::raw_ostream& _out, PrintType, uint32_t) {
+    _out << this->info.Name << " EnableInput with ID Not defined!";
   }
-  virtual std::string
-  printInputEnable(PrintType, std::pair<Node*, PortID>) {
-    return this->info.Name + std::string(" EnableInput with ID Not defined!");
+  virtual void
+  emitInputEnable(llvm::raw_ostream& _out, PrintType, std::pair<Node*, PortID>) {
+    _out << this->info.Name << " EnableInput with ID Not defined!";
   }
-
-  virtual std::string
-  printInputEnable(PrintType) {
-    return this->info.Name + std::string(" EnableInput Not defined!");
+  virtual void
+  emitInputEnable(llvm::raw_ostream& _out, PrintType) {
+    _out << this->info.Name << " EnableInput Not defined!";
   }
-  virtual std::string
-  printOutputEnable(PrintType) {
-    return this->info.Name + std::string(" EnableOutput Not defined!");
+  virtual void
+  emitOutputEnable(llvm::raw_ostream& _out, PrintType) {
+    _out << this->info.Name << " EnableOutput Not defined!";
   }
-
-  virtual std::string
-  printOutputEnable(PrintType, uint32_t) {
-    return this->info.Name + std::string(" -> EnableOutput with ID Not defined!");
+  virtual void
+  emitOutputEnable(llvm::raw_ostream& _out, PrintType, uint32_t) {
+    _out << this->info.Name << " -> EnableOutput with ID Not defined!";
   }
-  virtual std::string
-  printOutputEnable(PrintType, PortEntry) {
-    return this->info.Name + std::string(" EnableInput with ID Not defined!");
+  virtual void
+  emitOutputEnable(llvm::raw_ostream& _out, PrintType, PortEntry) {
+    _out << this->info.Name << " EnableInput with ID Not defined!";
   }
-  virtual std::string
-  printInputData(PrintType) {
-    return this->info.Name + std::string(" -> DataInput Not defined!");
+  virtual void
+  emitInputData(llvm::raw_ostream& _out, PrintType) {
+    _out << this->info.Name << " -> DataInput Not defined!";
   }
-  virtual std::string
-  printInputData(PrintType, uint32_t) {
-    return this->info.Name + std::string(" -> DataInput with ID Not defined!");
+  virtual void
+  emitInputData(llvm::raw_ostream& _out, PrintType, uint32_t) {
+    _out << this->info.Name << " -> DataInput with ID Not defined!";
   }
-  virtual std::string
-  printOutputData(PrintType) {
-    return this->info.Name + std::string(" -> DataOutput Not defined!");
+  virtual void
+  emitOutputData(llvm::raw_ostream& _out, PrintType) {
+    _out << this->info.Name << " -> DataOutput Not defined!";
   }
-  virtual std::string
-  printOutputData(PrintType, uint32_t) {
-    return this->info.Name + std::string(" -> DataOutput with ID Not defined!");
+  virtual void
+  emitOutputData(llvm::raw_ostream& _out, PrintType, uint32_t) {
+    _out << this->info.Name << " -> DataOutput with ID Not defined!";
   }
-
-  virtual std::string
-  printMemReadInput(PrintType, uint32_t) {
-    return this->info.Name + std::string(" -> MemInput with ID Not defined!");
+  virtual void
+  emitMemReadInput(llvm::raw_ostream& _out, PrintType, uint32_t) {
+    _out << this->info.Name << " -> MemInput with ID Not defined!";
   }
-
-  virtual std::string
-  printMemReadOutput(PrintType, uint32_t) {
-    return this->info.Name + std::string(" -> MemOutput with ID Not defined!");
+  virtual void
+  emitMemReadOutput(llvm::raw_ostream& _out, PrintType, uint32_t) {
+    _out << this->info.Name << " -> MemOutput with ID Not defined!";
   }
-
-  virtual std::string
-  printMemWriteInput(PrintType, uint32_t) {
-    return this->info.Name + std::string(" -> MemInput with ID Not defined!");
+  virtual void
+  emitMemWriteInput(llvm::raw_ostream& _out, PrintType, uint32_t) {
+    _out << this->info.Name << " -> MemInput with ID Not defined!";
+  }
+  virtual void
+  emitMemWriteOutput(llvm::raw_ostream& _out, PrintType, uint32_t) {
+    _out << this->info.Name << " -> MemOutput with ID Not defined!";
   }
 
-  virtual std::string
-  printMemWriteOutput(PrintType, uint32_t) {
-    return this->info.Name + std::string(" -> MemOutput with ID Not defined!");
+  PortExpression
+  printInputEnable(PrintType _pt, uint32_t _arg) {
+    return PortExpression(this, PortExpression::InputEnable, _pt, _arg);
+  }
+  PortExpression
+  printInputEnable(PrintType _pt, std::pair<Node*, PortID> _arg) {
+    return PortExpression(this, PortExpression::InputEnable, _pt, _arg);
+  }
+  PortExpression
+  printInputEnable(PrintType _pt) {
+    return PortExpression(this, PortExpression::InputEnable, _pt);
+  }
+  PortExpression
+  printOutputEnable(PrintType _pt) {
+    return PortExpression(this, PortExpression::OutputEnable, _pt);
+  }
+  PortExpression
+  printOutputEnable(PrintType _pt, uint32_t _arg) {
+    return PortExpression(this, PortExpression::OutputEnable, _pt, _arg);
+  }
+  PortExpression
+  printOutputEnable(PrintType _pt, PortEntry _arg) {
+    return PortExpression(this, PortExpression::OutputEnable, _pt, _arg);
+  }
+  PortExpression
+  printInputData(PrintType _pt) {
+    return PortExpression(this, PortExpression::InputData, _pt);
+  }
+  PortExpression
+  printInputData(PrintType _pt, uint32_t _arg) {
+    return PortExpression(this, PortExpression::InputData, _pt, _arg);
+  }
+  PortExpression
+  printOutputData(PrintType _pt) {
+    return PortExpression(this, PortExpression::OutputData, _pt);
+  }
+  PortExpression
+  printOutputData(PrintType _pt, uint32_t _arg) {
+    return PortExpression(this, PortExpression::OutputData, _pt, _arg);
+  }
+  PortExpression
+  printMemReadInput(PrintType _pt, uint32_t _arg) {
+    return PortExpression(this, PortExpression::MemReadInput, _pt, _arg);
+  }
+  PortExpression
+  printMemReadOutput(PrintType _pt, uint32_t _arg) {
+    return PortExpression(this, PortExpression::MemReadOutput, _pt, _arg);
+  }
+  PortExpression
+  printMemWriteInput(PrintType _pt, uint32_t _arg) {
+    return PortExpression(this, PortExpression::MemWriteInput, _pt, _arg);
+  }
+  PortExpression
+  printMemWriteOutput(PrintType _pt, uint32_t _arg) {
+    return PortExpression(this, PortExpression::MemWriteOutput, _pt, _arg);
   }
 
   void
@@ -533,6 +756,11 @@ public:
   void addconstIntNode(ConstIntNode*);
   void addconstFPNode(ConstFPNode*);
 
+  // Replacing each instruction with the node the function returns for it,
+  // the instructions it returns nullptr for are dropped
+  void remapInstructions(llvm::function_ref<InstructionNode*(InstructionNode*)>);
+  void removeconstIntNodes(llvm::function_ref<bool(ConstIntNode*)>);
+
   bool
   hasPhi() {
     return !phi_list.empty();
@@ -604,10 +832,14 @@ public:
   }
 
   virtual std::string printDefinition(PrintType) override;
-  virtual std::string printInputEnable(PrintType, uint32_t) override;
-  virtual std::string printInputEnable(PrintType, std::pair<Node*, PortID>) override;
-  virtual std::string printOutputEnable(PrintType, uint32_t) override;
-  virtual std::string printOutputEnable(PrintType, std::pair<Node*, PortID>) override;
+  virtual void emitInputEnable(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitInputEnable(llvm::raw_ostream&,
+                               PrintType,
+                               std::pair<Node*, PortID>) override;
+  virtual void emitOutputEnable(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitOutputEnable(llvm::raw_ostream&,
+                                PrintType,
+                                std::pair<Node*, PortID>) override;
   virtual std::string printMaskOutput(PrintType, uint32_t);
   std::string printActivateEnable(PrintType);
 };
@@ -652,6 +884,11 @@ public:
     this->parent_node = node;
   }
 
+  ContainerNode*
+  getParentCallNode() {
+    return this->parent_call_node;
+  }
+
   // Define classof function so that we can use dyn_cast function
   static bool
   classof(const Node* T) {
@@ -668,8 +905,8 @@ public:
   }
 
   virtual std::string printDefinition(PrintType) override;
-  virtual std::string printInputData(PrintType, uint32_t) override;
-  virtual std::string printOutputData(PrintType, uint32_t) override;
+  virtual void emitInputData(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitOutputData(llvm::raw_ostream&, PrintType, uint32_t) override;
 };
 
 /**
@@ -725,6 +962,12 @@ public:
   uint32_t findLiveOutArgumentIndex(ArgumentNode*);
   uint32_t findCarryDepenArgumentIndex(ArgumentNode*);
 
+  /**
+   * Appends an existing argument, e.g. one loaded from muIR, to the list
+   * which matches its argument type
+   */
+  ArgumentNode* pushArgument(std::shared_ptr<ArgumentNode>);
+
   uint32_t numLiveInArgList(ArgumentNode::ArgumentType type,
                             ArgumentNode::DataType dtype);
   uint32_t numLiveOutArgList(ArgumentNode::ArgumentType type);
@@ -805,8 +1048,14 @@ public:
  * Memory unit works as a local memory for each graph
  */
 class MemoryNode : public Node {
+private:
+  // Banks have their own memory interface, the shared unit uses the
+  // accelerator one
+  bool bank;
+
 public:
-  explicit MemoryNode(NodeInfo _nf) : Node(Node::MemoryUnitTy, _nf) {}
+  explicit MemoryNode(NodeInfo _nf, bool _bank = false)
+    : Node(Node::MemoryUnitTy, _nf), bank(_bank) {}
 
   // Restrict access to data input ports
   virtual PortID
@@ -833,13 +1082,18 @@ public:
     // return true;
     return (this->numReadMemReqPort() || this->numWriteMemReqPort());
   }
+  bool
+  isBank() const {
+    return bank;
+  }
 
   virtual std::string printDefinition(PrintType) override;
-  virtual std::string printMemReadInput(PrintType, uint32_t) override;
-  virtual std::string printMemReadOutput(PrintType, uint32_t) override;
-  virtual std::string printMemWriteInput(PrintType, uint32_t) override;
-  virtual std::string printMemWriteOutput(PrintType, uint32_t) override;
+  virtual void emitMemReadInput(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitMemReadOutput(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitMemWriteInput(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitMemWriteOutput(llvm::raw_ostream&, PrintType, uint32_t) override;
   std::string printUninitilizedUnit(PrintType);
+  std::string printMemIO(PrintType);
 };
 
 /**
@@ -896,10 +1150,10 @@ public:
   }
 
   virtual std::string printDefinition(PrintType) override;
-  virtual std::string printMemReadInput(PrintType, uint32_t) override;
-  virtual std::string printMemReadOutput(PrintType, uint32_t) override;
-  virtual std::string printMemWriteInput(PrintType, uint32_t) override;
-  virtual std::string printMemWriteOutput(PrintType, uint32_t) override;
+  virtual void emitMemReadInput(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitMemReadOutput(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitMemWriteInput(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitMemWriteOutput(llvm::raw_ostream&, PrintType, uint32_t) override;
 };
 
 /**
@@ -930,8 +1184,8 @@ public:
   }
 
   virtual std::string printDefinition(PrintType) override;
-  virtual std::string printMemReadInput(PrintType, uint32_t) override;
-  virtual std::string printMemReadOutput(PrintType, uint32_t) override;
+  virtual void emitMemReadInput(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitMemReadOutput(llvm::raw_ostream&, PrintType, uint32_t) override;
 };
 
 /**
@@ -955,6 +1209,9 @@ private:
   LoopNode* parent_loop;
   std::list<InstructionNode*> instruction_list;
   InstructionNode* induction_variable;
+  // Maximum number of iterations for each entry to the loop, zero if it's
+  // unknown
+  uint32_t trip_count;
   std::list<SuperNode*> basic_block_list;
   std::list<InstructionNode*> ending_instructions;
 
@@ -977,6 +1234,8 @@ public:
   explicit LoopNode(NodeInfo _nf)
     : ContainerNode(_nf, ContainerNode::LoopNodeTy),
       parent_loop(nullptr),
+      induction_variable(nullptr),
+      trip_count(0),
       head_node(nullptr),
       latch_node(nullptr),
       exit_node(std::list<SuperNode*>()),
@@ -989,6 +1248,8 @@ public:
   explicit LoopNode(NodeInfo _nf, LoopNode* _p_l, SuperNode* _hnode, SuperNode* _lnode)
     : ContainerNode(_nf, ContainerNode::LoopNodeTy),
       parent_loop(_p_l),
+      induction_variable(nullptr),
+      trip_count(0),
       head_node(_hnode),
       latch_node(_lnode),
       outer_loop(false) {
@@ -1002,6 +1263,8 @@ public:
                     std::list<SuperNode*> _ex)
     : ContainerNode(_nf, ContainerNode::LoopNodeTy),
       parent_loop(nullptr),
+      induction_variable(nullptr),
+      trip_count(0),
       head_node(_hnode),
       latch_node(_lnode),
       exit_node(_ex),
@@ -1108,6 +1371,16 @@ public:
   setIndeuctionVariable(InstructionNode* I) {
     this->induction_variable = I;
   }
+
+  auto
+  getTripCount() const {
+    return trip_count;
+  }
+  void
+  setTripCount(uint32_t _trip_count) {
+    trip_count = _trip_count;
+  }
+
   /**
    * Make sure that loop enable signal is always set to index 0
    */
@@ -1206,10 +1479,10 @@ public:
    * Print functions
    */
   virtual std::string printDefinition(PrintType) override;
-  virtual std::string printOutputEnable(PrintType) override;
-  virtual std::string printInputEnable(PrintType, uint32_t) override;
-  virtual std::string printOutputEnable(PrintType, uint32_t) override;
-  virtual std::string printOutputEnable(PrintType, PortEntry) override;
+  virtual void emitOutputEnable(llvm::raw_ostream&, PrintType) override;
+  virtual void emitInputEnable(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitOutputEnable(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitOutputEnable(llvm::raw_ostream&, PrintType, PortEntry) override;
 };
 
 /**
@@ -1255,7 +1528,10 @@ public:
     ReturnInstrunctionTy,
     CallInstructionTy,
     CallInInstructionTy,
-    CallOutInstructionTy
+    CallOutInstructionTy,
+
+    // Chain of operations fused into one node by the graph passes
+    FusedInstructionTy
   };
 
 private:
@@ -1263,13 +1539,22 @@ private:
   DataType data_type;
   llvm::Instruction* parent_instruction;
   SuperNode* parent_node;
+  // LLVM opcode of the instruction, kept apart so the nodes loaded from muIR
+  // print the same operation
+  uint32_t llvm_opcode;
+
+  // Printed instruction of a node loaded from muIR, such a node has no LLVM
+  // instruction behind it
+  std::string instruction_text;
 
 public:
   InstructionNode(NodeInfo _ni, InstType _ins_t, llvm::Instruction* _ins = nullptr)
     : Node(Node::InstructionNodeTy, _ni),
       ins_type(_ins_t),
       data_type(UknownType),
-      parent_instruction(_ins) {}
+      parent_instruction(_ins),
+      parent_node(nullptr),
+      llvm_opcode(_ins ? _ins->getOpcode() : 0) {}
 
   InstructionNode(NodeInfo _ni,
                   InstType _ins_t,
@@ -1278,10 +1563,18 @@ public:
     : Node(Node::InstructionNodeTy, _ni),
       ins_type(_ins_t),
       data_type(_dtype),
-      parent_instruction(_ins) {}
+      parent_instruction(_ins),
+      parent_node(nullptr),
+      llvm_opcode(_ins ? _ins->getOpcode() : 0) {}
 
   llvm::Instruction* getInstruction();
 
+  void
+  setInstructionText(llvm::StringRef _text) {
+    this->instruction_text = _text.str();
+  }
+  void printInstruction(llvm::raw_ostream&);
+
   std::vector<int> debug_parent_node;
 
   void
@@ -1298,6 +1591,10 @@ public:
   getDataType() const {
     return data_type;
   }
+  void
+  setDataType(DataType _dtype) {
+    this->data_type = _dtype;
+  }
   bool
   isPointerType() const {
     return data_type == Node::PointerType;
@@ -1316,9 +1613,17 @@ public:
     return ins_type;
   }
 
+  uint32_t
+  getLLVMOpCode() const {
+    return llvm_opcode;
+  }
+  void
+  setLLVMOpCode(uint32_t _opcode) {
+    this->llvm_opcode = _opcode;
+  }
   const std::string
   getOpCodeName() {
-    return parent_instruction->getOpcodeName();
+    return llvm::Instruction::getOpcodeName(llvm_opcode);
   }
 
   bool
@@ -1353,9 +1658,9 @@ public:
   }
 
   virtual std::string printDefinition(PrintType) override;
-  virtual std::string printInputEnable(PrintType) override;
-  virtual std::string printOutputData(PrintType, uint32_t) override;
-  virtual std::string printInputData(PrintType, uint32_t) override;
+  virtual void emitInputEnable(llvm::raw_ostream&, PrintType) override;
+  virtual void emitOutputData(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitInputData(llvm::raw_ostream&, PrintType, uint32_t) override;
 };
 
 class FaddOperatorNode : public InstructionNode {
@@ -1374,9 +1679,9 @@ public:
   }
 
   virtual std::string printDefinition(PrintType) override;
-  virtual std::string printInputEnable(PrintType) override;
-  virtual std::string printOutputData(PrintType, uint32_t) override;
-  virtual std::string printInputData(PrintType, uint32_t) override;
+  virtual void emitInputEnable(llvm::raw_ostream&, PrintType) override;
+  virtual void emitOutputData(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitInputData(llvm::raw_ostream&, PrintType, uint32_t) override;
 };
 
 class FdiveOperatorNode : public InstructionNode {
@@ -1407,17 +1712,29 @@ public:
   }
 
   virtual std::string printDefinition(PrintType) override;
-  virtual std::string printInputEnable(PrintType) override;
-  virtual std::string printOutputData(PrintType, uint32_t) override;
-  virtual std::string printInputData(PrintType, uint32_t) override;
-  virtual std::string printMemReadInput(PrintType, uint32_t) override;
-  virtual std::string printMemReadOutput(PrintType, uint32_t) override;
+  virtual void emitInputEnable(llvm::raw_ostream&, PrintType) override;
+  virtual void emitOutputData(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitInputData(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitMemReadInput(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitMemReadOutput(llvm::raw_ostream&, PrintType, uint32_t) override;
 };
 
 class IcmpNode : public InstructionNode {
+  llvm::CmpInst::Predicate predicate;
+
 public:
   IcmpNode(NodeInfo _ni, llvm::ICmpInst* _ins = nullptr)
-    : InstructionNode(_ni, InstructionNode::IcmpInstructionTy, _ins) {}
+    : InstructionNode(_ni, InstructionNode::IcmpInstructionTy, _ins),
+      predicate(_ins ? _ins->getPredicate() : llvm::CmpInst::BAD_ICMP_PREDICATE) {}
+
+  llvm::CmpInst::Predicate
+  getPredicate() const {
+    return predicate;
+  }
+  void
+  setPredicate(llvm::CmpInst::Predicate _pred) {
+    this->predicate = _pred;
+  }
 
   static bool
   classof(const InstructionNode* I) {
@@ -1429,20 +1746,31 @@ public:
   }
 
   virtual std::string printDefinition(PrintType) override;
-  virtual std::string printInputEnable(PrintType) override;
-  virtual std::string printInputData(PrintType, uint32_t) override;
-  virtual std::string printOutputData(PrintType, uint32_t) override;
+  virtual void emitInputEnable(llvm::raw_ostream&, PrintType) override;
+  virtual void emitInputData(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitOutputData(llvm::raw_ostream&, PrintType, uint32_t) override;
 };
 
 class FcmpNode : public InstructionNode {
   std::map<std::string, std::string> op_codes;
+  llvm::CmpInst::Predicate predicate;
 
 public:
   FcmpNode(NodeInfo _ni, llvm::FCmpInst* _ins = nullptr)
-    : InstructionNode(_ni, InstructionNode::FcmpInstructionTy, _ins) {
+    : InstructionNode(_ni, InstructionNode::FcmpInstructionTy, _ins),
+      predicate(_ins ? _ins->getPredicate() : llvm::CmpInst::BAD_FCMP_PREDICATE) {
     op_codes = {{"ogt", ">GT"}, {"olt", "<LT"}, {"oeq", "=EQ"}};
   }
 
+  llvm::CmpInst::Predicate
+  getPredicate() const {
+    return predicate;
+  }
+  void
+  setPredicate(llvm::CmpInst::Predicate _pred) {
+    this->predicate = _pred;
+  }
+
   static bool
   classof(const InstructionNode* I) {
     return I->getOpCode() == InstType::FcmpInstructionTy;
@@ -1453,9 +1781,9 @@ public:
   }
 
   virtual std::string printDefinition(PrintType) override;
-  virtual std::string printInputEnable(PrintType) override;
-  virtual std::string printInputData(PrintType, uint32_t) override;
-  virtual std::string printOutputData(PrintType, uint32_t) override;
+  virtual void emitInputEnable(llvm::raw_ostream&, PrintType) override;
+  virtual void emitInputData(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitOutputData(llvm::raw_ostream&, PrintType, uint32_t) override;
 };
 
 class BranchNode : public InstructionNode {
@@ -1519,10 +1847,10 @@ public:
    * Overloaded print functions
    */
   virtual std::string printDefinition(PrintType) override;
-  virtual std::string printOutputEnable(PrintType, uint32_t) override;
-  virtual std::string printInputEnable(PrintType, uint32_t) override;
-  virtual std::string printInputEnable(PrintType) override;
-  virtual std::string printInputData(PrintType, uint32_t) override;
+  virtual void emitOutputEnable(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitInputEnable(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitInputEnable(llvm::raw_ostream&, PrintType) override;
+  virtual void emitInputData(llvm::raw_ostream&, PrintType, uint32_t) override;
 };
 
 class SelectNode : public InstructionNode {
@@ -1553,9 +1881,9 @@ public:
   }
 
   virtual std::string printDefinition(PrintType) override;
-  virtual std::string printInputEnable(PrintType) override;
-  virtual std::string printInputData(PrintType, uint32_t) override;
-  virtual std::string printOutputData(PrintType, uint32_t) override;
+  virtual void emitInputEnable(llvm::raw_ostream&, PrintType) override;
+  virtual void emitInputData(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitOutputData(llvm::raw_ostream&, PrintType, uint32_t) override;
 };
 
 class PhiSelectNode : public InstructionNode {
@@ -1600,9 +1928,9 @@ public:
   }
 
   virtual std::string printDefinition(PrintType) override;
-  virtual std::string printInputEnable(PrintType) override;
-  virtual std::string printInputData(PrintType, uint32_t) override;
-  virtual std::string printOutputData(PrintType, uint32_t) override;
+  virtual void emitInputEnable(llvm::raw_ostream&, PrintType) override;
+  virtual void emitInputData(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitOutputData(llvm::raw_ostream&, PrintType, uint32_t) override;
   virtual std::string printMaskInput(PrintType);
 };
 
@@ -1663,12 +1991,12 @@ public:
   }
 
   virtual std::string printDefinition(PrintType) override;
-  virtual std::string printInputEnable(PrintType) override;
-  virtual std::string printInputData(PrintType, uint32_t) override;
-  virtual std::string printInputEnable(PrintType, uint32_t) override;
-  virtual std::string printOutputData(PrintType, uint32_t) override;
-  virtual std::string printMemReadInput(PrintType, uint32_t) override;
-  virtual std::string printMemReadOutput(PrintType, uint32_t) override;
+  virtual void emitInputEnable(llvm::raw_ostream&, PrintType) override;
+  virtual void emitInputData(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitInputEnable(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitOutputData(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitMemReadInput(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitMemReadOutput(llvm::raw_ostream&, PrintType, uint32_t) override;
 
   std::string printOffset(PrintType);
 };
@@ -1692,6 +2020,15 @@ public:
     : InstructionNode(_ni, InstructionNode::GetElementPtrInstTy, _type, _ins),
       gep_info(_info) {}
 
+  const GepInfo&
+  getGepInfo() const {
+    return gep_info;
+  }
+  void
+  setGepInfo(GepInfo _info) {
+    gep_info = _info;
+  }
+
   static bool
   classof(const InstructionNode* T) {
     return T->getOpCode() == InstructionNode::GetElementPtrInstTy;
@@ -1702,10 +2039,10 @@ public:
   }
 
   virtual std::string printDefinition(PrintType) override;
-  virtual std::string printInputEnable(PrintType) override;
-  virtual std::string printInputEnable(PrintType, uint32_t) override;
-  virtual std::string printInputData(PrintType, uint32_t) override;
-  virtual std::string printOutputData(PrintType, uint32_t) override;
+  virtual void emitInputEnable(llvm::raw_ostream&, PrintType) override;
+  virtual void emitInputEnable(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitInputData(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitOutputData(llvm::raw_ostream&, PrintType, uint32_t) override;
 };
 
 class LoadNode : public InstructionNode {
@@ -1713,6 +2050,14 @@ private:
   MemoryNode* mem_unit;
   uint32_t route_id;
 
+  // Number of bytes the load reads
+  uint32_t access_size;
+
+  // Stride in bytes and trip count of a streamed load, zero stride if the
+  // load issues one request for each access
+  int32_t stream_stride;
+  uint32_t stream_trip_count;
+
 public:
   LoadNode(NodeInfo _ni,
            llvm::LoadInst* _ins = nullptr,
@@ -1720,7 +2065,10 @@ public:
            uint32_t _id         = 0)
     : InstructionNode(_ni, InstructionNode::LoadInstructionTy, _ins),
       mem_unit(_node),
-      route_id(_id) {}
+      route_id(_id),
+      access_size(0),
+      stream_stride(0),
+      stream_trip_count(0) {}
 
   LoadNode(NodeInfo _ni,
            DataType _type,
@@ -1729,7 +2077,10 @@ public:
            uint32_t _id         = 0)
     : InstructionNode(_ni, InstructionNode::LoadInstructionTy, _type, _ins),
       mem_unit(_node),
-      route_id(_id) {}
+      route_id(_id),
+      access_size(0),
+      stream_stride(0),
+      stream_trip_count(0) {}
 
   static bool
   classof(const InstructionNode* T) {
@@ -1745,6 +2096,31 @@ public:
     mem_unit = _node;
   }
   void
+  setAccessSize(uint32_t _size) {
+    access_size = _size;
+  }
+  auto
+  getAccessSize() const {
+    return access_size;
+  }
+  void
+  setStream(int32_t _stride, uint32_t _trip_count) {
+    stream_stride     = _stride;
+    stream_trip_count = _trip_count;
+  }
+  bool
+  isStream() const {
+    return stream_stride != 0;
+  }
+  auto
+  getStreamStride() const {
+    return stream_stride;
+  }
+  auto
+  getStreamTripCount() const {
+    return stream_trip_count;
+  }
+  void
   setRouteID(uint32_t _id) {
     route_id = _id;
   }
@@ -1754,12 +2130,13 @@ public:
   }
 
   virtual std::string printDefinition(PrintType) override;
-  virtual std::string printInputEnable(PrintType) override;
-  virtual std::string printInputEnable(PrintType, uint32_t) override;
-  virtual std::string printInputData(PrintType, uint32_t) override;
-  virtual std::string printOutputData(PrintType, uint32_t) override;
-  virtual std::string printMemReadInput(PrintType, uint32_t) override;
-  virtual std::string printMemReadOutput(PrintType, uint32_t) override;
+  virtual void emitInputEnable(llvm::raw_ostream&, PrintType) override;
+  virtual void emitInputEnable(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitOutputEnable(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitInputData(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitOutputData(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitMemReadInput(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitMemReadOutput(llvm::raw_ostream&, PrintType, uint32_t) override;
 };
 
 class StoreNode : public InstructionNode {
@@ -1768,6 +2145,14 @@ private:
   uint32_t route_id;
   bool ground;
 
+  // Number of bytes the store writes
+  uint32_t access_size;
+
+  // Stride in bytes and trip count of a streamed store, zero stride if the
+  // store issues one request for each access
+  int32_t stream_stride;
+  uint32_t stream_trip_count;
+
 public:
   StoreNode(NodeInfo _ni,
             llvm::StoreInst* _ins = nullptr,
@@ -1776,7 +2161,10 @@ public:
     : InstructionNode(_ni, InstructionNode::StoreInstructionTy, _ins),
       mem_node(_mem),
       route_id(_id),
-      ground(false) {}
+      ground(false),
+      access_size(0),
+      stream_stride(0),
+      stream_trip_count(0) {}
 
   static bool
   classof(const InstructionNode* T) {
@@ -1787,6 +2175,35 @@ public:
     return isa<InstructionNode>(T) && classof(cast<InstructionNode>(T));
   }
 
+  void
+  setMemoryUnit(MemoryNode* _node) {
+    mem_node = _node;
+  }
+  void
+  setAccessSize(uint32_t _size) {
+    access_size = _size;
+  }
+  auto
+  getAccessSize() const {
+    return access_size;
+  }
+  void
+  setStream(int32_t _stride, uint32_t _trip_count) {
+    stream_stride     = _stride;
+    stream_trip_count = _trip_count;
+  }
+  bool
+  isStream() const {
+    return stream_stride != 0;
+  }
+  auto
+  getStreamStride() const {
+    return stream_stride;
+  }
+  auto
+  getStreamTripCount() const {
+    return stream_trip_count;
+  }
   void
   setRouteID(uint32_t _id) {
     route_id = _id;
@@ -1812,14 +2229,14 @@ public:
   }
 
   virtual std::string printDefinition(PrintType) override;
-  virtual std::string printInputEnable(PrintType) override;
-  virtual std::string printInputEnable(PrintType, uint32_t) override;
-  virtual std::string printOutputEnable(PrintType, uint32_t) override;
-  virtual std::string printOutputEnable(PrintType) override;
-  virtual std::string printInputData(PrintType, uint32_t) override;
-  virtual std::string printOutputData(PrintType, uint32_t) override;
-  virtual std::string printMemWriteInput(PrintType, uint32_t) override;
-  virtual std::string printMemWriteOutput(PrintType, uint32_t) override;
+  virtual void emitInputEnable(llvm::raw_ostream&, PrintType) override;
+  virtual void emitInputEnable(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitOutputEnable(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitOutputEnable(llvm::raw_ostream&, PrintType) override;
+  virtual void emitInputData(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitOutputData(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitMemWriteInput(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitMemWriteOutput(llvm::raw_ostream&, PrintType, uint32_t) override;
 
   std::string printGround(PrintType);
 };
@@ -1839,11 +2256,11 @@ public:
   }
 
   virtual std::string printDefinition(PrintType) override;
-  virtual std::string printInputEnable(PrintType) override;
-  virtual std::string printInputEnable(PrintType, uint32_t) override;
-  virtual std::string printOutputData(PrintType, uint32_t) override;
-  virtual std::string printOutputData(PrintType) override;
-  virtual std::string printInputData(PrintType, uint32_t) override;
+  virtual void emitInputEnable(llvm::raw_ostream&, PrintType) override;
+  virtual void emitInputEnable(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitOutputData(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitOutputData(llvm::raw_ostream&, PrintType) override;
+  virtual void emitInputData(llvm::raw_ostream&, PrintType, uint32_t) override;
 };
 
 /**
@@ -1923,11 +2340,11 @@ public:
     parent_graph = _g;
   }
   virtual std::string printDefinition(PrintType) override;
-  virtual std::string printInputEnable(PrintType) override;
-  virtual std::string printInputData(PrintType) override;
-  virtual std::string printOutputData(PrintType, uint32_t) override;
-  virtual std::string printOutputEnable(PrintType) override;
-  virtual std::string printOutputEnable(PrintType, uint32_t) override;
+  virtual void emitInputEnable(llvm::raw_ostream&, PrintType) override;
+  virtual void emitInputData(llvm::raw_ostream&, PrintType) override;
+  virtual void emitOutputData(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitOutputEnable(llvm::raw_ostream&, PrintType) override;
+  virtual void emitOutputEnable(llvm::raw_ostream&, PrintType, uint32_t) override;
 };
 
 class CallOutNode : public InstructionNode {
@@ -1956,9 +2373,9 @@ public:
     parent_graph = _g;
   }
   virtual std::string printDefinition(PrintType) override;
-  virtual std::string printInputEnable(PrintType) override;
-  virtual std::string printInputData(PrintType, uint32_t) override;
-  virtual std::string printOutputData(PrintType, uint32_t) override;
+  virtual void emitInputEnable(llvm::raw_ostream&, PrintType) override;
+  virtual void emitInputData(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitOutputData(llvm::raw_ostream&, PrintType, uint32_t) override;
 };
 
 class GlobalValueNode : public Node {
@@ -1990,6 +2407,9 @@ public:
       value = 0;
   }
 
+  ConstIntNode(NodeInfo _ni, int _value)
+    : Node(Node::ConstIntTy, _ni), parent_const_int(nullptr), value(_value) {}
+
   // Define classof function so that we can use dyn_cast function
   static bool
   classof(const Node* T) {
@@ -2003,8 +2423,8 @@ public:
 
   llvm::ConstantInt* getConstantParent();
   virtual std::string printDefinition(PrintType) override;
-  virtual std::string printOutputData(PrintType, uint32_t) override;
-  virtual std::string printInputEnable(PrintType) override;
+  virtual void emitOutputData(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitInputEnable(llvm::raw_ostream&, PrintType) override;
 };
 
 class ConstFPNode : public Node {
@@ -2017,7 +2437,9 @@ public:
     : Node(Node::ConstFPTy, _ni), parent_const_fp(_cfp) {
     // TODO Check the actual value of f, right now I only make sure
     // the tool doesn't break in cases that I don't support
-    if (parent_const_fp->getValueAPF().isZero())
+    if (parent_const_fp == nullptr)
+      value.f = 0;
+    else if (parent_const_fp->getValueAPF().isZero())
       value.f = 0;
     else if (parent_const_fp->getValueAPF().isNegative())
       value.f = 0;
@@ -2029,6 +2451,9 @@ public:
     // value.f = 0;
   }
 
+  ConstFPNode(NodeInfo _ni, FloatingPointIEEE754 _value)
+    : Node(Node::ConstFPTy, _ni), parent_const_fp(nullptr), value(_value) {}
+
   // Define classof function so that we can use dyn_cast function
   static bool
   classof(const Node* T) {
@@ -2050,8 +2475,8 @@ public:
 
   llvm::ConstantFP* getConstantParent();
   virtual std::string printDefinition(PrintType) override;
-  virtual std::string printOutputData(PrintType, uint32_t) override;
-  virtual std::string printInputEnable(PrintType) override;
+  virtual void emitOutputData(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitInputEnable(llvm::raw_ostream&, PrintType) override;
 };
 
 /**
@@ -2080,8 +2505,8 @@ public:
   uint32_t findLiveOutIndex(ArgumentNode*)          = delete;
 
   virtual std::string printDefinition(PrintType) override;
-  virtual std::string printOutputEnable(PrintType, uint32_t) override;
-  virtual std::string printOutputData(PrintType, uint32_t) override;
+  virtual void emitOutputEnable(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitOutputData(llvm::raw_ostream&, PrintType, uint32_t) override;
 };
 
 class DetachNode : public InstructionNode {
@@ -2099,12 +2524,12 @@ public:
   }
 
   virtual std::string printDefinition(PrintType) override;
-  virtual std::string printOutputEnable(PrintType, uint32_t) override;
-  virtual std::string printInputEnable(PrintType) override;
-  // virtual std::string printInputEnable(PrintType) override;
-  // virtual std::string printOutputData(PrintType, uint32_t) override;
-  // virtual std::string printOutputData(PrintType) override;
-  // virtual std::string printInputData(PrintType, uint32_t) override;
+  virtual void emitOutputEnable(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitInputEnable(llvm::raw_ostream&, PrintType) override;
+  // virtual void emitInputEnable(llvm::raw_ostream&, PrintType) override;
+  // virtual void emitOutputData(llvm::raw_ostream&, PrintType, uint32_t) override;
+  // virtual void emitOutputData(llvm::raw_ostream&, PrintType) override;
+  // virtual void emitInputData(llvm::raw_ostream&, PrintType, uint32_t) override;
 };
 
 /**
@@ -2125,9 +2550,9 @@ public:
   }
 
   virtual std::string printDefinition(PrintType) override;
-  virtual std::string printInputEnable(PrintType) override;
-  virtual std::string printInputData(PrintType, uint32_t) override;
-  virtual std::string printOutputData(PrintType, uint32_t) override;
+  virtual void emitInputEnable(llvm::raw_ostream&, PrintType) override;
+  virtual void emitInputData(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitOutputData(llvm::raw_ostream&, PrintType, uint32_t) override;
 };
 
 /**
@@ -2148,9 +2573,9 @@ public:
   }
 
   virtual std::string printDefinition(PrintType) override;
-  virtual std::string printInputEnable(PrintType) override;
-  virtual std::string printInputData(PrintType, uint32_t) override;
-  virtual std::string printOutputData(PrintType, uint32_t) override;
+  virtual void emitInputEnable(llvm::raw_ostream&, PrintType) override;
+  virtual void emitInputData(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitOutputData(llvm::raw_ostream&, PrintType, uint32_t) override;
 };
 
 /**
@@ -2171,9 +2596,9 @@ public:
   }
 
   virtual std::string printDefinition(PrintType) override;
-  virtual std::string printInputEnable(PrintType) override;
-  virtual std::string printInputData(PrintType, uint32_t) override;
-  virtual std::string printOutputData(PrintType, uint32_t) override;
+  virtual void emitInputEnable(llvm::raw_ostream&, PrintType) override;
+  virtual void emitInputData(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitOutputData(llvm::raw_ostream&, PrintType, uint32_t) override;
 };
 
 /**
@@ -2194,9 +2619,9 @@ public:
   }
 
   virtual std::string printDefinition(PrintType) override;
-  virtual std::string printInputEnable(PrintType) override;
-  virtual std::string printInputData(PrintType, uint32_t) override;
-  virtual std::string printOutputData(PrintType, uint32_t) override;
+  virtual void emitInputEnable(llvm::raw_ostream&, PrintType) override;
+  virtual void emitInputData(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitOutputData(llvm::raw_ostream&, PrintType, uint32_t) override;
 };
 
 /**
@@ -2217,9 +2642,9 @@ public:
   }
 
   virtual std::string printDefinition(PrintType) override;
-  virtual std::string printInputEnable(PrintType) override;
-  virtual std::string printInputData(PrintType, uint32_t) override;
-  virtual std::string printOutputData(PrintType, uint32_t) override;
+  virtual void emitInputEnable(llvm::raw_ostream&, PrintType) override;
+  virtual void emitInputData(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitOutputData(llvm::raw_ostream&, PrintType, uint32_t) override;
 };
 
 class ReattachNode : public InstructionNode {
@@ -2255,12 +2680,12 @@ public:
   }
 
   virtual std::string printDefinition(PrintType) override;
-  virtual std::string printOutputEnable(PrintType, uint32_t) override;
-  virtual std::string printInputEnable(PrintType) override;
-  virtual std::string printInputEnable(PrintType, uint32_t) override;
-  virtual std::string printInputData(PrintType, uint32_t) override;
-  // virtual std::string printOutputData(PrintType, uint32_t) override;
-  // virtual std::string printOutputData(PrintType) override;
+  virtual void emitOutputEnable(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitInputEnable(llvm::raw_ostream&, PrintType) override;
+  virtual void emitInputEnable(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitInputData(llvm::raw_ostream&, PrintType, uint32_t) override;
+  // virtual void emitOutputData(llvm::raw_ostream&, PrintType, uint32_t) override;
+  // virtual void emitOutputData(llvm::raw_ostream&, PrintType) override;
   std::string printGround(PrintType);
 };
 
@@ -2279,9 +2704,9 @@ public:
   }
 
   virtual std::string printDefinition(PrintType) override;
-  virtual std::string printOutputEnable(PrintType, uint32_t) override;
-  virtual std::string printInputEnable(PrintType) override;
-  virtual std::string printInputEnable(PrintType, uint32_t) override;
+  virtual void emitOutputEnable(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitInputEnable(llvm::raw_ostream&, PrintType) override;
+  virtual void emitInputEnable(llvm::raw_ostream&, PrintType, uint32_t) override;
 };
 
 class BitcastNode : public InstructionNode {
@@ -2299,9 +2724,61 @@ public:
   }
 
   virtual std::string printDefinition(PrintType) override;
-  virtual std::string printInputEnable(PrintType) override;
-  virtual std::string printOutputData(PrintType, uint32_t) override;
-  virtual std::string printInputData(PrintType, uint32_t) override;
+  virtual void emitInputEnable(llvm::raw_ostream&, PrintType) override;
+  virtual void emitOutputData(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitInputData(llvm::raw_ostream&, PrintType, uint32_t) override;
+};
+
+/**
+ * Single consumer chain of combinational operations of a super node fused
+ * into one compute node. The operations are kept as one Chisel expression of
+ * the inputs of the node, in(i) being its data input port i, so the chain
+ * takes one handshake instead of one for each operation. muIR-lib has no
+ * module for it, each fused node prints a module of its own named after the
+ * graph and the node.
+ */
+class FusedComputeNode : public InstructionNode {
+private:
+  std::string expression;
+  std::string module_name;
+
+public:
+  FusedComputeNode(NodeInfo _ni, std::string _expr = "")
+    : InstructionNode(_ni, InstructionNode::FusedInstructionTy),
+      expression(std::move(_expr)) {}
+
+  static bool
+  classof(const InstructionNode* T) {
+    return T->getOpCode() == InstructionNode::FusedInstructionTy;
+  }
+  static bool
+  classof(const Node* T) {
+    return isa<InstructionNode>(T) && classof(cast<InstructionNode>(T));
+  }
+
+  const std::string&
+  getExpression() const {
+    return expression;
+  }
+  void
+  setExpression(std::string _expr) {
+    this->expression = std::move(_expr);
+  }
+  const std::string&
+  getModuleName() const {
+    return module_name;
+  }
+  void
+  setModuleName(std::string _name) {
+    this->module_name = std::move(_name);
+  }
+
+  // Chisel module computing the expression, printed outside of the graph class
+  std::string printModule(PrintType);
+  virtual std::string printDefinition(PrintType) override;
+  virtual void emitInputEnable(llvm::raw_ostream&, PrintType) override;
+  virtual void emitOutputData(llvm::raw_ostream&, PrintType, uint32_t) override;
+  virtual void emitInputData(llvm::raw_ostream&, PrintType, uint32_t) override;
 };
 
 }  // namespace dandelion
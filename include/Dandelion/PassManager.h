@@ -0,0 +1,171 @@
+#ifndef DANDELION_PASSMANAGER_H
+#define DANDELION_PASSMANAGER_H
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include "Dandelion/Graph.h"
+#include "Dandelion/Stats.h"
+
+extern llvm::cl::list<std::string> graphPasses;
+
+namespace dandelion {
+namespace passes {
+
+/**
+ * muIR pass manager
+ *
+ * The optimizations on a dandelion::Graph are graph passes run in order by a
+ * PassManager. A pass can ask the AnalysisManager for the result of an
+ * analysis, which is computed the first time it is asked for and cached
+ * until a pass changes what it depends on. Every pass returns the analyses
+ * it kept valid and the others are dropped from the cache before the next
+ * pass runs.
+ *
+ * Each pass and analysis run is recorded as a stage of the graph in the
+ * generator statistics. The passes are registered by name so that
+ * -graph-passes can replace the pipeline the -H level picks.
+ */
+
+// Analyses are told apart by the address of their static ID
+using AnalysisID = const void*;
+
+/**
+ * Set of analyses a pass kept valid
+ */
+class PreservedAnalyses {
+  bool preserve_all;
+  std::set<AnalysisID> preserved;
+
+  explicit PreservedAnalyses(bool _all) : preserve_all(_all) {}
+
+public:
+  static PreservedAnalyses
+  all() {
+    return PreservedAnalyses(true);
+  }
+  static PreservedAnalyses
+  none() {
+    return PreservedAnalyses(false);
+  }
+
+  template <typename AnalysisT>
+  PreservedAnalyses&
+  preserve() {
+    preserved.insert(&AnalysisT::ID);
+    return *this;
+  }
+
+  bool
+  isPreserved(AnalysisID _id) const {
+    return preserve_all || preserved.count(_id);
+  }
+};
+
+/**
+ * Cache of the analysis results of one graph. An analysis is a class with a
+ * static ID, a name, a Result type and a run(Graph&, AnalysisManager&)
+ * function.
+ */
+class AnalysisManager {
+  struct ResultConcept {
+    virtual ~ResultConcept() = default;
+  };
+
+  template <typename ResultT>
+  struct ResultModel : ResultConcept {
+    ResultT result;
+    explicit ResultModel(ResultT&& _result) : result(std::move(_result)) {}
+  };
+
+  Graph& graph;
+  std::map<AnalysisID, std::unique_ptr<ResultConcept>> results;
+
+public:
+  explicit AnalysisManager(Graph& _graph) : graph(_graph) {}
+
+  template <typename AnalysisT>
+  typename AnalysisT::Result&
+  getResult() {
+    using ModelT = ResultModel<typename AnalysisT::Result>;
+
+    auto _cached = results.find(&AnalysisT::ID);
+    if (_cached == results.end()) {
+      stats::StageTimer _timer(graph.graph_info.Name, AnalysisT::getName());
+      auto _result = AnalysisT().run(graph, *this);
+      _cached      = results
+                    .emplace(&AnalysisT::ID, std::make_unique<ModelT>(std::move(_result)))
+                    .first;
+    }
+    return static_cast<ModelT&>(*_cached->second).result;
+  }
+
+  // Returns nullptr if the analysis hasn't run since it was last invalidated
+  template <typename AnalysisT>
+  typename AnalysisT::Result*
+  getCachedResult() {
+    auto _cached = results.find(&AnalysisT::ID);
+    if (_cached == results.end())
+      return nullptr;
+    return &static_cast<ResultModel<typename AnalysisT::Result>&>(*_cached->second)
+                .result;
+  }
+
+  void invalidate(const PreservedAnalyses&);
+};
+
+/**
+ * Transformation over a whole graph
+ */
+class GraphPass {
+public:
+  virtual ~GraphPass() = default;
+
+  virtual const char* getName() const = 0;
+  virtual PreservedAnalyses run(Graph&, AnalysisManager&) = 0;
+};
+
+class PassManager {
+  std::vector<std::unique_ptr<GraphPass>> pipeline;
+
+public:
+  void addPass(std::unique_ptr<GraphPass>);
+  // Adds a registered pass, returns false if there is none with the name
+  bool addPass(llvm::StringRef);
+
+  bool hasPass(llvm::StringRef) const;
+  bool
+  empty() const {
+    return pipeline.empty();
+  }
+
+  // Comma separated pass names, the way -graph-passes takes them
+  void print(llvm::raw_ostream&) const;
+
+  void run(Graph&);
+};
+
+//===----------------------------------------------------------------------===//
+//                            Pass registry
+//===----------------------------------------------------------------------===//
+
+bool isRegisteredPass(llvm::StringRef);
+std::unique_ptr<GraphPass> createGraphPass(llvm::StringRef);
+void printRegisteredPasses(llvm::raw_ostream&);
+
+/**
+ * Fills the pipeline of an -H optimization level, -H0 only runs the passes
+ * the circuit is wrong without and every level adds to the one below
+ */
+void buildPipeline(PassManager&, char opt_level);
+
+}  // namespace passes
+}  // namespace dandelion
+
+#endif  // end of DANDELION_PASSMANAGER_H
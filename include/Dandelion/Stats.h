@@ -0,0 +1,82 @@
+#ifndef DANDELION_STATS_H
+#define DANDELION_STATS_H
+#include <stdint.h>
+#include <chrono>
+#include <string>
+
+#include "llvm/ADT/StringRef.h"
+
+namespace dandelion {
+namespace stats {
+
+/**
+ * Generator statistics
+ *
+ * Every stage of the graph generation, e.g. summarizeLoop or one of the
+ * Graph::print phases, is recorded per graph with its wall time and the growth
+ * of the peak resident set size of the process while it runs. Stages which run
+ * more than once for a graph are accumulated. A stage which runs inside
+ * another one, like the graph passes inside optimizationPasses, is marked
+ * nested and left out of the wall time of the graph, its time is already part
+ * of the outer stage. Next to the stages each graph
+ * keeps its node, edge and port counts so the cost can be matched with the
+ * shape of the graph.
+ *
+ * The statistics are off by default, disabled timers don't read the clock or
+ * the RSS at all. Recording is thread safe, but the peak RSS belongs to the
+ * whole process so the RSS of stages running in parallel can't be told apart.
+ */
+
+void enable();
+bool isEnabled();
+
+// Peak resident set size of the process in KB
+uint64_t getPeakRSS();
+
+void addStage(llvm::StringRef graph,
+              llvm::StringRef stage,
+              double wall_ms,
+              uint64_t peak_rss_delta_kb,
+              bool nested = false);
+void setCount(llvm::StringRef graph,
+              llvm::StringRef group,
+              llvm::StringRef kind,
+              uint64_t count);
+
+/**
+ * Writes the collected statistics as a JSON file, returns false if the file
+ * can't be written
+ */
+bool writeJSON(llvm::StringRef path);
+
+/**
+ * Records the lifetime of the timer as one run of the stage, a timer started
+ * while another one of the same thread is running records a nested stage
+ */
+class StageTimer {
+  std::string graph;
+  const char* stage;
+  bool active;
+  bool nested;
+  std::chrono::steady_clock::time_point start;
+  uint64_t start_rss;
+
+public:
+  StageTimer(llvm::StringRef _graph, const char* _stage);
+  ~StageTimer();
+
+  StageTimer(const StageTimer&) = delete;
+  StageTimer& operator=(const StageTimer&) = delete;
+};
+
+template <typename Fn>
+void
+runStage(llvm::StringRef graph, const char* stage, Fn&& fn) {
+  StageTimer _timer(graph, stage);
+  fn();
+}
+
+}  // namespace stats
+}  // namespace dandelion
+
+#endif  // end of DANDELION_STATS_H
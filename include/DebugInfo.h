@@ -9,6 +9,7 @@
 #include <vector>
 #include <set>
 
+#include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/IR/CallSite.h"
 #include "llvm/IR/Instruction.h"
@@ -23,9 +24,21 @@ struct DebugInfo : public llvm::ModulePass {
   static char ID;
 
   std::map<llvm::Instruction*, llvm::BasicBlock*> inst_bb;
-  std::map<llvm::Instruction*, std::set<uint32_t>> node_operands;
+
+  // Instruction -> its set of operand ancestors in operand_sets, in the order
+  // they are analyzed
+  llvm::DenseMap<const llvm::Instruction*, uint32_t> node_operands;
+  std::vector<const llvm::Instruction*> node_order;
+
+  // Sorted sets of UIDs, an ancestry shared by several instructions is stored
+  // only once
+  std::vector<std::vector<uint32_t>> operand_sets;
+  std::map<std::vector<uint32_t>, uint32_t> operand_set_ids;
 
   std::string function_name;
+
+  // Target functions, all of them are analyzed in a single traversal
+  std::set<std::string> function_names;
   int node_id;
 
   bool print_values;
@@ -33,17 +46,34 @@ struct DebugInfo : public llvm::ModulePass {
   DebugInfo(std::string function_name, uint32_t id)
     : llvm::ModulePass(ID),
       function_name(function_name),
+      function_names({function_name}),
       node_id(id),
       print_values(false) {}
 
   DebugInfo(std::string function_name, bool print_verbose)
     : llvm::ModulePass(ID),
       function_name(function_name),
+      function_names({function_name}),
+      node_id(-1),
+      print_values(print_verbose) {}
+
+  DebugInfo(std::set<std::string> function_names, bool print_verbose)
+    : llvm::ModulePass(ID),
+      function_name(""),
+      function_names(function_names),
       node_id(-1),
       print_values(print_verbose) {}
 
   bool runOnModule(llvm::Module& m) override;
   bool doFinalization(llvm::Module& M) override;
+
+  // Sorted UIDs of the operand ancestors, empty if the instruction is not
+  // analyzed
+  llvm::ArrayRef<uint32_t> getNodeOperands(const llvm::Instruction* ins) const;
+
+private:
+  uint32_t internOperandSet(std::vector<uint32_t>& ids);
+  void visitBasicBlock(llvm::BasicBlock& bb);
 };
 
 }  // namespace debuginfo
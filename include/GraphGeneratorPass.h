@@ -1,8 +1,11 @@
 #ifndef GRAPHGENERATORPASS_H
 #define GRAPHGENERATORPASS_H
 
+#include "llvm/ADT/BitVector.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/Analysis/LoopInfo.h"
+#include "llvm/Analysis/ScalarEvolution.h"
 #include "llvm/IR/CallSite.h"
 #include "llvm/IR/Module.h"
 #include "llvm/Pass.h"
@@ -24,6 +27,7 @@
 #include "Dandelion/Edge.h"
 #include "Dandelion/Graph.h"
 #include "Dandelion/Node.h"
+#include "Dandelion/Stats.h"
 #include "DebugInfo.h"
 
 #include <map>
@@ -43,6 +47,53 @@ using EdgeList        = std::list<Edge>;
 
 namespace graphgen {
 
+/**
+ * Dense numbering of a function, the arguments come first, then the
+ * instructions in the same walk LabelUID uses to hand out the UIDs, so the
+ * labelled instructions keep their UID order. Each operand slot of an
+ * instruction gets a dense index too, which lets the data edges of the
+ * function live in bitvectors instead of value keyed maps.
+ */
+class ValueNumbering {
+  llvm::DenseMap<const llvm::Value*, uint32_t> value_index;
+  // First operand slot of each instruction by the instruction number, the
+  // last element is the number of slots
+  std::vector<uint32_t> operand_begin;
+  uint32_t num_args;
+
+public:
+  ValueNumbering() : num_args(0) {}
+
+  void number(llvm::Function&);
+  void clear();
+
+  uint32_t
+  getNumOperands() const {
+    return operand_begin.empty() ? 0 : operand_begin.back();
+  }
+
+  uint32_t getIndex(const llvm::Value*) const;
+  // First operand slot of the instruction, loops over the operands of one
+  // instruction should look it up once and add the operand numbers to it
+  uint32_t getOperandBase(const llvm::Instruction*) const;
+  uint32_t
+  getOperandIndex(const llvm::Instruction* _ins, unsigned _op_no) const {
+    assert(_op_no < _ins->getNumOperands() && "Wrong operand number!");
+    return getOperandBase(_ins) + _op_no;
+  }
+  uint32_t
+  getOperandIndex(const llvm::Use& _use) const {
+    return getOperandIndex(llvm::cast<llvm::Instruction>(_use.getUser()),
+                           _use.getOperandNo());
+  }
+};
+
+/**
+ * Value to node table of the graph. Entries move when the table grows, so a
+ * found entry should not be held across an insertion.
+ */
+using ValueNodeMap = llvm::DenseMap<llvm::Value*, Node*>;
+
 struct LoopSummary {
   std::string loop_name;
   // Control information
@@ -93,6 +144,15 @@ struct LoopSummary {
   llvm::DenseMap<llvm::Value*, llvm::SmallVector<llvm::Instruction*, 8>>
       carry_dependencies;
 
+  // Uses which cross the loop boundary, in the order of the loop blocks. The
+  // summary of the parent loop is derived from them instead of scanning the
+  // blocks of the sub-loops again
+  //
+  // Operands of the loop instructions defined outside of the loop
+  std::vector<llvm::Use*> live_in_uses;
+  // Uses of the loop instructions outside of the loop
+  std::vector<llvm::Use*> live_out_uses;
+
   std::string
   getNmae() {
     return loop_name;
@@ -113,45 +173,37 @@ public:
   llvm::DenseMap<llvm::Instruction*, llvm::SmallVector<llvm::BasicBlock*, 8>>
       blacklist_control_edge;
 
-  llvm::DenseMap<llvm::Value*, llvm::SmallVector<llvm::Instruction*, 8>>
-      blacklist_loop_live_in_data_edge;
-
-  llvm::DenseMap<llvm::Value*, llvm::SmallVector<llvm::Instruction*, 8>>
-      blacklist_loop_live_out_data_edge;
+  ValueNumbering value_numbering;
 
-  llvm::DenseMap<llvm::Value*, llvm::SmallVector<llvm::Instruction*, 8>>
-      blacklist_carry_dependency_data_edge;
+  // Operand slots, by ValueNumbering::getOperandIndex, which cross a loop
+  // boundary. They are connected through the loop ports instead of directly.
+  llvm::BitVector live_in_edges;
+  llvm::BitVector live_out_edges;
+  llvm::BitVector carry_edges;
 
-  std::map<std::pair<llvm::Value*, llvm::Value*>, ArgumentNode*> loop_edge_map;
+  // Loop whose live-in or live-out port feeds the operand slot
+  llvm::DenseMap<uint32_t, llvm::Loop*> live_in_edge_loop;
+  llvm::DenseMap<uint32_t, llvm::Loop*> live_out_edge_loop;
+  // Carry dependency port which feeds the operand slot
+  llvm::DenseMap<uint32_t, ArgumentNode*> carry_edge_node;
 
   std::map<llvm::Value*, llvm::SmallSetVector<llvm::Loop*, 8>> live_in_ins_loop_edge;
 
   std::map<llvm::Value*, std::set<std::pair<llvm::Loop*, llvm::Loop*>>>
       live_in_loop_loop_edge;
 
-  llvm::DenseMap<llvm::Loop*, std::set<std::pair<llvm::Value*, llvm::Value*>>>
-      live_in_loop_ins_edge;
-
   std::map<llvm::Value*, std::set<llvm::Loop*>> live_out_ins_loop_edge;
 
-  std::map<llvm::Value*, std::set<std::pair<llvm::Loop*, llvm::Loop*>>>
-      live_out_loop_loop_edge;
-
-  llvm::DenseMap<llvm::Loop*, std::set<std::pair<llvm::Value*, llvm::Value*>>>
-      live_out_loop_ins_edge;
-
-  std::map<llvm::Value*, std::vector<std::pair<llvm::Loop*, llvm::Loop*>>>
-      loop_loop_edge_lin_map;
-  std::map<llvm::Value*, std::vector<std::pair<llvm::Loop*, llvm::Loop*>>>
-      loop_loop_edge_lout_map;
+  ValueNodeMap map_value_node;
+  llvm::DenseMap<llvm::Loop*, LoopNode*> loop_value_node;
 
-  std::map<llvm::Value*, Loop*> live_in_outer_edge;
-  std::map<llvm::Value*, Loop*> live_out_outer_edge;
+  llvm::DenseMap<llvm::AllocaInst*, ScratchpadNode*> memory_buffer_map;
 
-  std::map<llvm::Value*, Node*> map_value_node;
-  std::map<llvm::Loop*, LoopNode*> loop_value_node;
+  // Memory banks of the current function, null if banking isn't run
+  const helpers::MemoryPartition* memory_partition;
 
-  std::map<llvm::AllocaInst*, ScratchpadNode*> memory_buffer_map;
+  // Streamed loads and stores, null if stream detection isn't run
+  const helpers::MemoryStreams* memory_streams;
 
   uint32_t LID;
 
@@ -159,12 +211,22 @@ private:
   // Loop Info
   llvm::LoopInfo* LI;
 
+  // Scalar evolution, for the trip counts and the value ranges
+  llvm::ScalarEvolution* SE;
+
   // Default value is standard out
   llvm::raw_ostream& code_out;
 
   // Dump muir file
   bool dump_muir;
 
+  // Dump muir file in the binary format
+  bool muir_binary;
+
+  // Target functions and their output streams, if it's empty only the
+  // function with the same name as the dependency graph is generated
+  std::map<std::string, llvm::raw_ostream*> targets;
+
   // NOTE: Uncomment if there is any dependent analysis
   // virtual void getAnalysisUsage(llvm::AnalysisUsage &AU) const;
 
@@ -212,6 +274,10 @@ private:
   // void makeLoopNodes(llvm::LoopInfo &loop_info);
   void buildLoopNodes(llvm::Function&, llvm::LoopInfo& loop_info);
   void updateRouteIDs(llvm::Function&);
+  void annotateDataWidths(llvm::Function&);
+  ScratchpadNode* returnScratchpadMem(llvm::Instruction*);
+  MemoryNode* returnMemoryUnit(llvm::Instruction*);
+  const helpers::StreamInfo* returnStream(llvm::Instruction*);
   void connectLoopEdge();
   void findControlPorts(llvm::Function&);
   void findDataPorts(llvm::Function&);
@@ -219,35 +285,63 @@ private:
   void connectParalleNodes(llvm::Function&);
   void connectingCalldependencies(llvm::Function&);
   void connectingAliasEdges(llvm::Function&);
+  llvm::SmallPtrSet<llvm::Instruction*, 16> findHeldStores(llvm::Function&);
   void connectingStoreToBranch(llvm::Function& F);
 
   void buildingGraph();
 
+  void resetGraph(NodeInfo, llvm::raw_ostream&);
+  void buildGraph(llvm::Function&);
+
 public:
   static char ID;
 
   GraphGeneratorPass()
     : llvm::ModulePass(ID),
       dependency_graph(std::make_unique<Graph>(NodeInfo(0, "dummy"))),
+      memory_partition(nullptr),
+      memory_streams(nullptr),
       LID(0),
-      code_out(llvm::outs()), dump_muir(false) {}
+      code_out(llvm::outs()), dump_muir(false), muir_binary(false) {}
   GraphGeneratorPass(NodeInfo _n_info, bool dump_muir = false)
     : llvm::ModulePass(ID),
       dependency_graph(std::make_unique<Graph>(_n_info)),
+      memory_partition(nullptr),
+      memory_streams(nullptr),
       LID(0),
-      code_out(llvm::outs()), dump_muir(dump_muir) {}
+      code_out(llvm::outs()), dump_muir(dump_muir), muir_binary(false) {}
 
   GraphGeneratorPass(NodeInfo _n_info, llvm::raw_ostream& out, bool dump_muir = false)
     : llvm::ModulePass(ID),
       dependency_graph(std::make_unique<Graph>(_n_info, out)),
+      memory_partition(nullptr),
+      memory_streams(nullptr),
+      LID(0),
+      code_out(out), dump_muir(dump_muir), muir_binary(false) {}
+
+  /**
+   * Generating a graph for each of the target functions in one traversal
+   * of the module, each graph is printed to its own output stream
+   */
+  GraphGeneratorPass(std::map<std::string, llvm::raw_ostream*> _targets,
+                     bool dump_muir   = false,
+                     bool muir_binary = false)
+    : llvm::ModulePass(ID),
+      dependency_graph(std::make_unique<Graph>(NodeInfo(0, "dummy"))),
+      memory_partition(nullptr),
+      memory_streams(nullptr),
       LID(0),
-      code_out(out), dump_muir(dump_muir) {}
+      code_out(llvm::outs()), dump_muir(dump_muir), muir_binary(muir_binary),
+      targets(_targets) {}
 
   virtual void
   getAnalysisUsage(llvm::AnalysisUsage& AU) const override {
     // AU.addRequired<llvm::AAResultsWrapperPass>();
-    // AU.addRequired<aew::AliasEdgeWriter>();
+    AU.addUsedIfAvailable<aew::AliasEdgeWriter>();
+    AU.addUsedIfAvailable<helpers::MemoryBanking>();
+    AU.addUsedIfAvailable<helpers::MemoryStreams>();
     AU.addRequired<llvm::LoopInfoWrapperPass>();
+    AU.addRequired<llvm::ScalarEvolutionWrapperPass>();
     AU.addRequired<helpers::GepInformation>();
     AU.addRequired<debuginfo::DebugInfo>();
     // AU.addRequired<loopclouser::LoopClouser>();
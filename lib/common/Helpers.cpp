@@ -1,14 +1,23 @@
 #define DEBUG_TYPE "helpers"
 
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/Statistic.h"
+#include "llvm/Analysis/AliasAnalysis.h"
+#include "llvm/Analysis/CaptureTracking.h"
 #include "llvm/Analysis/Passes.h"
+#include "llvm/Analysis/ScalarEvolutionExpressions.h"
+#include "llvm/Analysis/ValueTracking.h"
 #include "llvm/IR/Function.h"
+#include "llvm/IR/InstIterator.h"
 #include "llvm/IR/InstVisitor.h"
 #include "llvm/Pass.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/raw_ostream.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <experimental/iterator>
@@ -24,6 +33,9 @@ using helpers::DFGPrinter;
 using helpers::GepInformation;
 using helpers::InstCounter;
 using helpers::LabelUID;
+using helpers::MemoryBanking;
+using helpers::MemoryPartition;
+using helpers::MemoryStreams;
 using helpers::pdgDump;
 
 /**
@@ -552,7 +564,239 @@ void GepInformation::visitGetElementPtrInst(llvm::GetElementPtrInst &I) {
 
 bool GepInformation::runOnModule(Module &M) {
     for (auto &ff : M) {
-        if (ff.getName() == this->function_name) visit(&ff);
+        if (this->function_names.count(ff.getName().str())) visit(&ff);
+    }
+    return false;
+}
+
+// MemoryBanking Helper class
+namespace helpers {
+
+char MemoryBanking::ID = 0;
+}
+
+/**
+ * Whether a pointer with the underlying object Obj can't be based on an
+ * uncaptured noalias argument. Such an argument is never stored or passed on,
+ * so a pointer which is loaded or returned by a call can't hold it.
+ */
+static bool isNotBasedOnNoAliasArg(const Value *Obj) {
+    return isa<Argument>(Obj) || isa<Constant>(Obj) || isa<LoadInst>(Obj) ||
+           isa<CallInst>(Obj) || isa<InvokeInst>(Obj);
+}
+
+/**
+ * An object is only banked when every operation which can reach it accesses
+ * that object alone, an operation whose pointer can point to more than one
+ * object (through a phi or a select) keeps all of them on the shared unit.
+ * Globals are given up as soon as a single operation accesses an unknown
+ * object. A noalias argument is given up if its address escapes, or if one of
+ * the unknown pointers can't be proven not to be based on it. The partition
+ * needs two units at least, otherwise everything stays on the shared unit.
+ */
+MemoryPartition MemoryBanking::partition(Function &F) {
+    auto &DL = F.getParent()->getDataLayout();
+
+    MemoryPartition Partition;
+    SetVector<const Value *> Objects;
+    SmallPtrSet<const Value *, 8> SharedObjects;
+    SmallVector<std::pair<const Instruction *, const Value *>, 16> Accesses;
+    bool HasUnknown = false;
+    bool UnknownMayBeArg = false;
+
+    for (auto &I : instructions(F)) {
+        Value *Ptr = nullptr;
+        if (auto *LI = dyn_cast<LoadInst>(&I))
+            Ptr = LI->getPointerOperand();
+        else if (auto *SI = dyn_cast<StoreInst>(&I))
+            Ptr = SI->getPointerOperand();
+        else
+            continue;
+
+        SmallVector<Value *, 4> Objs;
+        GetUnderlyingObjects(Ptr, Objs, DL, nullptr, 0);
+
+        bool Unknown = false;
+        for (auto *Obj : Objs) {
+            auto *Arg = dyn_cast<Argument>(Obj);
+            if (isa<AllocaInst>(Obj) || isa<GlobalVariable>(Obj) ||
+                (Arg && Arg->hasNoAliasAttr() &&
+                 !PointerMayBeCaptured(Arg, false, true))) {
+                Objects.insert(Obj);
+                continue;
+            }
+
+            Unknown = true;
+            if (!isNotBasedOnNoAliasArg(Obj)) UnknownMayBeArg = true;
+        }
+        HasUnknown |= Unknown;
+
+        if (Objs.size() == 1 && !Unknown)
+            Accesses.push_back(std::make_pair(&I, Objs.front()));
+        else
+            SharedObjects.insert(Objs.begin(), Objs.end());
+    }
+
+    SmallVector<const Value *, 4> Banks;
+    bool HasShared = HasUnknown;
+    for (auto *Obj : Objects) {
+        if (isa<AllocaInst>(Obj)) continue;
+        if (SharedObjects.count(Obj) ||
+            (HasUnknown && isa<GlobalVariable>(Obj)) ||
+            (UnknownMayBeArg && isa<Argument>(Obj))) {
+            HasShared = true;
+            continue;
+        }
+        Banks.push_back(Obj);
+    }
+
+    // The operations on an alloca go to its scratchpad
+    for (auto &Access : Accesses) {
+        if (isa<AllocaInst>(Access.second) &&
+            !SharedObjects.count(Access.second))
+            Partition.objects[Access.first] = Access.second;
+    }
+
+    // The operations left out are on the shared unit
+    if (Banks.size() + HasShared < 2) return Partition;
+
+    Partition.banks = Banks;
+    for (auto &Access : Accesses) {
+        if (is_contained(Banks, Access.second))
+            Partition.objects[Access.first] = Access.second;
+    }
+
+    DEBUG(dbgs() << F.getName() << " memory banks: " << Banks.size() << "\n");
+    return Partition;
+}
+
+bool MemoryBanking::runOnModule(Module &M) {
+    for (auto &F : M) {
+        if (F.isDeclaration() || !function_names.count(F.getName().str()))
+            continue;
+        Partitions[&F] = partition(F);
+    }
+    return false;
+}
+
+// MemoryStreams Helper class
+namespace helpers {
+
+char MemoryStreams::ID = 0;
+}
+
+namespace {
+
+/**
+ * Memory accesses of a loop and its sub-loops with their objects, null if the
+ * access can't be tied to an identified object
+ */
+struct LoopAccesses {
+    SmallVector<std::pair<const Instruction *, const Value *>, 16> Reads;
+    SmallVector<std::pair<const Instruction *, const Value *>, 16> Writes;
+};
+
+const Value *getIdentifiedObject(const Value *Ptr, const DataLayout &DL) {
+    auto *Obj = GetUnderlyingObject(Ptr, DL, 0);
+    return isIdentifiedObject(Obj) ? Obj : nullptr;
+}
+
+LoopAccesses collectAccesses(Loop *L, const DataLayout &DL) {
+    LoopAccesses Accesses;
+    for (auto *BB : L->blocks()) {
+        for (auto &I : *BB) {
+            if (auto *LI = dyn_cast<LoadInst>(&I)) {
+                Accesses.Reads.push_back(std::make_pair(
+                    &I, getIdentifiedObject(LI->getPointerOperand(), DL)));
+            } else if (auto *SI = dyn_cast<StoreInst>(&I)) {
+                Accesses.Writes.push_back(std::make_pair(
+                    &I, getIdentifiedObject(SI->getPointerOperand(), DL)));
+            } else {
+                if (I.mayReadFromMemory())
+                    Accesses.Reads.push_back(std::make_pair(&I, nullptr));
+                if (I.mayWriteToMemory())
+                    Accesses.Writes.push_back(std::make_pair(&I, nullptr));
+            }
+        }
+    }
+    return Accesses;
+}
+}  // namespace
+
+/**
+ * A stream is issued once per loop entry and hands out one element on each
+ * iteration, so the access has to run on every iteration of a rotated loop
+ * whose trip count is known. A load stream only races with the writes of the
+ * loop, a store stream with any other access to its object. Allocas are left
+ * alone, their scratchpads don't have any latency to hide.
+ * Nothing here orders a store stream with the accesses after the loop, the
+ * graph makes the exiting branch of the loop wait for the stream to drain.
+ */
+void MemoryStreams::findStreams(Function &F, ScalarEvolution &SE, LoopInfo &LI,
+                                DominatorTree &DT) {
+    auto &DL = F.getParent()->getDataLayout();
+    DenseMap<Loop *, LoopAccesses> LoopCache;
+
+    for (auto &I : instructions(F)) {
+        Value *Ptr = nullptr;
+        if (auto *Load = dyn_cast<LoadInst>(&I)) {
+            if (Load->isSimple()) Ptr = Load->getPointerOperand();
+        } else if (auto *Store = dyn_cast<StoreInst>(&I)) {
+            if (Store->isSimple()) Ptr = Store->getPointerOperand();
+        }
+        if (!Ptr) continue;
+
+        auto *L = LI.getLoopFor(I.getParent());
+        if (!L || !L->getLoopLatch() ||
+            L->getExitingBlock() != L->getLoopLatch() ||
+            !DT.dominates(I.getParent(), L->getLoopLatch()))
+            continue;
+
+        auto TripCount = SE.getSmallConstantTripCount(L);
+        if (!TripCount) continue;
+
+        auto *AddRec = dyn_cast<SCEVAddRecExpr>(SE.getSCEV(Ptr));
+        if (!AddRec || AddRec->getLoop() != L || !AddRec->isAffine()) continue;
+        auto *Step = dyn_cast<SCEVConstant>(AddRec->getStepRecurrence(SE));
+        if (!Step || Step->getValue()->isZero() ||
+            Step->getAPInt().getMinSignedBits() > 32)
+            continue;
+
+        if (isa<AllocaInst>(GetUnderlyingObject(Ptr, DL, 0))) continue;
+        auto *Obj = getIdentifiedObject(Ptr, DL);
+        if (isa<StoreInst>(&I) && !Obj) continue;
+
+        auto Cached = LoopCache.find(L);
+        if (Cached == LoopCache.end())
+            Cached =
+                LoopCache.insert(std::make_pair(L, collectAccesses(L, DL)))
+                    .first;
+        auto &Accesses = Cached->second;
+
+        // Accesses which can't be told apart from the stream object
+        auto Conflicts =
+            [&](const std::pair<const Instruction *, const Value *> &A) {
+                return A.first != &I &&
+                       (!Obj || !A.second || A.second == Obj);
+            };
+        if (any_of(Accesses.Writes, Conflicts) ||
+            (isa<StoreInst>(&I) && any_of(Accesses.Reads, Conflicts)))
+            continue;
+
+        Streams[&I] = StreamInfo{
+            static_cast<int32_t>(Step->getAPInt().getSExtValue()), TripCount};
+        DEBUG(dbgs() << "Stream: " << I << " stride " << Streams[&I].stride
+                     << " trip count " << TripCount << "\n");
+    }
+}
+
+bool MemoryStreams::runOnModule(Module &M) {
+    for (auto &F : M) {
+        if (F.isDeclaration() || !function_names.count(F.getName().str()))
+            continue;
+        findStreams(F, getAnalysis<ScalarEvolutionWrapperPass>(F).getSE(),
+                    getAnalysis<LoopInfoWrapperPass>(F).getLoopInfo(),
+                    getAnalysis<DominatorTreeWrapperPass>(F).getDomTree());
     }
     return false;
 }
@@ -757,6 +1001,109 @@ bool helpers::helperReplace(std::string &str, const std::string &from,
     return _ret;
 }
 
+helpers::TemplateArg::TemplateArg(const std::vector<uint32_t> &_v,
+                                  const std::string &split)
+    : kind(OwnedArg) {
+    std::stringstream _joined;
+    std::copy(_v.begin(), _v.end(),
+              std::experimental::make_ostream_joiner(_joined, split));
+    owned = _joined.str();
+}
+
+helpers::TemplateArg::TemplateArg(
+    const std::list<std::pair<uint32_t, uint32_t>> &_v, const std::string &split)
+    : kind(OwnedArg) {
+    std::stringstream _joined;
+    for (auto &node : _v) {
+        _joined << "(" << std::to_string(node.first) << ", "
+                << std::to_string(node.second) << ") , ";
+    }
+    // Remove last three additional characters
+    owned = _joined.str().substr(0, _joined.str().size() - 3);
+}
+
+void helpers::TemplateArg::write(raw_ostream &out) const {
+    switch (kind) {
+        case StringArg: out << str; break;
+        case OwnedArg: out << owned; break;
+        case UnsignedArg: out << unsigned_num; break;
+        case SignedArg: out << signed_num; break;
+    }
+}
+
+helpers::TemplateString::TemplateString(
+    const std::string &_text, std::initializer_list<const char *> _keys)
+    : num_keys(_keys.size()) {
+    segments.push_back(Segment{_text, -1});
+
+    // Split the literal parts by each key in turn, this is what the
+    // sequence of helperReplace calls used to do on the whole string
+    int32_t _key_id = 0;
+    for (auto _key : _keys) {
+        assert(_key[0] == '$' && "Replace string should start with $!");
+        std::string _from(_key);
+        std::vector<Segment> _split;
+        for (auto &_seg : segments) {
+            if (_seg.key != -1) {
+                _split.push_back(_seg);
+                continue;
+            }
+            size_t _start = 0;
+            while (true) {
+                size_t _pos = _seg.text.find(_from, _start);
+                if (_pos == std::string::npos) break;
+                _split.push_back(
+                    Segment{_seg.text.substr(_start, _pos - _start), -1});
+                _split.push_back(Segment{"", _key_id});
+                _start = _pos + _from.length();
+            }
+            _split.push_back(Segment{_seg.text.substr(_start), -1});
+        }
+        segments = std::move(_split);
+        _key_id++;
+    }
+
+    // Drop the empty literals
+    segments.erase(std::remove_if(segments.begin(), segments.end(),
+                                  [](const Segment &_seg) {
+                                      return _seg.key == -1 &&
+                                             _seg.text.empty();
+                                  }),
+                   segments.end());
+}
+
+void helpers::TemplateString::render(
+    raw_ostream &out, std::initializer_list<TemplateArg> _args) const {
+    assert(_args.size() == num_keys && "Wrong number of template arguments!");
+    for (auto &_seg : segments) {
+        if (_seg.key == -1)
+            out << _seg.text;
+        else
+            (_args.begin() + _seg.key)->write(out);
+    }
+}
+
+std::string helpers::TemplateString::render(
+    std::initializer_list<TemplateArg> _args) const {
+    std::string _text;
+    raw_string_ostream _out(_text);
+    render(_out, _args);
+    return _out.str();
+}
+
+bool helpers::writeIfChanged(const std::string &path, llvm::StringRef contents) {
+    auto _old = MemoryBuffer::getFile(path);
+    if (_old && (*_old)->getBuffer() == contents) return false;
+
+    std::error_code errc;
+    raw_fd_ostream _out(path, errc, sys::fs::F_None);
+    if (errc) {
+        report_fatal_error("Unable to write '" + path + "': " + errc.message());
+    }
+    _out << contents;
+    return true;
+}
+
 namespace helpers {
 // LabelUID Helper Class
 char CallInstSpliter::ID = 0;
@@ -47,101 +47,107 @@ getARGID(Argument* ARG) {
   return stoi(S->getString().str());
 }
 
-/// This function recursively search for the operand nodes, and if the operands are in the
-/// same basicblock and are not PHI, it adds them under node_operands map
+/// Operand ancestry of a PHI node, for every incoming instruction from another
+/// basicblock the UIDs of its operands which are in that same basicblock, and
+/// the IDs of the incoming function arguments
 static void
-visitPhiOperands(llvm::Instruction* ins,
-                 std::set<uint32_t>& node_operands,
-                 std::set<BasicBlock*>& visited_bb) {
-  auto find_bb = visited_bb.find(ins->getParent());
-  if (find_bb != visited_bb.end())
-    return;
-  // If intruction is PHI find all the child's dependencies
-  for (auto& op : ins->operands()) {
+visitPhiOperands(llvm::PHINode* phi_ins, std::vector<uint32_t>& parent_ids) {
+  for (auto& op : phi_ins->operands()) {
     if (auto op_ins = dyn_cast<llvm::Instruction>(op.get())) {
-      if (op_ins->getParent() == ins->getParent()) {
-        node_operands.insert(getUID(op_ins));
+      if (op_ins->getParent() == phi_ins->getParent())
+        continue;
+      for (auto& phi_op : op_ins->operands()) {
+        auto phi_op_ins = dyn_cast<llvm::Instruction>(phi_op.get());
+        if (phi_op_ins && phi_op_ins->getParent() == op_ins->getParent())
+          parent_ids.push_back(getUID(phi_op_ins));
       }
+    } else if (auto arg = dyn_cast<Argument>(op.get())) {
+      DEBUG(arg->print(dbgs()));
+      parent_ids.push_back(getARGID(arg));
     } else {
-      // TODO: Enable this part after adding UIDs to
-      // function arguments
+      // The value is constant
       continue;
     }
   }
 }
 
+/// Returns the id of the set in operand_sets, ids is sorted and made unique
+uint32_t
+DebugInfo::internOperandSet(std::vector<uint32_t>& ids) {
+  std::sort(ids.begin(), ids.end());
+  ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
 
-/// This function recursively search for the operand nodes, and if the operands are in the
-/// same basicblock and are not PHI, it adds them under node_operands map
-static void
-visitOperands(llvm::Instruction* ins,
-              std::set<uint32_t>& node_operands,
-              std::set<BasicBlock*>& visited_bb) {
-  auto find_bb = visited_bb.find(ins->getParent());
-  if (find_bb != visited_bb.end())
-    return;
-  // If intruction is PHI find all the child's dependencies
-  if (auto phi_ins = dyn_cast<llvm::PHINode>(ins)) {
-    for (auto& op : phi_ins->operands()) {
-      if (auto op_ins = dyn_cast<llvm::Instruction>(op.get())) {
-        visited_bb.insert(ins->getParent());
-        visitPhiOperands(op_ins, node_operands, visited_bb);
-      } else if (auto arg = dyn_cast<Argument>(op.get())) {
-        arg->print(outs());
-        node_operands.insert(getARGID(arg));
-      } else {
-        // The value is constant
-        continue;
+  auto find_set = this->operand_set_ids.find(ids);
+  if (find_set != this->operand_set_ids.end())
+    return find_set->second;
+
+  uint32_t set_id = this->operand_sets.size();
+  this->operand_sets.push_back(ids);
+  this->operand_set_ids.emplace(ids, set_id);
+  return set_id;
+}
+
+/// Operand ancestry of every instruction of the basicblock. The ancestry of an
+/// instruction is the UIDs of its operands in the same basicblock together
+/// with the ancestry of the first of them, PHI nodes stop the chain. Operands
+/// in the same basicblock come before their users, so a single walk in the
+/// basicblock order sees the ancestry of the operands first.
+void
+DebugInfo::visitBasicBlock(BasicBlock& bb) {
+  DenseMap<const Instruction*, uint32_t> block_sets;
+  std::vector<uint32_t> parent_ids;
+
+  for (auto& ins : bb) {
+    parent_ids.clear();
+    if (auto phi_ins = dyn_cast<llvm::PHINode>(&ins)) {
+      visitPhiOperands(phi_ins, parent_ids);
+    } else {
+      llvm::Instruction* first_op = nullptr;
+      for (auto& op : ins.operands()) {
+        auto op_ins = dyn_cast<llvm::Instruction>(op.get());
+        if (!op_ins || op_ins->getParent() != &bb)
+          continue;
+        parent_ids.push_back(getUID(op_ins));
+        if (!first_op)
+          first_op = op_ins;
       }
-    }
-  } else {
-    for (auto& op : ins->operands()) {
-      if (auto op_ins = dyn_cast<llvm::Instruction>(op.get())) {
-        if (op_ins->getParent() == ins->getParent()) {
-          node_operands.insert(getUID(op_ins));
-          visitOperands(op_ins, node_operands, visited_bb);
-          visited_bb.insert(ins->getParent());
-        }
-      } else {
-        // TODO: Enable this part after adding UIDs to
-        // function arguments
-        continue;
+      // Only unreachable code can use a later instruction of the basicblock
+      auto find_first = block_sets.find(first_op);
+      if (find_first != block_sets.end()) {
+        auto& first_ids = this->operand_sets[find_first->second];
+        parent_ids.insert(parent_ids.end(), first_ids.begin(), first_ids.end());
       }
     }
+
+    auto set_id = internOperandSet(parent_ids);
+    block_sets[&ins] = set_id;
+
+    if (int(this->node_id) != -1 && getUID(&ins) != uint32_t(this->node_id))
+      continue;
+    this->node_operands[&ins] = set_id;
+    this->node_order.push_back(&ins);
   }
 }
 
+ArrayRef<uint32_t>
+DebugInfo::getNodeOperands(const Instruction* ins) const {
+  auto find_ins = this->node_operands.find(ins);
+  if (find_ins == this->node_operands.end())
+    return {};
+  return this->operand_sets[find_ins->second];
+}
+
 // For an analysis pass, runOnModule should perform the actual analysis and
 // compute the results. The actual output, however, is produced separately.
 bool
 DebugInfo::runOnModule(Module& m) {
   for (auto& f : m) {
     // If function is not target, continue
-    if (f.getName() != this->function_name)
+    if (this->function_names.count(f.getName().str()) == 0)
       continue;
 
-    for (auto& bb : f) {
-      // for( auto it = llvm::pred_begin(&bb), et = llvm::pred_end(&bb);
-      // it != et; it++){ BasicBlock *test = *it; outs() << "BasicBlock:
-      // \n"; test->print(outs());
-      //}
-      for (auto& ins : bb) {
-        // getting instruction's UID
-        auto inst_uid = getUID(&ins);
-        std::set<BasicBlock*> visited_bb;
-        if (int(this->node_id) != -1) {
-          if (inst_uid == this->node_id) {
-            std::set<uint32_t> parent_ids;
-            visitOperands(&ins, parent_ids, visited_bb);
-            this->node_operands[&ins] = parent_ids;
-          }
-        } else {
-          std::set<uint32_t> parent_ids;
-          visitOperands(&ins, parent_ids, visited_bb);
-          this->node_operands[&ins] = parent_ids;
-        }
-      }
-    }
+    for (auto& bb : f)
+      visitBasicBlock(bb);
   }
 
   return false;
@@ -153,8 +159,8 @@ DebugInfo::doFinalization(llvm::Module& M) {
   if (this->print_values) {
     outs() << "Print debug nodes:\n";
     outs() << "node[ " << this->node_id << " ]: ";
-    for (auto op : this->node_operands) {
-      for (auto ids : op.second) {
+    for (auto ins : this->node_order) {
+      for (auto ids : getNodeOperands(ins)) {
         outs() << ids << ", ";
       }
     }
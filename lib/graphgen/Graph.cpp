@@ -6,7 +6,10 @@
 
 #include "Common.h"
 #include "Dandelion/Graph.h"
+#include "Dandelion/GraphPasses.h"
 #include "Dandelion/Node.h"
+#include "Dandelion/PassManager.h"
+#include "Dandelion/Stats.h"
 
 #include <iostream>
 #include <regex>
@@ -101,40 +104,55 @@ getNodeList(Graph* _graph) {
 void
 Graph::printGraph(PrintType _pt, std::string json_path) {
   switch (_pt) {
-    case PrintType::Scala:
+    case PrintType::Scala: {
       DEBUG(dbgs() << "Print Graph information!\n");
 
+      // Each print phase is recorded as a stage of the generator statistics
+      auto& _name = this->graph_info.Name;
+      auto _stage = [this, &_name](const char* _phase_name,
+                                   void (Graph::*_phase)(PrintType)) {
+        stats::runStage(
+            _name, _phase_name, [this, _phase] { (this->*_phase)(PrintType::Scala); });
+      };
+
       // TODO: pass the corect config path
-      printScalaHeader(json_path);
-
-      doInitialization();
-
-      printScalaFunctionHeader();
-      printCallIO(PrintType::Scala);
-      printMemIO(PrintType::Scala);
-      printSharedModules(PrintType::Scala);
-      printScalaInputSpliter();
-      printLoopHeader(PrintType::Scala);
-      printBasicBlocks(PrintType::Scala);
-      printInstructions(PrintType::Scala);
-      printConstants(PrintType::Scala);
-      printBasickBlockInstructionPredicateEdges(PrintType::Scala);
-      printBasickBlockLoopPredicateEdges(PrintType::Scala);
-      printParallelConnections(PrintType::Scala);
-      printLoopBranchEdges(PrintType::Scala);
-      printLoopEndingDependencies(PrintType::Scala);
-      printLoopDataDependencies(PrintType::Scala);
-      printBasickBLockInstructionEdges(PrintType::Scala);
-      printPhiNodesConnections(PrintType::Scala);
-      printMemInsConnections(PrintType::Scala);
-      printSharedConnections(PrintType::Scala);
-      printDatadependencies(PrintType::Scala);
-      printControlDependencies(PrintType::Scala);
-      printOutPort(PrintType::Scala);
-      printClosingclass(PrintType::Scala);
+      stats::runStage(_name, "printScalaHeader", [&] { printScalaHeader(json_path); });
+
+      stats::runStage(_name, "doInitialization", [this] { doInitialization(); });
+
+      stats::runStage(
+          _name, "printScalaFunctionHeader", [this] { printScalaFunctionHeader(); });
+      _stage("printCallIO", &Graph::printCallIO);
+      _stage("printMemIO", &Graph::printMemIO);
+      _stage("printSharedModules", &Graph::printSharedModules);
+      stats::runStage(
+          _name, "printScalaInputSpliter", [this] { printScalaInputSpliter(); });
+      _stage("printLoopHeader", &Graph::printLoopHeader);
+      _stage("printBasicBlocks", &Graph::printBasicBlocks);
+      _stage("printInstructions", &Graph::printInstructions);
+      _stage("printConstants", &Graph::printConstants);
+      _stage("printBasickBlockInstructionPredicateEdges",
+             &Graph::printBasickBlockInstructionPredicateEdges);
+      _stage("printBasickBlockLoopPredicateEdges",
+             &Graph::printBasickBlockLoopPredicateEdges);
+      _stage("printParallelConnections", &Graph::printParallelConnections);
+      _stage("printLoopBranchEdges", &Graph::printLoopBranchEdges);
+      _stage("printLoopEndingDependencies", &Graph::printLoopEndingDependencies);
+      _stage("printLoopDataDependencies", &Graph::printLoopDataDependencies);
+      _stage("printBasickBLockInstructionEdges",
+             &Graph::printBasickBLockInstructionEdges);
+      _stage("printPhiNodesConnections", &Graph::printPhiNodesConnections);
+      _stage("printMemInsConnections", &Graph::printMemInsConnections);
+      _stage("printSharedConnections", &Graph::printSharedConnections);
+      _stage("printDatadependencies", &Graph::printDatadependencies);
+      _stage("printControlDependencies", &Graph::printControlDependencies);
+      _stage("printOutPort", &Graph::printOutPort);
+      _stage("printClosingclass", &Graph::printClosingclass);
+      _stage("printFusedModules", &Graph::printFusedModules);
       // printScalaMainClass();
 
       break;
+    }
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
@@ -192,23 +210,20 @@ Graph::printParallelConnections(PrintType _pt) {
       auto _detach_node   = findParallelNode<DetachNode>(this);
       auto _reattach_node = findParallelNode<ReattachNode>(this);
 
-      auto printConnection = [&_sync_node](Node* _node) {
-        std::stringstream _output;
-        _output << "  "
-                << _sync_node->printInputEnable(
-                       PrintType::Scala,
-                       _sync_node->returnControlInputPortIndex(_node).getID())
-                << " <> "
-                << _node->printOutputEnable(
-                       PrintType::Scala,
-                       _node->returnControlOutputPortIndex(_sync_node).getID())
-                << "\n\n";
-
-        return _output;
+      auto printConnection = [this, &_sync_node](Node* _node) {
+        this->outCode << "  "
+                      << _sync_node->printInputEnable(
+                             PrintType::Scala,
+                             _sync_node->returnControlInputPortIndex(_node).getID())
+                      << " <> "
+                      << _node->printOutputEnable(
+                             PrintType::Scala,
+                             _node->returnControlOutputPortIndex(_sync_node).getID())
+                      << "\n\n";
       };
 
-      this->outCode << printConnection(_detach_node).str();
-      this->outCode << printConnection(_reattach_node).str();
+      printConnection(_detach_node);
+      printConnection(_reattach_node);
 
       break;
     }
@@ -250,7 +265,7 @@ Graph::printInstructions(PrintType _pt) {
             && call_ins == nullptr)
           continue;
         this->outCode << "  //";
-        ins_node->getInstruction()->print(this->outCode);
+        ins_node->printInstruction(this->outCode);
         this->outCode << "\n";
         if (auto call_node = dyn_cast<CallNode>(&*ins_node)) {
           this->outCode << call_node->getCallOut()->printDefinition(PrintType::Scala);
@@ -283,7 +298,10 @@ Graph::printConstants(PrintType _pt) {
 
       for (auto& const_node : this->const_fp_list) {
         this->outCode << "  //";
-        const_node->getConstantParent()->print(this->outCode);
+        if (const_node->getConstantParent())
+          const_node->getConstantParent()->print(this->outCode);
+        else
+          this->outCode << "NullPtr";
         this->outCode << "\n";
         this->outCode << const_node->printDefinition(PrintType::Scala);
       }
@@ -306,6 +324,8 @@ Graph::printSharedModules(PrintType _pt) {
         outCode << memory_unit->printDefinition(PrintType::Scala);
       else
         outCode << memory_unit->printUninitilizedUnit(PrintType::Scala);
+      for (auto _bank : memory_banks)
+        outCode << _bank->printDefinition(PrintType::Scala);
 
       // Printing local memories
       for (auto& mem : scratchpad_memories) {
@@ -336,7 +356,7 @@ Graph::printBasickBlockInstructionPredicateEdges(PrintType _pt) {
             continue;
           }
           auto _input_node   = dyn_cast<Node>(_enable_iterator.first);
-          auto _output_index = _input_node->returnControlOutputPortIndex(_s_node.get());
+          auto _output_index = _input_node->returnControlOutputPortIndex(_s_node);
 
           this->outCode << "  "
                         << _s_node->printInputEnable(PrintType::Scala, _enable_iterator)
@@ -370,7 +390,7 @@ Graph::printBasickBlockLoopPredicateEdges(PrintType _pt) {
         }
         for (auto _l : unique_loop_nodes) {
           auto _list_input_enable  = _s_node->findControlInputNodeList(_l);
-          auto _list_output_enable = _l->findControlOutputNodeList(_s_node.get());
+          auto _list_output_enable = _l->findControlOutputNodeList(_s_node);
 
           assert(_list_input_enable.size() == _list_output_enable.size()
                  && "Size of the input and output enable signals should "
@@ -403,7 +423,7 @@ Graph::printBasickBlockLoopPredicateEdges(PrintType _pt) {
         // dyn_cast<Node>(_enable_iterator.first);
         // auto _output_index =
         //_input_node->returnControlOutputPortIndex(
-        //_s_node.get());
+        //_s_node);
 
         // this->outCode
         //<< "  "
@@ -465,7 +485,7 @@ Graph::printBasickBLockInstructionEdges(PrintType _pt) {
             auto ff_out = std::find_if(
                 _call_node->getCallOut()->inputControl_begin(),
                 _call_node->getCallOut()->inputControl_end(),
-                [&_s_node](auto& arg) -> bool { return _s_node.get() == &*arg.first; });
+                [&_s_node](auto& arg) -> bool { return _s_node == &*arg.first; });
 
             if (ff_out == _call_node->getCallOut()->inputControl_end())
               assert(!"Couldn't find the control edge\n");
@@ -473,7 +493,7 @@ Graph::printBasickBLockInstructionEdges(PrintType _pt) {
             auto ff_in = std::find_if(
                 _call_node->getCallIn()->inputControl_begin(),
                 _call_node->getCallIn()->inputControl_end(),
-                [&_s_node](auto& arg) -> bool { return _s_node.get() == &*arg.first; });
+                [&_s_node](auto& arg) -> bool { return _s_node == &*arg.first; });
 
             if (ff_in == _call_node->getCallIn()->inputControl_end())
               assert(!"Couldn't find the control edge\n");
@@ -501,7 +521,7 @@ Graph::printBasickBLockInstructionEdges(PrintType _pt) {
             auto ff = std::find_if(
                 _output_node->inputControl_begin(),
                 _output_node->inputControl_end(),
-                [&_s_node](auto& arg) -> bool { return _s_node.get() == &*arg.first; });
+                [&_s_node](auto& arg) -> bool { return _s_node == &*arg.first; });
 
             if (ff == _output_node->inputControl_end())
               assert(!"Couldn't find the control edge\n");
@@ -534,8 +554,8 @@ Graph::printPhiNodesConnections(PrintType _pt) {
       this->outCode << helperScalaPrintHeader("Connecting phi nodes");
       for (auto& _s_node : super_node_list) {
         // Adding Phi node inputs
-        for (auto _phi_it = _s_node.get()->phi_begin();
-             _phi_it != _s_node.get()->phi_end();
+        for (auto _phi_it = _s_node->phi_begin();
+             _phi_it != _s_node->phi_end();
              _phi_it++) {
           auto _phi_ins = dyn_cast<PhiSelectNode>(*_phi_it);
 
@@ -594,6 +614,19 @@ Graph::printDatadependencies(PrintType _pt) {
   }
 }
 
+/**
+ * Memory ordering edge between two memory operations, the destination waits on
+ * one of its predecessor ports for the source
+ */
+static void
+printMemoryOrderEdge(raw_ostream& _out, Node* _src, Node* _dst) {
+  _out << _dst->printInputEnable(PrintType::Scala,
+                                 _dst->returnControlInputPortIndex(_src).getID())
+       << " <> "
+       << _src->printOutputEnable(PrintType::Scala,
+                                  _src->returnControlOutputPortIndex(_dst).getID());
+}
+
 void
 Graph::printControlDependencies(PrintType _pt) {
   switch (_pt) {
@@ -626,11 +659,25 @@ Graph::printControlDependencies(PrintType _pt) {
                        PrintType::Scala,
                        _st_node->findControlOutputNode(_cn_node.first)->second.getID())
                 << "\n\n";
+          } else if (isa<LoadNode>(_cn_node.first) || isa<StoreNode>(_cn_node.first)) {
+            this->outCode << "  ";
+            printMemoryOrderEdge(this->outCode, _st_node, _cn_node.first);
+            this->outCode << "\n\n";
           } else
             assert(!"Uknown ground node!\n");
         }
       }
 
+      // Loads are ordered after their memory predecessors, the ones which alias a
+      // store of another block also hold their block branch
+      for (auto _ld_node : getNodeList<LoadNode>(this)) {
+        for (auto _cn_node : _ld_node->output_control_range()) {
+          this->outCode << "  ";
+          printMemoryOrderEdge(this->outCode, _ld_node, _cn_node.first);
+          this->outCode << "\n\n";
+        }
+      }
+
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
@@ -679,49 +726,50 @@ Graph::printMemInsConnections(PrintType _pt) {
     case PrintType::Scala: {
       DEBUG(dbgs() << "\t Memory to instructions dependencies\n");
       this->outCode << helperScalaPrintHeader("Connecting memory connections");
-      auto cache = this->getMemoryUnit();
-      for (auto mem : cache->read_req_range()) {
-        this->outCode << "  "
-                      << cache->printMemReadInput(
-                             PrintType::Scala,
-                             cache->returnMemoryReadInputPortIndex(mem.first).getID())
-                      << " <> "
-                      << mem.first->printMemReadOutput(
-                             PrintType::Scala,
-                             mem.first->returnMemoryReadOutputPortIndex(cache).getID())
-                      << "\n";
+      for (auto cache : this->getMemoryUnits()) {
+        for (auto mem : cache->read_req_range()) {
+          this->outCode << "  "
+                        << cache->printMemReadInput(
+                               PrintType::Scala,
+                               cache->returnMemoryReadInputPortIndex(mem.first).getID())
+                        << " <> "
+                        << mem.first->printMemReadOutput(
+                               PrintType::Scala,
+                               mem.first->returnMemoryReadOutputPortIndex(cache).getID())
+                        << "\n";
 
-        this->outCode << "  "
-                      << mem.first->printMemReadInput(
-                             PrintType::Scala,
-                             mem.first->returnMemoryReadInputPortIndex(cache).getID())
-                      << " <> "
-                      << cache->printMemReadOutput(
-                             PrintType::Scala,
-                             cache->returnMemoryReadOutputPortIndex(mem.first).getID())
-                      << "\n";
-      }
+          this->outCode << "  "
+                        << mem.first->printMemReadInput(
+                               PrintType::Scala,
+                               mem.first->returnMemoryReadInputPortIndex(cache).getID())
+                        << " <> "
+                        << cache->printMemReadOutput(
+                               PrintType::Scala,
+                               cache->returnMemoryReadOutputPortIndex(mem.first).getID())
+                        << "\n";
+        }
 
-      for (auto mem : cache->write_req_range()) {
-        this->outCode << "  "
-                      << cache->printMemWriteInput(
-                             PrintType::Scala,
-                             cache->returnMemoryWriteInputPortIndex(mem.first).getID())
-                      << " <> "
-                      << mem.first->printMemWriteOutput(
-                             PrintType::Scala,
-                             mem.first->returnMemoryWriteOutputPortIndex(cache).getID())
-                      << "\n";
+        for (auto mem : cache->write_req_range()) {
+          this->outCode << "  "
+                        << cache->printMemWriteInput(
+                               PrintType::Scala,
+                               cache->returnMemoryWriteInputPortIndex(mem.first).getID())
+                        << " <> "
+                        << mem.first->printMemWriteOutput(
+                               PrintType::Scala,
+                               mem.first->returnMemoryWriteOutputPortIndex(cache).getID())
+                        << "\n";
 
-        this->outCode << "  "
-                      << mem.first->printMemWriteInput(
-                             PrintType::Scala,
-                             mem.first->returnMemoryWriteInputPortIndex(cache).getID())
-                      << " <> "
-                      << cache->printMemWriteOutput(
-                             PrintType::Scala,
-                             cache->returnMemoryWriteOutputPortIndex(mem.first).getID())
-                      << "\n\n";
+          this->outCode << "  "
+                        << mem.first->printMemWriteInput(
+                               PrintType::Scala,
+                               mem.first->returnMemoryWriteInputPortIndex(cache).getID())
+                        << " <> "
+                        << cache->printMemWriteOutput(
+                               PrintType::Scala,
+                               cache->returnMemoryWriteOutputPortIndex(mem.first).getID())
+                        << "\n\n";
+        }
       }
 
       // Print local buffers
@@ -736,14 +784,14 @@ Graph::printMemInsConnections(PrintType _pt) {
               << " <> "
               << mem.first->printMemReadOutput(
                      PrintType::Scala,
-                     mem.first->returnMemoryReadOutputPortIndex(scratchpad.get()).getID())
+                     mem.first->returnMemoryReadOutputPortIndex(scratchpad).getID())
               << "\n";
 
           this->outCode
               << "  "
               << mem.first->printMemReadInput(
                      PrintType::Scala,
-                     mem.first->returnMemoryReadInputPortIndex(scratchpad.get()).getID())
+                     mem.first->returnMemoryReadInputPortIndex(scratchpad).getID())
               << " <> "
               << scratchpad->printMemReadOutput(
                      PrintType::Scala,
@@ -761,7 +809,7 @@ Graph::printMemInsConnections(PrintType _pt) {
                 << " <> "
                 << mem.first->printMemWriteOutput(
                        PrintType::Scala,
-                       mem.first->returnMemoryWriteOutputPortIndex(scratchpad.get())
+                       mem.first->returnMemoryWriteOutputPortIndex(scratchpad)
                            .getID())
                 << "\n";
 
@@ -769,7 +817,7 @@ Graph::printMemInsConnections(PrintType _pt) {
                 << "  "
                 << mem.first->printMemWriteInput(
                        PrintType::Scala,
-                       mem.first->returnMemoryWriteInputPortIndex(scratchpad.get())
+                       mem.first->returnMemoryWriteInputPortIndex(scratchpad)
                            .getID())
                 << " <> "
                 << scratchpad->printMemWriteOutput(
@@ -803,6 +851,23 @@ Graph::printClosingclass(PrintType _pt) {
   }
 }
 
+/**
+ * Print the modules of the fused compute nodes after the graph class
+ */
+void
+Graph::printFusedModules(PrintType _pt) {
+  switch (_pt) {
+    case PrintType::Scala:
+      for (auto& _ins : this->instructions()) {
+        if (auto _fused = dyn_cast<FusedComputeNode>(_ins))
+          this->outCode << _fused->printModule(PrintType::Scala);
+      }
+      break;
+    case PrintType::Dot: assert(!"Dot file format is not supported!");
+    default: assert(!"Uknown print type!");
+  }
+}
+
 /**
  * Print the main class of chisel module
  */
@@ -937,6 +1002,10 @@ Graph::printMemIO(PrintType _pt) {
         }
         this->outCode << _final_command;
       }
+      if (!alloca_node_list.size() && memory_banks.size())
+        this->outCode << "\n  /**\n    * Memory Interfaces\n    */\n";
+      for (auto _bank : memory_banks)
+        this->outCode << _bank->printMemIO(PrintType::Scala);
       break;
     }
     default: assert(!"We don't support the other types right now");
@@ -990,13 +1059,9 @@ Graph::insertSuperNode(BasicBlock& BB) {
   fix_name = std::regex_replace(fix_name, std::regex("^\\."), "");
   auto uid = getUID(&BB);
   super_node_list.push_back(
-      std::make_unique<SuperNode>(NodeInfo(uid, "bb_" + fix_name + to_string(uid)), &BB));
-  auto ff = std::find_if(
-      super_node_list.begin(), super_node_list.end(), [&BB](auto& arg) -> bool {
-        return arg.get()->getBasicBlock() == &BB;
-      });
+      arena.create<SuperNode>(NodeInfo(uid, "bb_" + fix_name + to_string(uid)), &BB));
 
-  return ff->get();
+  return super_node_list.back();
 }
 
 /**
@@ -1005,15 +1070,13 @@ Graph::insertSuperNode(BasicBlock& BB) {
 InstructionNode*
 Graph::insertBinaryOperatorNode(BinaryOperator& I) {
   auto uid = getUID(&I);
-  inst_list.push_back(std::make_unique<BinaryOperatorNode>(
+  inst_list.push_back(arena.create<BinaryOperatorNode>(
       NodeInfo(uid, "binaryOp_" + I.getName().str() + to_string(uid)), &I));
 
-  auto ff = std::find_if(inst_list.begin(), inst_list.end(), [&I](auto& arg) -> bool {
-    return arg.get()->getInstruction() == &I;
-  });
-  ff->get()->printDefinition(PrintType::Scala);
+  auto _node = inst_list.back();
+  _node->printDefinition(PrintType::Scala);
 
-  return ff->get();
+  return _node;
 }
 
 /**
@@ -1022,15 +1085,13 @@ Graph::insertBinaryOperatorNode(BinaryOperator& I) {
 InstructionNode*
 Graph::insertFaddNode(BinaryOperator& I) {
   auto uid = getUID(&I);
-  inst_list.push_back(std::make_unique<FaddOperatorNode>(
+  inst_list.push_back(arena.create<FaddOperatorNode>(
       NodeInfo(uid, "FP_" + I.getName().str() + to_string(uid)), &I));
 
-  auto ff = std::find_if(inst_list.begin(), inst_list.end(), [&I](auto& arg) -> bool {
-    return arg.get()->getInstruction() == &I;
-  });
-  ff->get()->printDefinition(PrintType::Scala);
+  auto _node = inst_list.back();
+  _node->printDefinition(PrintType::Scala);
 
-  return ff->get();
+  return _node;
 }
 
 /**
@@ -1039,15 +1100,13 @@ Graph::insertFaddNode(BinaryOperator& I) {
 InstructionNode*
 Graph::insertFsubNode(BinaryOperator& I) {
   auto uid = getUID(&I);
-  inst_list.push_back(std::make_unique<FaddOperatorNode>(
+  inst_list.push_back(arena.create<FaddOperatorNode>(
       NodeInfo(uid, "FP_" + I.getName().str() + to_string(uid)), &I));
 
-  auto ff = std::find_if(inst_list.begin(), inst_list.end(), [&I](auto& arg) -> bool {
-    return arg.get()->getInstruction() == &I;
-  });
-  ff->get()->printDefinition(PrintType::Scala);
+  auto _node = inst_list.back();
+  _node->printDefinition(PrintType::Scala);
 
-  return ff->get();
+  return _node;
 }
 
 /**
@@ -1056,15 +1115,13 @@ Graph::insertFsubNode(BinaryOperator& I) {
 InstructionNode*
 Graph::insertFmulNode(BinaryOperator& I) {
   auto uid = getUID(&I);
-  inst_list.push_back(std::make_unique<FaddOperatorNode>(
+  inst_list.push_back(arena.create<FaddOperatorNode>(
       NodeInfo(uid, "FP_" + I.getName().str() + to_string(uid)), &I));
 
-  auto ff = std::find_if(inst_list.begin(), inst_list.end(), [&I](auto& arg) -> bool {
-    return arg.get()->getInstruction() == &I;
-  });
-  ff->get()->printDefinition(PrintType::Scala);
+  auto _node = inst_list.back();
+  _node->printDefinition(PrintType::Scala);
 
-  return ff->get();
+  return _node;
 }
 
 /**
@@ -1073,15 +1130,13 @@ Graph::insertFmulNode(BinaryOperator& I) {
 InstructionNode*
 Graph::insertFdiveNode(BinaryOperator& I) {
   auto uid = getUID(&I);
-  inst_list.push_back(std::make_unique<FdiveOperatorNode>(
+  inst_list.push_back(arena.create<FdiveOperatorNode>(
       NodeInfo(uid, "FP_" + I.getName().str() + to_string(uid)), &I));
 
-  auto ff = std::find_if(inst_list.begin(), inst_list.end(), [&I](auto& arg) -> bool {
-    return arg.get()->getInstruction() == &I;
-  });
-  ff->get()->printDefinition(PrintType::Scala);
+  auto _node = inst_list.back();
+  _node->printDefinition(PrintType::Scala);
 
-  return ff->get();
+  return _node;
 }
 
 /**
@@ -1090,15 +1145,13 @@ Graph::insertFdiveNode(BinaryOperator& I) {
 InstructionNode*
 Graph::insertFcmpNode(FCmpInst& I) {
   auto uid = getUID(&I);
-  inst_list.push_back(std::make_unique<FcmpNode>(
+  inst_list.push_back(arena.create<FcmpNode>(
       NodeInfo(uid, "FPCMP_" + I.getName().str() + to_string(uid)), &I));
 
-  auto ff = std::find_if(inst_list.begin(), inst_list.end(), [&I](auto& arg) -> bool {
-    return arg.get()->getInstruction() == &I;
-  });
-  ff->get()->printDefinition(PrintType::Scala);
+  auto _node = inst_list.back();
+  _node->printDefinition(PrintType::Scala);
 
-  return ff->get();
+  return _node;
 }
 
 /**
@@ -1106,17 +1159,15 @@ Graph::insertFcmpNode(FCmpInst& I) {
  */
 InstructionNode*
 Graph::insertDetachNode(DetachInst& I) {
-  inst_list.push_back(std::make_unique<DetachNode>(
+  inst_list.push_back(arena.create<DetachNode>(
       NodeInfo(inst_list.size(),
                "detach_" + I.getName().str() + std::to_string(inst_list.size())),
       &I));
 
-  auto ff = std::find_if(inst_list.begin(), inst_list.end(), [&I](auto& arg) -> bool {
-    return arg.get()->getInstruction() == &I;
-  });
-  ff->get()->printDefinition(PrintType::Scala);
+  auto _node = inst_list.back();
+  _node->printDefinition(PrintType::Scala);
 
-  return ff->get();
+  return _node;
 }
 
 /**
@@ -1124,17 +1175,15 @@ Graph::insertDetachNode(DetachInst& I) {
  */
 InstructionNode*
 Graph::insertReattachNode(ReattachInst& I) {
-  inst_list.push_back(std::make_unique<ReattachNode>(
+  inst_list.push_back(arena.create<ReattachNode>(
       NodeInfo(inst_list.size(),
                "reattach_" + I.getName().str() + std::to_string(inst_list.size())),
       &I));
 
-  auto ff = std::find_if(inst_list.begin(), inst_list.end(), [&I](auto& arg) -> bool {
-    return arg.get()->getInstruction() == &I;
-  });
-  ff->get()->printDefinition(PrintType::Scala);
+  auto _node = inst_list.back();
+  _node->printDefinition(PrintType::Scala);
 
-  return ff->get();
+  return _node;
 }
 
 /**
@@ -1142,17 +1191,15 @@ Graph::insertReattachNode(ReattachInst& I) {
  */
 InstructionNode*
 Graph::insertSyncNode(SyncInst& I) {
-  inst_list.push_back(std::make_unique<SyncNode>(
+  inst_list.push_back(arena.create<SyncNode>(
       NodeInfo(inst_list.size(),
                "sync_" + I.getName().str() + std::to_string(inst_list.size())),
       &I));
 
-  auto ff = std::find_if(inst_list.begin(), inst_list.end(), [&I](auto& arg) -> bool {
-    return arg.get()->getInstruction() == &I;
-  });
-  ff->get()->printDefinition(PrintType::Scala);
+  auto _node = inst_list.back();
+  _node->printDefinition(PrintType::Scala);
 
-  return ff->get();
+  return _node;
 }
 
 /**
@@ -1161,13 +1208,10 @@ Graph::insertSyncNode(SyncInst& I) {
 InstructionNode*
 Graph::insertIcmpOperatorNode(ICmpInst& I) {
   auto uid = getUID(&I);
-  inst_list.push_back(std::make_unique<IcmpNode>(
+  inst_list.push_back(arena.create<IcmpNode>(
       NodeInfo(uid, "icmp_" + I.getName().str() + to_string(uid)), &I));
 
-  auto ff = std::find_if(inst_list.begin(), inst_list.end(), [&I](auto& arg) -> bool {
-    return arg.get()->getInstruction() == &I;
-  });
-  return ff->get();
+  return inst_list.back();
 }
 
 /**
@@ -1176,13 +1220,10 @@ Graph::insertIcmpOperatorNode(ICmpInst& I) {
 InstructionNode*
 Graph::insertBranchNode(BranchInst& I) {
   auto uid = getUID(&I);
-  inst_list.push_back(std::make_unique<BranchNode>(
+  inst_list.push_back(arena.create<BranchNode>(
       NodeInfo(uid, "br_" + I.getName().str() + std::to_string(uid)), &I));
 
-  auto ff = std::find_if(inst_list.begin(), inst_list.end(), [&I](auto& arg) -> bool {
-    return arg.get()->getInstruction() == &I;
-  });
-  return ff->get();
+  return inst_list.back();
 }
 
 /**
@@ -1212,28 +1253,27 @@ Graph::insertPhiNode(PHINode& I) {
   auto uid = getUID(&I);
 
   if (I.getType()->isPointerTy()) {
-    inst_list.push_back(std::make_unique<PhiSelectNode>(
+    inst_list.push_back(arena.create<PhiSelectNode>(
         NodeInfo(uid, "phi" + I.getName().str() + to_string(uid)),
         Node::DataType::PointerType,
         reverse,
         &I));
   } else if (I.getType()->isIntegerTy()) {
-    inst_list.push_back(std::make_unique<PhiSelectNode>(
+    inst_list.push_back(arena.create<PhiSelectNode>(
         NodeInfo(uid, "phi" + I.getName().str() + to_string(uid)),
         Node::DataType::IntegerType,
         reverse,
         &I));
   } else if (I.getType()->isFloatTy() || I.getType()->isDoubleTy()) {
-    inst_list.push_back(std::make_unique<PhiSelectNode>(
+    inst_list.push_back(arena.create<PhiSelectNode>(
         NodeInfo(uid, "phi" + I.getName().str() + to_string(uid)),
         Node::DataType::FloatType,
         reverse,
         &I));
+  } else {
+    assert(!"Uncatch phi instruction type!");
   }
-  auto ff = std::find_if(inst_list.begin(), inst_list.end(), [&I](auto& arg) -> bool {
-    return arg.get()->getInstruction() == &I;
-  });
-  return ff->get();
+  return inst_list.back();
 }
 
 /**
@@ -1242,13 +1282,10 @@ Graph::insertPhiNode(PHINode& I) {
 InstructionNode*
 Graph::insertSelectNode(SelectInst& I) {
   auto uid = getUID(&I);
-  inst_list.push_back(std::make_unique<SelectNode>(
+  inst_list.push_back(arena.create<SelectNode>(
       NodeInfo(uid, "select_" + I.getName().str() + to_string(uid)), &I));
 
-  auto ff = std::find_if(inst_list.begin(), inst_list.end(), [&I](auto& arg) -> bool {
-    return arg.get()->getInstruction() == &I;
-  });
-  return ff->get();
+  return inst_list.back();
 }
 
 /**
@@ -1257,7 +1294,7 @@ Graph::insertSelectNode(SelectInst& I) {
 AllocaNode*
 Graph::insertAllocaNode(AllocaInst& I, uint32_t size, uint32_t num_byte) {
   auto uid = getUID(&I);
-  inst_list.push_back(std::make_unique<AllocaNode>(
+  inst_list.push_back(arena.create<AllocaNode>(
       NodeInfo(uid, "alloca_" + I.getName().str() + to_string(uid)),
       AllocaNode::DataType::PointerType,
       num_byte,
@@ -1265,10 +1302,7 @@ Graph::insertAllocaNode(AllocaInst& I, uint32_t size, uint32_t num_byte) {
       inst_list.size(),
       &I));
 
-  auto ff = std::find_if(inst_list.begin(), inst_list.end(), [&I](auto& arg) -> bool {
-    return arg.get()->getInstruction() == &I;
-  });
-  return dyn_cast<AllocaNode>(ff->get());
+  return cast<AllocaNode>(inst_list.back());
 }
 
 /**
@@ -1277,28 +1311,22 @@ Graph::insertAllocaNode(AllocaInst& I, uint32_t size, uint32_t num_byte) {
 InstructionNode*
 Graph::insertGepNode(GetElementPtrInst& I, GepInfo _info) {
   auto uid = getUID(&I);
-  inst_list.push_back(std::make_unique<GepNode>(
+  inst_list.push_back(arena.create<GepNode>(
       NodeInfo(uid, "Gep_" + I.getName().str() + to_string(uid)),
       BinaryOperatorNode::DataType::PointerType,
       _info,
       &I));
 
-  auto ff = std::find_if(inst_list.begin(), inst_list.end(), [&I](auto& arg) -> bool {
-    return arg.get()->getInstruction() == &I;
-  });
-  return ff->get();
+  return inst_list.back();
 }
 
 InstructionNode*
 Graph::insertBitcastNode(BitCastInst& I) {
   auto uid = getUID(&I);
-  inst_list.push_back(std::make_unique<BitcastNode>(
+  inst_list.push_back(arena.create<BitcastNode>(
       NodeInfo(uid, "bitcast_" + I.getName().str() + to_string(uid)), &I));
 
-  auto ff = std::find_if(inst_list.begin(), inst_list.end(), [&I](auto& arg) -> bool {
-    return arg.get()->getInstruction() == &I;
-  });
-  return ff->get();
+  return inst_list.back();
 }
 
 /**
@@ -1309,36 +1337,31 @@ Graph::insertLoadNode(LoadInst& I) {
   auto _load_list = getNodeList<LoadNode>(this);
   auto uid        = getUID(&I);
   if (I.getType()->isIntegerTy()) {
-    inst_list.push_back(
-        std::make_unique<LoadNode>(NodeInfo(uid, "ld_" + std::to_string(uid)),
-                                   Node::DataType::IntegerType,
-                                   &I,
-                                   this->getMemoryUnit()));
+    inst_list.push_back(arena.create<LoadNode>(NodeInfo(uid, "ld_" + std::to_string(uid)),
+                                               Node::DataType::IntegerType,
+                                               &I,
+                                               this->getMemoryUnit()));
   } else if (I.getType()->isPointerTy()) {
-    inst_list.push_back(
-        std::make_unique<LoadNode>(NodeInfo(uid, "ld_" + std::to_string(uid)),
-                                   Node::DataType::PointerType,
-                                   &I,
-                                   this->getMemoryUnit()));
+    inst_list.push_back(arena.create<LoadNode>(NodeInfo(uid, "ld_" + std::to_string(uid)),
+                                               Node::DataType::PointerType,
+                                               &I,
+                                               this->getMemoryUnit()));
   } else if (I.getType()->isFloatTy() || I.getType()->isDoubleTy()) {
-    inst_list.push_back(
-        std::make_unique<LoadNode>(NodeInfo(uid, "ld_" + std::to_string(uid)),
-                                   Node::DataType::FloatType,
-                                   &I,
-                                   this->getMemoryUnit()));
+    inst_list.push_back(arena.create<LoadNode>(NodeInfo(uid, "ld_" + std::to_string(uid)),
+                                               Node::DataType::FloatType,
+                                               &I,
+                                               this->getMemoryUnit()));
   } else if (I.getType()->isArrayTy()) {
     if (I.getType()->getArrayElementType()->isIntegerTy()) {
-      inst_list.push_back(
-          std::make_unique<LoadNode>(NodeInfo(uid, "ld_" + std::to_string(uid)),
-                                     Node::DataType::IntegerType,
-                                     &I,
-                                     this->getMemoryUnit()));
+      inst_list.push_back(arena.create<LoadNode>(NodeInfo(uid, "ld_" + std::to_string(uid)),
+                                                 Node::DataType::IntegerType,
+                                                 &I,
+                                                 this->getMemoryUnit()));
     } else if (I.getType()->getArrayElementType()->isFloatTy()) {
-      inst_list.push_back(
-          std::make_unique<LoadNode>(NodeInfo(uid, "ld_" + std::to_string(uid)),
-                                     Node::DataType::FloatType,
-                                     &I,
-                                     this->getMemoryUnit()));
+      inst_list.push_back(arena.create<LoadNode>(NodeInfo(uid, "ld_" + std::to_string(uid)),
+                                                 Node::DataType::FloatType,
+                                                 &I,
+                                                 this->getMemoryUnit()));
     } else {
       I.getType()->getArrayElementType()->dump();
       assert(!"Uncatched array type for load nodes");
@@ -1356,10 +1379,7 @@ Graph::insertLoadNode(LoadInst& I) {
     assert(!"Uncatch load instruction\n");
   }
 
-  auto ff = std::find_if(inst_list.begin(), inst_list.end(), [&I](auto& arg) -> bool {
-    return arg.get()->getInstruction() == &I;
-  });
-  return ff->get();
+  return inst_list.back();
 }
 
 /**
@@ -1369,13 +1389,10 @@ InstructionNode*
 Graph::insertStoreNode(StoreInst& I) {
   auto uid         = getUID(&I);
   auto _store_list = getNodeList<StoreNode>(this);
-  inst_list.push_back(std::make_unique<StoreNode>(
+  inst_list.push_back(arena.create<StoreNode>(
       NodeInfo(uid, "st_" + std::to_string(uid)), &I, this->getMemoryUnit()));
 
-  auto ff = std::find_if(inst_list.begin(), inst_list.end(), [&I](auto& arg) -> bool {
-    return arg.get()->getInstruction() == &I;
-  });
-  return ff->get();
+  return inst_list.back();
 }
 
 /**
@@ -1386,24 +1403,22 @@ Graph::insertCallNode(CallInst& I) {
   // if (I.getName().str() == "")
   auto uid = getUID(&I);
   inst_list.push_back(
-      std::make_unique<CallNode>(NodeInfo(uid, "call_" + std::to_string(uid)), &I));
+      arena.create<CallNode>(NodeInfo(uid, "call_" + std::to_string(uid)), &I));
   // else
-  // inst_list.push_back(std::make_unique<CallNode>(
+  // inst_list.push_back(arena.create<CallNode>(
   // NodeInfo(inst_list.size(), I.getName().str()), &I));
 
-  auto ff = std::find_if(inst_list.begin(), inst_list.end(), [&I](auto& arg) -> bool {
-    return arg.get()->getInstruction() == &I;
-  });
+  auto _node = cast<CallNode>(inst_list.back());
 
-  auto call_in  = dyn_cast<CallNode>(ff->get())->getCallIn();
-  auto call_out = dyn_cast<CallNode>(ff->get())->getCallOut();
+  auto call_in  = _node->getCallIn();
+  auto call_out = _node->getCallOut();
 
   call_in->setParent(this);
   call_out->setParent(this);
   this->pushCallIn(call_in);
   this->pushCallOut(call_out);
 
-  return ff->get();
+  return _node;
 }
 
 /**
@@ -1412,13 +1427,10 @@ Graph::insertCallNode(CallInst& I) {
 InstructionNode*
 Graph::insertReturnNode(ReturnInst& I) {
   auto uid = getUID(&I);
-  inst_list.push_back(std::make_unique<ReturnNode>(
+  inst_list.push_back(arena.create<ReturnNode>(
       NodeInfo(uid, "ret_" + I.getName().str() + std::to_string(uid)), &I));
 
-  auto ff = std::find_if(inst_list.begin(), inst_list.end(), [&I](auto& arg) -> bool {
-    return arg.get()->getInstruction() == &I;
-  });
-  return ff->get();
+  return inst_list.back();
 }
 
 /**
@@ -1426,13 +1438,23 @@ Graph::insertReturnNode(ReturnInst& I) {
  */
 GlobalValueNode*
 Graph::insertFunctionGlobalValue(GlobalValue& G) {
-  glob_list.push_back(GlobalValueNode(NodeInfo(glob_list.size(), G.getName().str()), &G));
+  glob_list.push_back(
+      arena.create<GlobalValueNode>(NodeInfo(glob_list.size(), G.getName().str()), &G));
 
-  auto ff =
-      std::find_if(glob_list.begin(), glob_list.end(), [&G](GlobalValueNode& gl) -> bool {
-        return gl.getGlobalValue() == &G;
-      });
-  return &*ff;
+  return glob_list.back();
+}
+
+/**
+ * Register a freshly appended edge inside the lookup tables
+ * If the same ports are already connected the first edge is returned
+ */
+Edge*
+Graph::indexEdge(EdgeList::iterator _edge) {
+  auto _src = (*_edge)->getSrc();
+  auto _tar = (*_edge)->getTar();
+
+  edge_node_index[NodePair(_src.first, _tar.first)].push_back(_edge);
+  return edge_port_index.emplace(PortPair(_src, _tar), *_edge).first->second;
 }
 
 /**
@@ -1440,27 +1462,14 @@ Graph::insertFunctionGlobalValue(GlobalValue& G) {
  */
 Edge*
 Graph::insertEdge(Edge::EdgeType _typ, Port _node_src, Port _node_dst) {
-  // TODO fix the indexing
-  edge_list.push_back(std::make_unique<Edge>(_typ, _node_src, _node_dst));
-  auto ff =
-      std::find_if(edge_list.begin(),
-                   edge_list.end(),
-                   [_node_src, _node_dst](std::unique_ptr<Edge>& e) -> bool {
-                     return (e->getSrc() == _node_src) && (e->getTar() == _node_dst);
-                   });
-
-  return ff->get();
+  auto _edge = edge_list.insert(edge_list.end(),
+                                arena.create<Edge>(_typ, _node_src, _node_dst));
+  return indexEdge(_edge);
 }
 
 bool
 Graph::edgeExist(Port _node_src, Port _node_dst) {
-  auto ff =
-      std::find_if(edge_list.begin(),
-                   edge_list.end(),
-                   [_node_src, _node_dst](std::unique_ptr<Edge>& e) -> bool {
-                     return (e->getSrc() == _node_src) && (e->getTar() == _node_dst);
-                   });
-  return ff != edge_list.end();
+  return edge_port_index.count(PortPair(_node_src, _node_dst)) != 0;
 }
 
 /**
@@ -1468,24 +1477,18 @@ Graph::edgeExist(Port _node_src, Port _node_dst) {
  */
 Edge*
 Graph::findEdge(const Port _src, const Port _dst) const {
-  auto ff =
-      std::find_if(edge_list.begin(), edge_list.end(), [_src, _dst](auto& e) -> bool {
-        return (e->getSrc() == _src) && (e->getTar() == _dst);
-      });
-  if (ff != edge_list.end())
-    return ff->get();
+  auto ff = edge_port_index.find(PortPair(_src, _dst));
+  if (ff != edge_port_index.end())
+    return ff->second;
   else
     return nullptr;
 }
 
 Edge*
 Graph::findEdge(const Node* _src, const Node* _dst) const {
-  auto ff =
-      std::find_if(edge_list.begin(), edge_list.end(), [_src, _dst](auto& e) -> bool {
-        return (e->getSrc().first == _src) && (e->getTar().first == _dst);
-      });
-  if (ff != edge_list.end())
-    return ff->get();
+  auto ff = edge_node_index.find(NodePair(_src, _dst));
+  if (ff != edge_node_index.end())
+    return *ff->second.front();
   else
     return nullptr;
 }
@@ -1495,15 +1498,9 @@ Graph::findEdge(const Node* _src, const Node* _dst) const {
  */
 Edge*
 Graph::insertMemoryEdge(Edge::EdgeType _edge_type, Port _node_src, Port _node_dst) {
-  edge_list.push_back(std::make_unique<Edge>(_edge_type, _node_src, _node_dst));
-  auto ff =
-      std::find_if(edge_list.begin(),
-                   edge_list.end(),
-                   [_node_src, _node_dst](std::unique_ptr<Edge>& e) -> bool {
-                     return (e->getSrc() == _node_src) && (e->getTar() == _node_dst);
-                   });
-
-  return ff->get();
+  auto _edge = edge_list.insert(edge_list.end(),
+                                arena.create<Edge>(_edge_type, _node_src, _node_dst));
+  return indexEdge(_edge);
 }
 
 /**
@@ -1511,24 +1508,51 @@ Graph::insertMemoryEdge(Edge::EdgeType _edge_type, Port _node_src, Port _node_ds
  */
 ScratchpadNode*
 Graph::createBufferMemory(AllocaNode* alloca, uint32_t size, uint32_t num_byte) {
-  scratchpad_memories.push_back(std::make_unique<ScratchpadNode>(
+  scratchpad_memories.push_back(arena.create<ScratchpadNode>(
       NodeInfo(scratchpad_memories.size(),
                "buffer_memories_" + std::to_string(scratchpad_memories.size())),
       alloca,
       size,
       num_byte));
 
-  return scratchpad_memories.end()->get();
+  return scratchpad_memories.back();
 }
 
 ScratchpadNode*
-Graph::returnScratchpadMem(AllocaInst* alloca) {
+Graph::returnScratchpadMem(const AllocaInst* alloca) {
   auto mem = std::find_if(
       scratchpad_memories.begin(), scratchpad_memories.end(), [alloca](auto& scratch) {
         return scratch->getAllocaNode()->getInstruction() == alloca;
       });
 
-  return mem->get();
+  return *mem;
+}
+
+/**
+ * Memory unit of the given object, the objects without a bank share the
+ * memory unit of the graph
+ */
+MemoryNode*
+Graph::getMemoryUnit(const llvm::Value* _obj) const {
+  auto _bank = memory_bank_map.find(_obj);
+  if (_bank == memory_bank_map.end())
+    return memory_unit.get();
+  return _bank->second;
+}
+
+/**
+ * Creating a memory bank for the given object, banks are numbered after the
+ * shared memory unit
+ */
+MemoryNode*
+Graph::createMemoryBank(const llvm::Value* _obj) {
+  auto _id = memory_banks.size() + 1;
+  memory_banks.push_back(
+      arena.create<MemoryNode>(NodeInfo(_id, "mem_bank_" + std::to_string(_id)), true));
+  if (_obj)
+    memory_bank_map[_obj] = memory_banks.back();
+
+  return memory_banks.back();
 }
 
 /**
@@ -1536,11 +1560,11 @@ Graph::returnScratchpadMem(AllocaInst* alloca) {
  */
 ConstIntNode*
 Graph::insertConstIntNode(ConstantInt& C) {
-  const_int_list.push_back(std::make_unique<ConstIntNode>(
+  const_int_list.push_back(arena.create<ConstIntNode>(
       NodeInfo(const_int_list.size(), "const" + std::to_string(const_int_list.size())),
       &C));
 
-  return const_int_list.back().get();
+  return const_int_list.back();
 }
 
 /**
@@ -1548,11 +1572,11 @@ Graph::insertConstIntNode(ConstantInt& C) {
  */
 ConstIntNode*
 Graph::insertConstIntNode() {
-  const_int_list.push_back(std::make_unique<ConstIntNode>(
+  const_int_list.push_back(arena.create<ConstIntNode>(
       NodeInfo(const_int_list.size(), "const" + std::to_string(const_int_list.size())),
       nullptr));
 
-  return const_int_list.back().get();
+  return const_int_list.back();
 }
 
 /**
@@ -1561,15 +1585,13 @@ Graph::insertConstIntNode() {
 InstructionNode*
 Graph::insertTruncNode(TruncInst& I) {
   auto uid = getUID(&I);
-  inst_list.push_back(std::make_unique<TruncNode>(
+  inst_list.push_back(arena.create<TruncNode>(
       NodeInfo(uid, "trunc" + I.getName().str() + to_string(uid)), &I));
 
-  auto ff = std::find_if(inst_list.begin(), inst_list.end(), [&I](auto& arg) -> bool {
-    return arg.get()->getInstruction() == &I;
-  });
-  ff->get()->printDefinition(PrintType::Scala);
+  auto _node = inst_list.back();
+  _node->printDefinition(PrintType::Scala);
 
-  return ff->get();
+  return _node;
 }
 
 /**
@@ -1578,15 +1600,13 @@ Graph::insertTruncNode(TruncInst& I) {
 InstructionNode*
 Graph::insertSTIoFPNode(SIToFPInst& I) {
   auto uid = getUID(&I);
-  inst_list.push_back(std::make_unique<STIoFPNode>(
+  inst_list.push_back(arena.create<STIoFPNode>(
       NodeInfo(uid, "stiofp" + I.getName().str() + to_string(uid)), &I));
 
-  auto ff = std::find_if(inst_list.begin(), inst_list.end(), [&I](auto& arg) -> bool {
-    return arg.get()->getInstruction() == &I;
-  });
-  ff->get()->printDefinition(PrintType::Scala);
+  auto _node = inst_list.back();
+  _node->printDefinition(PrintType::Scala);
 
-  return ff->get();
+  return _node;
 }
 
 /**
@@ -1595,15 +1615,13 @@ Graph::insertSTIoFPNode(SIToFPInst& I) {
 InstructionNode*
 Graph::insertFPToUINode(FPToUIInst& I) {
   auto uid = getUID(&I);
-  inst_list.push_back(std::make_unique<FPToUINode>(
+  inst_list.push_back(arena.create<FPToUINode>(
       NodeInfo(uid, "stiofp" + I.getName().str() + to_string(uid)), &I));
 
-  auto ff = std::find_if(inst_list.begin(), inst_list.end(), [&I](auto& arg) -> bool {
-    return arg.get()->getInstruction() == &I;
-  });
-  ff->get()->printDefinition(PrintType::Scala);
+  auto _node = inst_list.back();
+  _node->printDefinition(PrintType::Scala);
 
-  return ff->get();
+  return _node;
 }
 
 /**
@@ -1612,15 +1630,13 @@ Graph::insertFPToUINode(FPToUIInst& I) {
 InstructionNode*
 Graph::insertSextNode(SExtInst& I) {
   auto uid = getUID(&I);
-  inst_list.push_back(std::make_unique<SextNode>(
+  inst_list.push_back(arena.create<SextNode>(
       NodeInfo(uid, "sext" + I.getName().str() + to_string(uid)), &I));
 
-  auto ff = std::find_if(inst_list.begin(), inst_list.end(), [&I](auto& arg) -> bool {
-    return arg.get()->getInstruction() == &I;
-  });
-  ff->get()->printDefinition(PrintType::Scala);
+  auto _node = inst_list.back();
+  _node->printDefinition(PrintType::Scala);
 
-  return ff->get();
+  return _node;
 }
 
 /**
@@ -1629,15 +1645,13 @@ Graph::insertSextNode(SExtInst& I) {
 InstructionNode*
 Graph::insertZextNode(ZExtInst& I) {
   auto uid = getUID(&I);
-  inst_list.push_back(std::make_unique<ZextNode>(
+  inst_list.push_back(arena.create<ZextNode>(
       NodeInfo(uid, "sext" + I.getName().str() + to_string(uid)), &I));
 
-  auto ff = std::find_if(inst_list.begin(), inst_list.end(), [&I](auto& arg) -> bool {
-    return arg.get()->getInstruction() == &I;
-  });
-  ff->get()->printDefinition(PrintType::Scala);
+  auto _node = inst_list.back();
+  _node->printDefinition(PrintType::Scala);
 
-  return ff->get();
+  return _node;
 }
 
 /**
@@ -1646,24 +1660,11 @@ Graph::insertZextNode(ZExtInst& I) {
 
 ConstFPNode*
 Graph::insertConstFPNode(ConstantFP& C) {
-  const_fp_list.push_back(std::make_unique<ConstFPNode>(
+  const_fp_list.push_back(arena.create<ConstFPNode>(
       NodeInfo(const_fp_list.size(), "constf" + std::to_string(const_fp_list.size())),
       &C));
 
-  return const_fp_list.back().get();
-}
-
-LoopNode*
-Graph::insertLoopNode(std::unique_ptr<LoopNode> _ln) {
-  auto _node_p = _ln.get();
-  loop_nodes.push_back(std::move(_ln));
-
-  auto ff = std::find_if(
-      loop_nodes.begin(),
-      loop_nodes.end(),
-      [_node_p](std::unique_ptr<LoopNode>& l) -> bool { return l.get() == _node_p; });
-
-  return ff->get();
+  return const_fp_list.back();
 }
 
 /**
@@ -1676,9 +1677,15 @@ Graph::setFunction(Function* _fn) {
 
 void
 Graph::removeEdge(Node* _src, Node* _dest) {
-  this->edge_list.remove_if([_src, _dest](std::unique_ptr<Edge>& _e) -> bool {
-    return (_e->getSrc().first == _src) && (_e->getTar().first == _dest);
-  });
+  auto ff = edge_node_index.find(NodePair(_src, _dest));
+  if (ff == edge_node_index.end())
+    return;
+
+  for (auto _edge : ff->second) {
+    edge_port_index.erase(PortPair((*_edge)->getSrc(), (*_edge)->getTar()));
+    this->edge_list.erase(_edge);
+  }
+  edge_node_index.erase(ff);
 }
 
 /**
@@ -1694,7 +1701,7 @@ Graph::printLoopBranchEdges(PrintType _pt) {
         for (auto _enable_iterator : _l_node->input_control_range()) {
           auto _input_node = dyn_cast<Node>(&*_enable_iterator.first);
 
-          auto _output_index = _input_node->returnControlOutputPortIndex(_l_node.get());
+          auto _output_index = _input_node->returnControlOutputPortIndex(_l_node);
 
           this->outCode << "  "
                         << _l_node->printInputEnable(PrintType::Scala,
@@ -1727,6 +1734,11 @@ Graph::printLoopEndingDependencies(PrintType _pt) {
 
         for (auto& _ending_ins : _l_node->endings()) {
           for (auto& _cn_dependencies : _ending_ins->output_control_range()) {
+            // Memory ordering edges are printed with the control dependencies
+            if (isa<LoadNode>(_cn_dependencies.first)
+                || isa<StoreNode>(_cn_dependencies.first))
+              continue;
+
             auto _input_index =
                 _cn_dependencies.first->returnControlInputPortIndex(_ending_ins);
 
@@ -2009,7 +2021,7 @@ Graph::doInitialization() {
   }
 
   for (auto& _node : inst_list) {
-    Node* _ptr = _node.get();
+    Node* _ptr = _node;
     if (isa<CallNode>(_ptr))
       _ptr = dyn_cast<CallNode>(_ptr)->getCallIn();
     for (auto& _child : _ptr->output_data_range()) {
@@ -2083,20 +2095,151 @@ Graph::groundReattachNode() {
   }
 }
 
+/**
+ * Replaces a group of instruction nodes with one fused compute node. The
+ * members come operands first with the root, the only member whose value
+ * leaves the group, last and the constants are the ones folded into the
+ * expression of the fused node, which is left to the caller. The inputs of
+ * the fused node are the other sources of the members in the order of the
+ * members and their ports, a source feeding more than one member is
+ * connected once, and its outputs are the ones of the root.
+ * NOTE: The replaced nodes are only dropped from the lists by
+ * eraseFusedNodes, so the lists can be walked while the groups are fused.
+ */
+FusedComputeNode*
+Graph::fuseInstructions(ArrayRef<InstructionNode*> _members,
+                        ArrayRef<ConstIntNode*> _constants) {
+  auto _root  = _members.back();
+  auto _fused = arena.create<FusedComputeNode>(
+      NodeInfo(_root->getID(), "fused_" + _root->getName()));
+  _fused->setParentNode(_root->getParentNode());
+  _fused->setDataType(_root->getDataType());
+  _fused->setModuleName(this->graph_info.Name + "_" + _fused->getScalaName());
+
+  std::string _text;
+  raw_string_ostream _text_out(_text);
+  for (auto _member : _members) {
+    _text_out << (_member == _members.front() ? "" : ";");
+    _member->printInstruction(_text_out);
+    fused_nodes[_member] = nullptr;
+  }
+  _fused->setInstructionText(_text_out.str());
+  fused_nodes[_root] = _fused;
+  for (auto _const : _constants)
+    fused_nodes[_const] = nullptr;
+
+  for (auto _member : _members) {
+    for (auto& _port : _member->input_data_range()) {
+      auto _src = _port.first;
+      if (fused_nodes.count(_src))
+        continue;
+      if (_fused->existDataInput(_src)) {
+        _src->removeNodeDataOutputNode(_member);
+      } else {
+        _fused->addDataInputPort(_src);
+        _src->replaceDataOutputNode(_member, _fused);
+      }
+    }
+  }
+
+  for (auto& _port : _root->output_data_range()) {
+    _fused->addDataOutputPort(_port.first, _port.second.getID());
+    _port.first->replaceDataInputNode(_root, _fused);
+  }
+
+  // The fused node takes the enable of the root
+  _fused->addControlInputPort(_root->inputControl_begin()->first);
+  for (auto _member : _members)
+    fused_parents.insert(_member->inputControl_begin()->first);
+  for (auto _const : _constants)
+    fused_parents.insert(_const->inputControl_begin()->first);
+
+  return _fused;
+}
+
+/**
+ * Drops the nodes fuseInstructions replaced from the lists and from the
+ * control outputs of their super nodes, the control ports are numbered again
+ */
+void
+Graph::eraseFusedNodes() {
+  if (fused_nodes.empty())
+    return;
+
+  auto _remap = [this](Node* _node) {
+    auto _fused = fused_nodes.find(_node);
+    return _fused == fused_nodes.end() ? _node : _fused->second;
+  };
+  auto _remap_ins = [&_remap](InstructionNode* _node) {
+    return cast_or_null<InstructionNode>(_remap(_node));
+  };
+  auto _is_fused = [this](ConstIntNode* _const) {
+    return fused_nodes.count(_const) != 0;
+  };
+
+  for (auto _parent : fused_parents) {
+    _parent->remapControlOutputNodes(_remap);
+    if (auto _bb = dyn_cast<SuperNode>(_parent)) {
+      _bb->remapInstructions(_remap_ins);
+      _bb->removeconstIntNodes(_is_fused);
+    }
+  }
+
+  for (auto& _node : inst_list)
+    _node = _remap_ins(_node);
+  inst_list.erase(std::remove(inst_list.begin(), inst_list.end(), nullptr),
+                  inst_list.end());
+  const_int_list.erase(
+      std::remove_if(const_int_list.begin(), const_int_list.end(), _is_fused),
+      const_int_list.end());
+
+  // The data edges of a graph loaded from muIR are built again from the ports
+  if (!edge_list.empty()) {
+    edge_list.clear();
+    edge_port_index.clear();
+    edge_node_index.clear();
+    doInitialization();
+  }
+
+  fused_nodes.clear();
+  fused_parents.clear();
+}
+
 //===----------------------------------------------------------------------===//
 //                          Optmization passes
 //===----------------------------------------------------------------------===//
 //
 
+/**
+ * Runs the graph passes -graph-passes names, or the pipeline of the -H level
+ * if it is empty
+ */
 void
 Graph::optimizationPasses() {
-  groundStoreNodes();
+  passes::PassManager _pm;
+  if (graphPasses.empty())
+    passes::buildPipeline(_pm, HWoptLevel);
+  // The circuit stalls on the stores nothing consumes unless they are
+  // grounded, a pipeline given by name always starts with it
+  else if (!is_contained(graphPasses, "ground-stores"))
+    _pm.addPass(std::make_unique<passes::GroundStoreNodes>());
+  for (auto& _name : graphPasses) {
+    if (!_pm.addPass(_name))
+      assert(!"Unknown graph pass!");
+  }
+
+  // The widths LLVM proved for the nodes only reach the circuit through
+  // narrow-widths
+  if (!_pm.hasPass("narrow-widths")) {
+    for (auto _node : inst_list)
+      _node->setDataWidth(0);
+  }
+
+  _pm.run(*this);
 }
 
 void
 Graph::printMUIR() {
-  std::ofstream _out_file(this->graph_info.Name + ".muir.json");
-
   Json::Value _root_json;
 
   _root_json["module"]["name"] = this->graph_info.Name;
@@ -2104,8 +2247,7 @@ Graph::printMUIR() {
   // Printing list of basic blocks
   for (auto& bb : this->super_node_list) {
     Json::Value _node_entry;
-    auto _name = bb->getInfo().Name;
-    std::replace(_name.begin(), _name.end(), '.', '_');
+    auto& _name = bb->getScalaName();
 
     // Getting list of nodes
     Json::Value _node_array;
@@ -2132,16 +2274,16 @@ Graph::printMUIR() {
   // Printing list of instructions
   for (auto& node : this->inst_list) {
     Json::Value _node_entry;
-    auto _name = node->getInfo().Name;
-    std::replace(_name.begin(), _name.end(), '.', '_');
+    auto& _name = node->getScalaName();
     std::string _node_instruction;
     llvm::raw_string_ostream ss(_node_instruction);
-    node->getInstruction()->print(ss);
+    node->printInstruction(ss);
     _node_entry["name"]        = _name;
     _node_entry["id"]          = node->getInfo().ID;
     _node_entry["debug"]       = "false";
     _node_entry["instruction"] = _node_instruction.c_str();
     _node_entry["parent_bb"]   = node->getParentNode()->getID();
+    _node_entry["width"]       = node->getDataWidth();
 
     // Extract instruction type
     std::string node_type;
@@ -2156,10 +2298,13 @@ Graph::printMUIR() {
       case InstructionNode::GetElementPtrInstTy: node_type = "Gep"; break;
       case InstructionNode::GetElementPtrArrayInstTy: node_type = "Gep_Array"; break;
       case InstructionNode::GetElementPtrStructInstTy: node_type = "Gep_Struct"; break;
+      case InstructionNode::FusedInstructionTy: node_type = "Fused"; break;
       default: node_type = "Uknown"; break;
     }
 
     _node_entry["type"] = node_type;
+    if (auto _fused = dyn_cast<FusedComputeNode>(node))
+      _node_entry["expression"] = _fused->getExpression();
 
     function<string(Node*)> print_id;
     print_id = [&print_id](Node* node) -> string {
@@ -2221,6 +2366,7 @@ Graph::printMUIR() {
       _loop_entry["induction_id"] = loop->getInductionVariable()->getID();
     else
       _loop_entry["induction_id"] = Json::Value::null;
+    _loop_entry["trip_count"] = loop->getTripCount();
 
 
     // Getting list of blocks
@@ -2270,6 +2416,140 @@ Graph::printMUIR() {
   }
 
 
-  _out_file << _root_json;
-  _out_file.close();
+  std::stringstream _out_json;
+  _out_json << _root_json;
+  writeIfChanged(this->graph_info.Name + ".muir.json", _out_json.str());
+}
+
+/**
+ * Name of an instruction type in the generator statistics
+ */
+static const char*
+getInstTypeName(uint32_t _type) {
+  switch (_type) {
+    case InstructionNode::BinaryInstructionTy: return "Binary";
+    case InstructionNode::IcmpInstructionTy: return "Icmp";
+    case InstructionNode::BranchInstructionTy: return "Branch";
+    case InstructionNode::PhiInstructionTy: return "Phi";
+    case InstructionNode::AllocaInstructionTy: return "Alloca";
+    case InstructionNode::GetElementPtrArrayInstTy: return "Gep_Array";
+    case InstructionNode::GetElementPtrStructInstTy: return "Gep_Struct";
+    case InstructionNode::GetElementPtrInstTy: return "Gep";
+    case InstructionNode::LoadInstructionTy: return "Load";
+    case InstructionNode::StoreInstructionTy: return "Store";
+    case InstructionNode::SextInstructionTy: return "Sext";
+    case InstructionNode::ZextInstructionTy: return "Zext";
+    case InstructionNode::BitCastInstructionTy: return "Bitcast";
+    case InstructionNode::STIoFPInstructionTy: return "SIToFP";
+    case InstructionNode::FPToUIInstructionTy: return "FPToUI";
+    case InstructionNode::TruncInstructionTy: return "Trunc";
+    case InstructionNode::SelectInstructionTy: return "Select";
+    case InstructionNode::FaddInstructionTy: return "Fadd";
+    case InstructionNode::FsubInstructionTy: return "Fsub";
+    case InstructionNode::FmulInstructionTy: return "Fmul";
+    case InstructionNode::FdiveInstructionTy: return "Fdiv";
+    case InstructionNode::FremInstructionTy: return "Frem";
+    case InstructionNode::FcmpInstructionTy: return "Fcmp";
+#ifdef TAPIR
+    case InstructionNode::DetachInstructionTy: return "Detach";
+    case InstructionNode::ReattachInstructionTy: return "Reattach";
+    case InstructionNode::SyncInstructionTy: return "Sync";
+#endif
+    case InstructionNode::ReturnInstrunctionTy: return "Return";
+    case InstructionNode::CallInstructionTy: return "Call";
+    case InstructionNode::CallInInstructionTy: return "CallIn";
+    case InstructionNode::CallOutInstructionTy: return "CallOut";
+    case InstructionNode::FusedInstructionTy: return "Fused";
+    default: return "Uknown";
+  }
+}
+
+void
+Graph::collectStats() {
+  if (!stats::isEnabled())
+    return;
+
+  auto& _name = this->graph_info.Name;
+  std::map<std::string, uint64_t> _instructions;
+  uint64_t _ports[8] = {0};
+  uint64_t _num_args = 0;
+
+  auto _count_ports = [&_ports](Node* _node) {
+    _ports[0] += _node->numDataInputPort();
+    _ports[1] += _node->numDataOutputPort();
+    _ports[2] += _node->numControlInputPort();
+    _ports[3] += _node->numControlOutputPort();
+    _ports[4] += _node->numReadMemReqPort();
+    _ports[5] += _node->numReadMemRespPort();
+    _ports[6] += _node->numWriteMemReqPort();
+    _ports[7] += _node->numWriteMemRespPort();
+  };
+  auto _count_args = [&_count_ports, &_num_args](auto _args) {
+    for (auto& _arg : _args) {
+      _count_ports(_arg.get());
+      _num_args++;
+    }
+  };
+
+  for (auto _bb : super_node_list)
+    _count_ports(_bb);
+  for (auto _ins : inst_list) {
+    _count_ports(_ins);
+    _instructions[getInstTypeName(_ins->getOpCode())]++;
+  }
+  for (auto _call : call_in_list)
+    _count_ports(_call);
+  for (auto _call : call_out_list)
+    _count_ports(_call);
+  for (auto _loop : loop_nodes) {
+    _count_ports(_loop);
+    _count_args(_loop->live_in_lists());
+    _count_args(_loop->live_out_lists());
+    _count_args(_loop->carry_depen_lists());
+  }
+  _count_ports(split_call.get());
+  _count_args(split_call->live_in_ptrs_lists());
+  _count_args(split_call->live_in_vals_lists());
+  for (auto _glob : glob_list)
+    _count_ports(_glob);
+  for (auto _const : const_int_list)
+    _count_ports(_const);
+  for (auto _const : const_fp_list)
+    _count_ports(_const);
+  for (auto _mem : scratchpad_memories)
+    _count_ports(_mem);
+  for (auto _unit : getMemoryUnits())
+    _count_ports(_unit);
+  _count_ports(floating_point_unit.get());
+
+  stats::setCount(_name, "nodes", "super_node", super_node_list.size());
+  stats::setCount(_name, "nodes", "instruction", inst_list.size());
+  stats::setCount(_name, "nodes", "loop", loop_nodes.size());
+  stats::setCount(_name, "nodes", "argument", _num_args);
+  stats::setCount(_name, "nodes", "global", glob_list.size());
+  stats::setCount(_name, "nodes", "const_int", const_int_list.size());
+  stats::setCount(_name, "nodes", "const_fp", const_fp_list.size());
+  stats::setCount(_name, "nodes", "scratchpad", scratchpad_memories.size());
+  stats::setCount(_name, "nodes", "memory_bank", memory_banks.size());
+  for (auto& _ins : _instructions)
+    stats::setCount(_name, "instructions", _ins.first, _ins.second);
+
+  const char* _port_names[8] = {"data_input",
+                                "data_output",
+                                "control_input",
+                                "control_output",
+                                "memory_read_req",
+                                "memory_read_resp",
+                                "memory_write_req",
+                                "memory_write_resp"};
+  for (uint32_t i = 0; i < 8; i++)
+    stats::setCount(_name, "ports", _port_names[i], _ports[i]);
+
+  const char* _edge_names[Edge::UknownType + 1] = {
+      "data", "control", "mask", "memory_read", "memory_write", "unknown"};
+  uint64_t _edges[Edge::UknownType + 1] = {0};
+  for (auto _edge : edge_list)
+    _edges[std::min<uint32_t>(_edge->getType(), Edge::UknownType)]++;
+  for (uint32_t i = 0; i <= Edge::UknownType; i++)
+    stats::setCount(_name, "edges", _edge_names[i], _edges[i]);
 }
@@ -3,6 +3,8 @@
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/Analysis/LoopInfo.h"
+#include "llvm/Analysis/ScalarEvolution.h"
+#include "llvm/Analysis/ValueTracking.h"
 #include "llvm/IR/BasicBlock.h"
 #include "llvm/IR/CFG.h"
 #include "llvm/IR/CallSite.h"
@@ -11,10 +13,12 @@
 #include "llvm/IR/InstIterator.h"
 #include "llvm/IR/Instructions.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/KnownBits.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Transforms/Utils/BasicBlockUtils.h"
 #include "llvm/Transforms/Utils/CodeExtractor.h"
 
+#include <algorithm>
 #include <iostream>
 #include <numeric>
 
@@ -81,6 +85,47 @@ returnNumPred(BasicBlock* BB) {
   return c;
 }
 
+//===----------------------------------------------------------------------===//
+//                           ValueNumbering Class
+//===----------------------------------------------------------------------===//
+
+void
+ValueNumbering::number(Function& F) {
+  clear();
+
+  uint32_t _index = 0;
+  for (auto& _arg : F.args())
+    value_index[&_arg] = _index++;
+  num_args = _index;
+
+  uint32_t _num_operands = 0;
+  for (auto& _ins : instructions(F)) {
+    value_index[&_ins] = _index++;
+    operand_begin.push_back(_num_operands);
+    _num_operands += _ins.getNumOperands();
+  }
+  operand_begin.push_back(_num_operands);
+}
+
+void
+ValueNumbering::clear() {
+  value_index.clear();
+  operand_begin.clear();
+  num_args = 0;
+}
+
+uint32_t
+ValueNumbering::getIndex(const Value* _value) const {
+  auto _it = value_index.find(_value);
+  assert(_it != value_index.end() && "The value is not numbered!");
+  return _it->second;
+}
+
+uint32_t
+ValueNumbering::getOperandBase(const Instruction* _ins) const {
+  return operand_begin[getIndex(_ins) - num_args];
+}
+
 /**
  * definedInCaller - Return true if the specified value is defined in the
  * function being code extracted, but not in the region being extracted. These
@@ -156,7 +201,7 @@ getOuterLoops(LoopInfo& LI) {
 void
 UpdateLiveInConnections(Loop* _loop,
                         LoopNode* _loop_node,
-                        std::map<llvm::Value*, Node*> map_value_node) {
+                        ValueNodeMap& map_value_node) {
   for (auto B : _loop->blocks()) {
     for (auto& I : *B) {
       // Detecting Live-ins
@@ -203,7 +248,7 @@ UpdateLiveInConnections(Loop* _loop,
 void
 UpdateLiveOutConnections(Loop* _loop,
                          LoopNode* _loop_node,
-                         std::map<llvm::Value*, Node*> map_value_node) {
+                         ValueNodeMap& map_value_node) {
   for (auto B : _loop->blocks()) {
     for (auto& I : *B) {
       /**
@@ -243,8 +288,8 @@ UpdateLiveOutConnections(Loop* _loop,
 
 void
 UpdateInnerLiveInConnections(Loop* _loop,
-                             std::map<llvm::Loop*, LoopNode*> loop_value_node,
-                             std::map<llvm::Value*, Node*> map_value_node) {
+                             DenseMap<llvm::Loop*, LoopNode*>& loop_value_node,
+                             ValueNodeMap& map_value_node) {
   for (auto B : _loop->blocks()) {
     for (auto& I : *B) {
       for (auto OI = I.op_begin(); OI != I.op_end(); OI++) {
@@ -292,8 +337,8 @@ UpdateInnerLiveInConnections(Loop* _loop,
 
 void
 UpdateInnerLiveOutConnections(Loop* _loop,
-                              std::map<llvm::Loop*, LoopNode*> loop_value_node,
-                              std::map<llvm::Value*, Node*> map_value_node) {
+                              DenseMap<llvm::Loop*, LoopNode*>& loop_value_node,
+                              ValueNodeMap& map_value_node) {
   for (auto B : _loop->blocks()) {
     for (auto& I : *B) {
       auto _loop_node = loop_value_node[_loop];
@@ -378,161 +423,189 @@ GraphGeneratorPass::summarizeLoop(Loop* L, LoopInfo& LI) {
     }
   }
 
-  // 3)Get all the sub-loops
+  // 3)Get all the sub-loops, the sub-loops are already summarized since the
+  // loops are visited in post-order
   for (auto SL : L->getSubLoops()) {
-    findAllLoops(SL, summary.sub_loops);
+    auto _sub_summary = loop_sum.find(SL);
+    assert(_sub_summary != loop_sum.end() && "Sub-loop is not summarized!");
+    summary.sub_loops.insert(_sub_summary->second.sub_loops.begin(),
+                             _sub_summary->second.sub_loops.end());
+    summary.sub_loops.insert(SL);
+  }
+
+  // Instructions are ordered the same way the loop blocks are
+  DenseMap<BasicBlock*, uint32_t> _block_index;
+  uint32_t _num_blocks = 0;
+  for (auto _bb : L->blocks())
+    _block_index[_bb] = _num_blocks++;
+
+  // The numbering follows the order of the instructions inside each block
+  auto _position = [&_block_index, this](Instruction* _ins) {
+    return std::make_pair(_block_index[_ins->getParent()],
+                          value_numbering.getIndex(_ins));
+  };
+
+  // Direct sub-loop of L which contains the instruction, or null if the
+  // instruction belongs to L itself
+  auto _get_sub_loop = [L, &LI](Instruction* _ins) {
+    Loop* _loop = LI.getLoopFor(_ins->getParent());
+    if (_loop == L)
+      return static_cast<Loop*>(nullptr);
+    while (_loop->getParentLoop() != L)
+      _loop = _loop->getParentLoop();
+    return _loop;
+  };
+
+  auto _is_live_in = [L](Value* _op) {
+    bool is_live_in = isa<Argument>(_op);
+    if (auto _inst = dyn_cast<Instruction>(_op))
+      is_live_in = !L->contains(_inst) ? true : false;
+
+    auto _intrinsic_op = CallSite(_op);
+    if (_intrinsic_op.getInstruction()) {
+      auto _intrinsic_call =
+          dyn_cast<Function>(_intrinsic_op.getCalledValue()->stripPointerCasts());
+
+      if (_intrinsic_call) {
+        if (_intrinsic_call->isDeclaration()) {
+          is_live_in = false;
+        }
+      }
+    }
+    return is_live_in;
+  };
+
+  // Only the blocks which belong to L itself are scanned, the uses crossing
+  // the boundaries of the sub-loops come from their summaries. A use leaving
+  // L has to leave the sub-loop too.
+  for (auto SL : L->getSubLoops()) {
+    auto& _sub_summary = loop_sum.find(SL)->second;
+    for (auto _use : _sub_summary.live_in_uses) {
+      if (_is_live_in(_use->get()))
+        summary.live_in_uses.push_back(_use);
+    }
+    for (auto _use : _sub_summary.live_out_uses) {
+      if (!L->contains(cast<Instruction>(_use->getUser())))
+        summary.live_out_uses.push_back(_use);
+    }
   }
 
-  // 4)Extracting all the live-ins
   for (auto& bb : L->blocks()) {
+    if (LI.getLoopFor(bb) != L)
+      continue;
     for (auto& ins : *bb) {
       for (auto& op : ins.operands()) {
-        bool is_live_in = isa<Argument>(&*op);
-        if (auto _inst = dyn_cast<Instruction>(op))
-          is_live_in = !L->contains(_inst) ? true : false;
-
-        auto _intrinsic_op = CallSite(op);
-        if (_intrinsic_op.getInstruction()) {
-          auto _intrinsic_call =
-              dyn_cast<Function>(_intrinsic_op.getCalledValue()->stripPointerCasts());
-
-          if (_intrinsic_call) {
-            if (_intrinsic_call->isDeclaration()) {
-              is_live_in = false;
-            }
-          }
-        }
+        if (_is_live_in(op))
+          summary.live_in_uses.push_back(&op);
+      }
+      for (auto& _use : ins.uses()) {
+        if (!L->contains(cast<Instruction>(_use.getUser())))
+          summary.live_out_uses.push_back(&_use);
+      }
+    }
+  }
 
-        // If the value is live-in, we need to check if
-        // subloops contain the instruction or not (not the operand).
-        if (is_live_in) {
-          bool contain = false;
-          contain      = transform_reduce(
-              L->getSubLoopsVector().begin(),
-              L->getSubLoopsVector().end(),
-              false,
-              [](auto _l, auto _r) { return _l | _r; },
-              [&ins, &op, &summary](auto _sub_l) {
-                if (_sub_l->contains(&ins)) {
-                  summary.live_in_out_loop[op].insert(_sub_l);
-                  return true;
-                } else
-                  return false;
-              });
-
-          if (!contain) {
-            summary.live_in_out_ins[op].insert(&ins);
-          }
+  // Restoring the order of a full scan over the loop blocks, the order of the
+  // ports depends on it
+  std::sort(summary.live_in_uses.begin(),
+            summary.live_in_uses.end(),
+            [&_position](Use* _l, Use* _r) {
+              auto _l_ins = cast<Instruction>(_l->getUser());
+              auto _r_ins = cast<Instruction>(_r->getUser());
+              if (_l_ins != _r_ins)
+                return _position(_l_ins) < _position(_r_ins);
+              return _l->getOperandNo() < _r->getOperandNo();
+            });
+  // Uses of the same instruction keep their use list order
+  std::stable_sort(summary.live_out_uses.begin(),
+                   summary.live_out_uses.end(),
+                   [&_position](Use* _l, Use* _r) {
+                     return _position(cast<Instruction>(_l->get()))
+                            < _position(cast<Instruction>(_r->get()));
+                   });
 
-          if (L->getParentLoop()) {
-            if (!isa<llvm::Argument>(op)) {
-              if (L->getParentLoop()->contains(dyn_cast<llvm::Instruction>(op))) {
-                summary.live_in_in_ins.insert(op);
-              }
-            }
-          } else
-            summary.live_in_in_ins.insert(op);
+  // 4)Extracting all the live-ins
+  for (auto _use : summary.live_in_uses) {
+    Value* op = _use->get();
+    auto& ins = *cast<Instruction>(_use->getUser());
+
+    // If the value is live-in, we need to check if
+    // subloops contain the instruction or not (not the operand).
+    if (auto _sub_l = _get_sub_loop(&ins))
+      summary.live_in_out_loop[op].insert(_sub_l);
+    else
+      summary.live_in_out_ins[op].insert(&ins);
 
-          // Adding to data edge blacklist
-          blacklist_loop_live_in_data_edge[op].push_back(&ins);
+    if (L->getParentLoop()) {
+      if (!isa<llvm::Argument>(op)) {
+        if (L->getParentLoop()->contains(dyn_cast<llvm::Instruction>(op))) {
+          summary.live_in_in_ins.insert(op);
         }
       }
-    }
+    } else
+      summary.live_in_in_ins.insert(op);
+
+    // Adding to data edge blacklist
+    live_in_edges.set(value_numbering.getOperandIndex(*_use));
   }
 
   // Extracting loop live-outs
-  for (auto B : L->blocks()) {
-    for (auto& ins : *B) {
-      // Detecting Live-outs
-      for (auto user : ins.users()) {
-        bool is_live_out = false;
-        auto _inst_user  = dyn_cast<Instruction>(user);
-        is_live_out      = !L->contains(_inst_user) ? true : false;
-
-        if (is_live_out) {
-          // Add connections between loops
-          bool contain = false;
-          contain      = transform_reduce(
-              L->getSubLoopsVector().begin(),
-              L->getSubLoopsVector().end(),
-              false,
-              [](auto _l, auto _r) { return _l | _r; },
-              [&ins, &summary](auto _sub_l) {
-                if (_sub_l->contains(&ins)) {
-                  summary.live_out_in_loop[&ins].insert(_sub_l);
-                  return true;
-                } else
-                  return false;
-              });
-
-          if (!contain) {
-            summary.live_out_in_ins.insert(&ins);
-          }
+  for (auto _use : summary.live_out_uses) {
+    auto& ins        = *cast<Instruction>(_use->get());
+    auto _inst_user  = cast<Instruction>(_use->getUser());
 
-          // If current loop doesn't have a parent loop or the parent
-          // node contains the user then there is a edge from loop to
-          // the user instruction
-          auto _parent_loop = L->getParentLoop();
-          if (_parent_loop) {
-            if (_parent_loop->contains(_inst_user))
-              summary.live_out_out_ins[&ins].insert(_inst_user);
-            else
-              summary.live_out_out_loop[&ins].insert(_parent_loop);
-          } else
-            summary.live_out_out_ins[&ins].insert(_inst_user);
+    // Add connections between loops
+    if (auto _sub_l = _get_sub_loop(&ins))
+      summary.live_out_in_loop[&ins].insert(_sub_l);
+    else
+      summary.live_out_in_ins.insert(&ins);
+
+    // If current loop doesn't have a parent loop or the parent
+    // node contains the user then there is a edge from loop to
+    // the user instruction
+    auto _parent_loop = L->getParentLoop();
+    if (_parent_loop) {
+      if (_parent_loop->contains(_inst_user))
+        summary.live_out_out_ins[&ins].insert(_inst_user);
+      else
+        summary.live_out_out_loop[&ins].insert(_parent_loop);
+    } else
+      summary.live_out_out_ins[&ins].insert(_inst_user);
 
-          blacklist_loop_live_out_data_edge[&ins].push_back(dyn_cast<Instruction>(user));
-        }
+    live_out_edges.set(value_numbering.getOperandIndex(*_use));
+  }
+
+  // Checking for carry loop dependencies, a user inside L, but not inside its
+  // sub-loops, which comes before the instruction it uses. Only the first such
+  // user of each instruction is recorded.
+  SetVector<Instruction*> _carried;
+  for (auto& bb : L->blocks()) {
+    if (LI.getLoopFor(bb) != L)
+      continue;
+    for (auto& _user : *bb) {
+      for (auto& op : _user.operands()) {
+        auto _ins = dyn_cast<Instruction>(op);
+        if (_ins && L->contains(_ins) && _position(&_user) < _position(_ins))
+          _carried.insert(_ins);
       }
     }
   }
 
-  for (auto B : L->blocks()) {
-    for (auto& ins : *B) {
-      // Detecting Live-ins
-      for (auto user : ins.users()) {
-        // Checking for carry loop dependency
-        bool is_carry   = false;
-        bool fail       = false;
-        auto _inst_user = dyn_cast<Instruction>(user);
-
-        for (auto _p_B : L->blocks()) {
-          for (auto& _p_ins : *_p_B) {
-            if (&_p_ins == &ins) {
-              fail = true;
-              break;
-            }
-            if (&_p_ins == user) {
-              is_carry = true;
-              break;
-            }
-          }
-          if (fail || is_carry)
-            break;
-        }
+  for (auto _ins : _carried) {
+    for (auto _user : _ins->users()) {
+      auto _inst_user = dyn_cast<Instruction>(_user);
+      if (!_inst_user || LI.getLoopFor(_inst_user->getParent()) != L
+          || !(_position(_inst_user) < _position(_ins)))
+        continue;
 
-        if (is_carry) {
-          // Now we have to check if user instruction doesn't belong
-          // to the subloops
-          bool contain = transform_reduce(
-              L->getSubLoopsVector().begin(),
-              L->getSubLoopsVector().end(),
-              false,
-              [](auto _l, auto _r) { return _l | _r; },
-              [&_inst_user, &summary, L](auto _sub_l) {
-                return (_sub_l->contains(_inst_user));
-              });
-
-          if (!contain) {
-            DEBUG(ins.dump());
-            DEBUG(_inst_user->dump());
-            summary.carry_dependencies[&ins].push_back(_inst_user);
-            blacklist_carry_dependency_data_edge[&ins].push_back(
-                dyn_cast<Instruction>(user));
-            break;
-          }
-        }
+      DEBUG(_ins->dump());
+      DEBUG(_inst_user->dump());
+      summary.carry_dependencies[_ins].push_back(_inst_user);
+      for (auto& _op : _inst_user->operands()) {
+        if (_op.get() == _ins)
+          carry_edges.set(value_numbering.getOperandIndex(_op));
       }
+      break;
     }
   }
 
@@ -710,7 +783,10 @@ GraphGeneratorPass::visitGetElementPtrInst(llvm::GetElementPtrInst& I) {
 
 void
 GraphGeneratorPass::visitLoadInst(llvm::LoadInst& I) {
-  map_value_node[&I] = this->dependency_graph->insertLoadNode(I);
+  const auto& DL     = I.getModule()->getDataLayout();
+  auto _load_node    = this->dependency_graph->insertLoadNode(I);
+  map_value_node[&I] = _load_node;
+  cast<LoadNode>(_load_node)->setAccessSize(DL.getTypeStoreSize(I.getType()));
 }
 
 void
@@ -732,7 +808,11 @@ GraphGeneratorPass::visitBitCastInst(llvm::BitCastInst& I) {
 
 void
 GraphGeneratorPass::visitStoreInst(llvm::StoreInst& I) {
-  map_value_node[&I] = this->dependency_graph->insertStoreNode(I);
+  const auto& DL     = I.getModule()->getDataLayout();
+  auto _store_node   = this->dependency_graph->insertStoreNode(I);
+  map_value_node[&I] = _store_node;
+  cast<StoreNode>(_store_node)->setAccessSize(
+      DL.getTypeStoreSize(I.getValueOperand()->getType()));
 }
 
 void
@@ -798,7 +878,7 @@ GraphGeneratorPass::findDataPorts(Function& F) {
   for (auto _fun_arg_it = this->dependency_graph->funarg_begin();
        _fun_arg_it != this->dependency_graph->funarg_end();
        _fun_arg_it++) {
-    auto _fun_arg_node = dyn_cast<ArgumentNode>(_fun_arg_it->get());
+    auto _fun_arg_node = dyn_cast<ArgumentNode>(*_fun_arg_it);
     auto _spliter      = this->dependency_graph->getSplitCall();
 
     _spliter->addDataOutputPort(_fun_arg_node);
@@ -820,8 +900,10 @@ GraphGeneratorPass::findDataPorts(Function& F) {
       }
     }
 
-    auto _node_src =
-        this->map_value_node.find(&*ins_it);  // it should be Instruction node
+    // Constant operands add nodes to the table below, so the source node is read
+    // once here rather than holding an entry of the table
+    auto _node_src = this->map_value_node.lookup(&*ins_it);  // Instruction node
+    auto _edge_base = value_numbering.getOperandBase(&*ins_it);
 
     for (uint32_t c = 0; c < ins_it->getNumOperands(); ++c) {
       auto operand = ins_it->getOperand(c);
@@ -866,17 +948,17 @@ GraphGeneratorPass::findDataPorts(Function& F) {
         assert(isa<SuperNode>(_node_dest->second)
                && "Destination node should be super node!");
 
-        assert(isa<InstructionNode>(_node_src->second)
+        assert(isa<InstructionNode>(_node_src)
                && "Source node should be instruction node!");
 
         // We don't connect reattach node data dependency
-        if (isa<ReattachNode>(_node_src->second))
+        if (isa<ReattachNode>(_node_src))
           continue;
 
         auto _dst  = _node_dest->second;
         Node* _src = nullptr;
-        if (isa<BranchNode>(_node_src->second)) {
-          _src = dyn_cast<BranchNode>(_node_src->second);
+        if (isa<BranchNode>(_node_src)) {
+          _src = dyn_cast<BranchNode>(_node_src);
           if (ins_it->getNumOperands() == 3) {
             // LLVM IR -> CBranch(cmpInput(0), trueDst(1),
             // falseDst(2))
@@ -910,21 +992,21 @@ GraphGeneratorPass::findDataPorts(Function& F) {
           }
           _dst->addControlInputPortIndex(_src, _id);
 
-        } else if (isa<DetachNode>(_node_src->second)) {
+        } else if (isa<DetachNode>(_node_src)) {
           // TODO fix the Detachnode connections
-          _src = dyn_cast<DetachNode>(_node_src->second);
+          _src = dyn_cast<DetachNode>(_node_src);
           _src->addControlOutputPort(_dst, c);
           _dst->addControlInputPort(_src);
 
-        } else if (isa<ReattachNode>(_node_src->second)) {
+        } else if (isa<ReattachNode>(_node_src)) {
           // TODO fix the Reattachnode connections
-          _src = dyn_cast<ReattachNode>(_node_src->second);
+          _src = dyn_cast<ReattachNode>(_node_src);
           _src->addControlOutputPort(_dst, c);
           _dst->addControlInputPort(_src);
 
-        } else if (isa<SyncNode>(_node_src->second)) {
+        } else if (isa<SyncNode>(_node_src)) {
           // TODO fix the Sync node connections
-          _src = dyn_cast<SyncNode>(_node_src->second);
+          _src = dyn_cast<SyncNode>(_node_src);
           _src->addControlOutputPort(_dst, c);
           _dst->addControlInputPort(_src);
 
@@ -1027,92 +1109,46 @@ GraphGeneratorPass::findDataPorts(Function& F) {
         if (auto call_in = dyn_cast<CallNode>(_node_src->second))
           _src = call_in->getCallIn();
 
+        auto _edge_index = _edge_base + c;
+
         // Live in
-        bool find_live_in = false;
-        for (auto _data_src : blacklist_loop_live_in_data_edge) {
-          for (auto _data_edge : _data_src.getSecond()) {
-            if ((_data_src.getFirst() == operand) && (_data_edge == &*ins_it)) {
-              find_live_in = true;
-            }
-          }
-        }
-        if (find_live_in) {
-          for (auto _loop_edge : live_in_loop_ins_edge) {
-            auto _loop_node = this->loop_value_node[_loop_edge.getFirst()];
-
-            auto _edge = find_if(
-                _loop_edge.getSecond().begin(),
-                _loop_edge.getSecond().end(),
-                [operand, ins_it](auto _f_edge) {
-                  return ((_f_edge.first == operand) && (_f_edge.second == &*ins_it));
-                });
-
-            if (_edge != _loop_edge.getSecond().end()) {
-              auto _node_src = _loop_node->findLiveInNode(_edge->first);
-              auto _node_tar = this->map_value_node[_edge->second];
-
-              // TODO later we need to get ride of these lines
-              if (auto call_out = dyn_cast<CallNode>(_node_tar))
-                _node_tar = call_out->getCallOut();
-              if (auto call_in = dyn_cast<CallNode>(_node_src))
-                _node_src = call_in->getCallIn();
-
-              _node_src->addDataOutputPort(_node_tar);
-              _node_tar->addDataInputPort(_node_src);
-            }
-            //}
+        if (live_in_edges.test(_edge_index)) {
+          auto _loop_edge = live_in_edge_loop.find(_edge_index);
+          if (_loop_edge != live_in_edge_loop.end()) {
+            auto _node_live_in =
+                this->loop_value_node[_loop_edge->second]->findLiveInNode(operand);
+
+            // TODO later we need to get ride of these lines
+            if (auto call_in = dyn_cast<CallNode>(_node_live_in))
+              _node_live_in = call_in->getCallIn();
+
+            _node_live_in->addDataOutputPort(_dst);
+            _dst->addDataInputPort(_node_live_in);
           }
 
           continue;
         }
 
         // Live out
-        bool find_live_out = false;
-        for (auto _data_src : blacklist_loop_live_out_data_edge) {
-          for (auto _data_edge : _data_src.getSecond()) {
-            if ((_data_src.getFirst() == operand) && (_data_edge == &*ins_it)) {
-              find_live_out = true;
-            }
-          }
-        }
-        if (find_live_out) {
-          for (auto _loop_edge : live_out_loop_ins_edge) {
-            auto _loop_node = this->loop_value_node[_loop_edge.getFirst()];
-
-            auto _edge = find_if(
-                _loop_edge.getSecond().begin(),
-                _loop_edge.getSecond().end(),
-                [operand, ins_it](auto _f_edge) {
-                  return ((_f_edge.first == operand) && (_f_edge.second == &*ins_it));
-                });
-
-            if (_edge != _loop_edge.getSecond().end()) {
-              auto _node_src = _loop_node->findLiveOutNode(_edge->first);
-              auto _node_tar = this->map_value_node[_edge->second];
-
-              if (auto call_out = dyn_cast<CallNode>(_node_tar))
-                _node_tar = call_out->getCallOut();
-              if (auto call_in = dyn_cast<CallNode>(_node_src))
-                _node_src = call_in->getCallIn();
-
-              _node_src->addDataOutputPort(_node_tar);
-              _node_tar->addDataInputPort(_node_src);
-            }
+        if (live_out_edges.test(_edge_index)) {
+          auto _loop_edge = live_out_edge_loop.find(_edge_index);
+          if (_loop_edge != live_out_edge_loop.end()) {
+            auto _node_live_out =
+                this->loop_value_node[_loop_edge->second]->findLiveOutNode(operand);
+
+            if (auto call_in = dyn_cast<CallNode>(_node_live_out))
+              _node_live_out = call_in->getCallIn();
+
+            _node_live_out->addDataOutputPort(_dst);
+            _dst->addDataInputPort(_node_live_out);
           }
 
           continue;
         }
 
         // carry dependencies
-        bool find_carry = false;
-        for (auto _data_src : blacklist_carry_dependency_data_edge) {
-          for (auto _data_edge : _data_src.getSecond()) {
-            if ((_data_src.getFirst() == operand) && (_data_edge == &*ins_it))
-              find_carry = true;
-          }
-        }
-        if (find_carry) {
-          auto _carry = loop_edge_map[std::make_pair(operand, &*ins_it)];
+        if (carry_edges.test(_edge_index)) {
+          auto _carry = carry_edge_node[_edge_index];
 
           _src->addDataOutputPort(_carry);
           _carry->addDataInputPort(_src);
@@ -1156,62 +1192,49 @@ GraphGeneratorPass::findDataPorts(Function& F) {
       }
     }
 
-    // Connecting Load and Store nodes to Memory system
-    // TODO: We need to decide how to connect the memory nodes
-    // to the memory system
+    // Connecting Load and Store nodes to Memory system, the operations on
+    // an alloca use its scratchpad and the rest go to their memory unit
     auto node_inst = this->map_value_node.find(&*ins_it);
     if (node_inst->second == nullptr)
       continue;
     if (auto _ld_node = dyn_cast<LoadNode>(node_inst->second)) {
-      // TODO right now we consider all the connections to the cache
-      // or
-      // regfile
-      // We need a pass to trace the pointers
-      auto load_inst = dyn_cast<LoadInst>(&*ins_it);
-      if (auto gep_inst = dyn_cast<GetElementPtrInst>(load_inst->getPointerOperand())) {
-        if (auto alloca = dyn_cast<AllocaInst>(gep_inst->getPointerOperand())) {
-          auto scratchpad_mem = this->dependency_graph->returnScratchpadMem(alloca);
-          scratchpad_mem->addReadMemoryReqPort(_ld_node);
-          scratchpad_mem->addReadMemoryRespPort(_ld_node);
-          _ld_node->addReadMemoryReqPort(scratchpad_mem);
-          _ld_node->addReadMemoryRespPort(scratchpad_mem);
-        } else {
-          this->dependency_graph->getMemoryUnit()->addReadMemoryReqPort(_ld_node);
-          this->dependency_graph->getMemoryUnit()->addReadMemoryRespPort(_ld_node);
-          _ld_node->addReadMemoryReqPort(this->dependency_graph->getMemoryUnit());
-          _ld_node->addReadMemoryRespPort(this->dependency_graph->getMemoryUnit());
-        }
+      auto _scratchpad = this->returnScratchpadMem(&*ins_it);
+      if (_scratchpad) {
+        _scratchpad->addReadMemoryReqPort(_ld_node);
+        _scratchpad->addReadMemoryRespPort(_ld_node);
+        _ld_node->addReadMemoryReqPort(_scratchpad);
+        _ld_node->addReadMemoryRespPort(_scratchpad);
       } else {
-        this->dependency_graph->getMemoryUnit()->addReadMemoryReqPort(_ld_node);
-        this->dependency_graph->getMemoryUnit()->addReadMemoryRespPort(_ld_node);
-        _ld_node->addReadMemoryReqPort(this->dependency_graph->getMemoryUnit());
-        _ld_node->addReadMemoryRespPort(this->dependency_graph->getMemoryUnit());
+        auto _mem_unit = this->returnMemoryUnit(&*ins_it);
+        _mem_unit->addReadMemoryReqPort(_ld_node);
+        _mem_unit->addReadMemoryRespPort(_ld_node);
+        _ld_node->addReadMemoryReqPort(_mem_unit);
+        _ld_node->addReadMemoryRespPort(_mem_unit);
+        _ld_node->setMemoryUnit(_mem_unit);
       }
+      if (auto _stream = this->returnStream(&*ins_it))
+        _ld_node->setStream(_stream->stride, _stream->trip_count);
     }
 
     // Store node connection
     //
     else if (auto _st_node = dyn_cast<StoreNode>(node_inst->second)) {
-      auto store_inst = dyn_cast<StoreInst>(&*ins_it);
-      if (auto gep_inst = dyn_cast<GetElementPtrInst>(store_inst->getPointerOperand())) {
-        if (auto alloca = dyn_cast<AllocaInst>(gep_inst->getPointerOperand())) {
-          auto scratchpad_mem = this->dependency_graph->returnScratchpadMem(alloca);
-          scratchpad_mem->addWriteMemoryReqPort(_st_node);
-          scratchpad_mem->addWriteMemoryRespPort(_st_node);
-          _st_node->addWriteMemoryReqPort(scratchpad_mem);
-          _st_node->addWriteMemoryRespPort(scratchpad_mem);
-        } else {
-          this->dependency_graph->getMemoryUnit()->addWriteMemoryReqPort(_st_node);
-          this->dependency_graph->getMemoryUnit()->addWriteMemoryRespPort(_st_node);
-          _st_node->addWriteMemoryReqPort(this->dependency_graph->getMemoryUnit());
-          _st_node->addWriteMemoryRespPort(this->dependency_graph->getMemoryUnit());
-        }
+      auto _scratchpad = this->returnScratchpadMem(&*ins_it);
+      if (_scratchpad) {
+        _scratchpad->addWriteMemoryReqPort(_st_node);
+        _scratchpad->addWriteMemoryRespPort(_st_node);
+        _st_node->addWriteMemoryReqPort(_scratchpad);
+        _st_node->addWriteMemoryRespPort(_scratchpad);
       } else {
-        this->dependency_graph->getMemoryUnit()->addWriteMemoryReqPort(_st_node);
-        this->dependency_graph->getMemoryUnit()->addWriteMemoryRespPort(_st_node);
-        _st_node->addWriteMemoryReqPort(this->dependency_graph->getMemoryUnit());
-        _st_node->addWriteMemoryRespPort(this->dependency_graph->getMemoryUnit());
+        auto _mem_unit = this->returnMemoryUnit(&*ins_it);
+        _mem_unit->addWriteMemoryReqPort(_st_node);
+        _mem_unit->addWriteMemoryRespPort(_st_node);
+        _st_node->addWriteMemoryReqPort(_mem_unit);
+        _st_node->addWriteMemoryRespPort(_mem_unit);
+        _st_node->setMemoryUnit(_mem_unit);
       }
+      if (auto _stream = this->returnStream(&*ins_it))
+        _st_node->setStream(_stream->stride, _stream->trip_count);
     }
 
     // Alloca node connection to the stack allocator
@@ -1373,14 +1396,12 @@ GraphGeneratorPass::updateLoopDependencies(llvm::LoopInfo& loop_info) {
                    std::back_inserter(_list_exit),
                    [](auto _l_e) -> SuperNode* { return _l_e.second; });
 
-    auto _new_loop =
-        std::make_unique<LoopNode>(NodeInfo(c, "Loop_" + std::to_string(c)),
-                                   dyn_cast<SuperNode>(map_value_node[L->getHeader()]),
-                                   dyn_cast<SuperNode>(map_value_node[L->getLoopLatch()]),
-                                   _list_exit);
-
     // Insert loop node
-    auto _loop_node = this->dependency_graph->insertLoopNode(std::move(_new_loop));
+    auto _loop_node = this->dependency_graph->insertLoopNode(
+        NodeInfo(c, "Loop_" + std::to_string(c)),
+        dyn_cast<SuperNode>(map_value_node[L->getHeader()]),
+        dyn_cast<SuperNode>(map_value_node[L->getLoopLatch()]),
+        _list_exit);
 
     loop_value_node[&*L] = _loop_node;
 
@@ -1566,6 +1587,55 @@ GraphGeneratorPass::connectingCalldependencies(Function& F) {
   }
 }
 
+/**
+ * Scratchpad of a load or store, nullptr if the operation doesn't access
+ * an alloca
+ */
+ScratchpadNode*
+GraphGeneratorPass::returnScratchpadMem(Instruction* _ins) {
+  Value* _ptr = isa<LoadInst>(_ins) ? cast<LoadInst>(_ins)->getPointerOperand()
+                                    : cast<StoreInst>(_ins)->getPointerOperand();
+  if (auto _gep = dyn_cast<GetElementPtrInst>(_ptr)) {
+    if (auto _alloca = dyn_cast<AllocaInst>(_gep->getPointerOperand()))
+      return this->dependency_graph->returnScratchpadMem(_alloca);
+  }
+
+  if (memory_partition) {
+    auto _obj = memory_partition->objects.find(_ins);
+    if (_obj != memory_partition->objects.end()) {
+      if (auto _alloca = dyn_cast<AllocaInst>(_obj->second))
+        return this->dependency_graph->returnScratchpadMem(_alloca);
+    }
+  }
+  return nullptr;
+}
+
+/**
+ * Memory unit of a load or store, the operations which are not banked use
+ * the shared unit
+ */
+MemoryNode*
+GraphGeneratorPass::returnMemoryUnit(Instruction* _ins) {
+  if (memory_partition) {
+    auto _obj = memory_partition->objects.find(_ins);
+    if (_obj != memory_partition->objects.end())
+      return this->dependency_graph->getMemoryUnit(_obj->second);
+  }
+  return this->dependency_graph->getMemoryUnit();
+}
+
+/**
+ * Stream of a load or store, nullptr if the operation issues a request for
+ * each access. The strides are in bytes, they only match the addresses of the
+ * packed memory layout.
+ */
+const helpers::StreamInfo*
+GraphGeneratorPass::returnStream(Instruction* _ins) {
+  if (!memory_streams || !packedMemory)
+    return nullptr;
+  return memory_streams->getStream(_ins);
+}
+
 /**
  * There is a limitation in forming the graph at this moment
  * this function makes sure, all the store's routeIDs are
@@ -1573,18 +1643,19 @@ GraphGeneratorPass::connectingCalldependencies(Function& F) {
  */
 void
 GraphGeneratorPass::updateRouteIDs(Function& F) {
-  auto cache   = this->dependency_graph->getMemoryUnit();
-  uint32_t cnt = 0;
   DEBUG(dbgs() << "Enter route id update\n");
-  DEBUG(dbgs() << "Cache input: " << cache->numReadMemReqPort() << "\n");
-  for (auto load_mem : cache->read_req_range()) {
-    dyn_cast<LoadNode>(load_mem.first)->setRouteID(cnt);
-    cnt++;
-    DEBUG(dbgs() << load_mem.first->getName() << "\n");
-  }
-  for (auto store_mem : cache->write_req_range()) {
-    dyn_cast<StoreNode>(store_mem.first)->setRouteID(cnt);
-    cnt++;
+  for (auto cache : this->dependency_graph->getMemoryUnits()) {
+    uint32_t cnt = 0;
+    DEBUG(dbgs() << "Cache input: " << cache->numReadMemReqPort() << "\n");
+    for (auto load_mem : cache->read_req_range()) {
+      dyn_cast<LoadNode>(load_mem.first)->setRouteID(cnt);
+      cnt++;
+      DEBUG(dbgs() << load_mem.first->getName() << "\n");
+    }
+    for (auto store_mem : cache->write_req_range()) {
+      dyn_cast<StoreNode>(store_mem.first)->setRouteID(cnt);
+      cnt++;
+    }
   }
 
   for (auto& mem : this->dependency_graph->scratchpads()) {
@@ -1600,23 +1671,109 @@ GraphGeneratorPass::updateRouteIDs(Function& F) {
   }
 }
 
-// void GraphGeneratorPass::connectingAliasEdges(Function &F) {
-// auto alias_context = &getAnalysis<aew::AliasEdgeWriter>();
+/**
+ * Seeding the data width of the integer nodes with what LLVM knows about their
+ * values, the known zero bits and the unsigned range scalar evolution gives,
+ * which is bounded by the trip counts of the loops. Only the values known to
+ * be non-negative get a width, the graph narrows them further.
+ */
+void
+GraphGeneratorPass::annotateDataWidths(Function& F) {
+  auto& DL = F.getParent()->getDataLayout();
+  for (auto& I : instructions(F)) {
+    if (!I.getType()->isIntegerTy())
+      continue;
+    auto _node = map_value_node.find(&I);
+    if (_node == map_value_node.end())
+      continue;
+
+    uint32_t _bits = I.getType()->getIntegerBitWidth();
+    KnownBits _known(_bits);
+    computeKnownBits(&I, _known, DL, 0, nullptr, &I);
+    uint32_t _width = _bits - _known.countMinLeadingZeros();
+    if (SE->isSCEVable(I.getType())) {
+      auto _range = SE->getUnsignedRange(SE->getSCEV(&I));
+      _width      = std::min(_width, _range.getUnsignedMax().getActiveBits());
+    }
+
+    // A negative value needs all its bits
+    if (_width >= _bits && _bits > 1)
+      continue;
+    _node->second->setDataWidth(std::max(_width, 1U));
+  }
+}
+
+/**
+ * Ordering the memory operations of a basic block which alias analysis can't
+ * separate, the later operation waits for the earlier one. Loads and the
+ * operations on independent locations stay unordered and can issue in
+ * parallel.
+ * Operations of different blocks are ordered through their block branch. A
+ * store waits on it unless storeNeedsBranch releases it, a load only does if
+ * it aliases a store of another block, otherwise the next block could
+ * overwrite the location before the load has read it.
+ */
+void
+GraphGeneratorPass::connectingAliasEdges(Function& F) {
+  auto _alias_context = getAnalysisIfAvailable<aew::AliasEdgeWriter>();
+  if (!_alias_context)
+    return;
+
+  SmallPtrSet<Instruction*, 16> _held_loads;
+  auto _hold_branch = [this, &_held_loads](Instruction* _load) {
+    if (!_held_loads.insert(_load).second)
+      return;
+    auto _load_node = map_value_node.lookup(_load);
+    auto _br_node   = map_value_node.lookup(_load->getParent()->getTerminator());
+    if (!_load_node || !_br_node)
+      return;
+    _load_node->addControlOutputPort(_br_node);
+    _br_node->addControlInputPort(_load_node);
+  };
+
+  for (auto& BB : F) {
+    for (auto& I : BB) {
+      auto _edges = _alias_context->AliasEdgesMap.find(&I);
+      if (_edges == _alias_context->AliasEdgesMap.end())
+        continue;
+
+      for (auto _alias_ins : _edges->second) {
+        if (_alias_ins->getParent() != &BB) {
+          if (isa<LoadInst>(I) && isa<StoreInst>(_alias_ins))
+            _hold_branch(&I);
+          else if (isa<StoreInst>(I) && isa<LoadInst>(_alias_ins))
+            _hold_branch(_alias_ins);
+          continue;
+        }
+
+        // A data dependency already orders them
+        if (is_contained(_alias_ins->operands(), &I))
+          continue;
+
+        auto _src = map_value_node.lookup(&I);
+        auto _dst = map_value_node.lookup(_alias_ins);
+        if (!_src || !_dst)
+          continue;
+        _src->addControlOutputPort(_dst);
+        _dst->addControlInputPort(_src);
+      }
+    }
+  }
+}
 
 void
 GraphGeneratorPass::buildLoopNodes(Function& F, llvm::LoopInfo& loop_info) {
   uint32_t c_id = 0;
   for (auto& L : getLoops(loop_info)) {
-    auto _new_loop =
-        std::make_unique<LoopNode>(NodeInfo(c_id, "Loop_" + std::to_string(c_id)));
-    c_id++;
-
     // Insert loop node
-    auto _loop_node = this->dependency_graph->insertLoopNode(std::move(_new_loop));
+    auto _loop_node = this->dependency_graph->insertLoopNode(
+        NodeInfo(c_id, "Loop_" + std::to_string(c_id)));
+    c_id++;
 
     if (L->getCanonicalInductionVariable())
       _loop_node->setIndeuctionVariable(
           dyn_cast<InstructionNode>(map_value_node[L->getCanonicalInductionVariable()]));
+    _loop_node->setTripCount(SE->getSmallConstantMaxTripCount(L));
 
     for (auto& bb : L->blocks()) {
       _loop_node->pushSuperNode(dyn_cast<SuperNode>(map_value_node[bb]));
@@ -1723,7 +1880,10 @@ GraphGeneratorPass::buildLoopNodes(Function& F, llvm::LoopInfo& loop_info) {
     // Edge type 3
     for (auto _src : summary.live_in_out_ins) {
       for (auto _tar : _src.getSecond()) {
-        live_in_loop_ins_edge[L].insert(std::make_pair(_src.getFirst(), _tar));
+        for (auto& _op : _tar->operands()) {
+          if (_op.get() == _src.getFirst())
+            live_in_edge_loop[value_numbering.getOperandIndex(_op)] = L;
+        }
       }
     }
 
@@ -1756,15 +1916,16 @@ GraphGeneratorPass::buildLoopNodes(Function& F, llvm::LoopInfo& loop_info) {
           this->loop_value_node[_n]->insertLiveOutArgument(_live_out.getFirst(),
                                                            ArgumentNode::LoopLiveOut);
         }
-        loop_loop_edge_lout_map[_live_out.getFirst()].push_back(std::make_pair(L, _n));
       }
     }
 
     // Edge type 3
     for (auto _live_out_edge : summary.live_out_out_ins) {
       for (auto _inst : _live_out_edge.getSecond()) {
-        live_out_loop_ins_edge[L].insert(
-            std::make_pair(_live_out_edge.getFirst(), _inst));
+        for (auto& _op : _inst->operands()) {
+          if (_op.get() == _live_out_edge.getFirst())
+            live_out_edge_loop[value_numbering.getOperandIndex(_op)] = L;
+        }
       }
     }
 
@@ -1775,7 +1936,10 @@ GraphGeneratorPass::buildLoopNodes(Function& F, llvm::LoopInfo& loop_info) {
                                                map_value_node[_carry_depen.getFirst()],
                                                ArgumentNode::CarryDependency);
       for (auto _use : _carry_depen.getSecond()) {
-        loop_edge_map[std::make_pair(_carry_depen.getFirst(), _use)] = new_carry_depen;
+        for (auto& _op : _use->operands()) {
+          if (_op.get() == _carry_depen.getFirst())
+            carry_edge_node[value_numbering.getOperandIndex(_op)] = new_carry_depen;
+        }
       }
     }
   }
@@ -1833,29 +1997,81 @@ GraphGeneratorPass::connectLoopEdge() {
       _node_dest->addDataInputPort(_node_src);
     }
   }
+}
 
-  for (auto _edge : live_out_loop_loop_edge) {
-    for (auto _loop_edge : _edge.second) {
-      auto _node_src =
-          this->loop_value_node[_loop_edge.first]->findLiveOutNode(_edge.first);
-      auto _node_tar =
-          this->loop_value_node[_loop_edge.second]->findLiveOutNode(_edge.first);
-
-      _node_src->addDataOutputPort(_node_tar);
-      _node_tar->addDataInputPort(_node_src);
+/**
+ * Returns the stores alias analysis can't release from the branch of their
+ * block, all of them without alias information. A store is released if it
+ * only aliases the later operations of its own block, which wait on it
+ * through the alias edges already. The edges of the alias maps go from the
+ * earlier operation of a block to the later one, so the store must not be
+ * the target of any edge and none of the targets it has may be in another
+ * block, the operations of the other blocks and of the next iteration of a
+ * loop are only ordered through the branch. The stores of a function or of an
+ * operation alias analysis didn't see, the stores of a block that calls a
+ * function or doesn't end with a branch, such as a return, and the store
+ * streams always hold the branch.
+ */
+SmallPtrSet<Instruction*, 16>
+GraphGeneratorPass::findHeldStores(Function& F) {
+  SmallPtrSet<Instruction*, 16> _held;
+  auto _alias_context = getAnalysisIfAvailable<aew::AliasEdgeWriter>();
+  if (_alias_context && !_alias_context->AnalyzedFunctions.count(&F))
+    _alias_context = nullptr;
+
+  auto _is_call = [](Instruction& I) {
+    return isa<CallInst>(I) && !isa<IntrinsicInst>(I);
+  };
+  for (auto& BB : F) {
+    bool _hold_all = !_alias_context || !isa<BranchInst>(BB.getTerminator())
+                     || any_of(BB, _is_call);
+    for (auto& I : BB) {
+      if (!isa<StoreInst>(I))
+        continue;
+      if (_hold_all || !I.getMetadata("UID") || I.getMetadata("LO") || returnStream(&I))
+        _held.insert(&I);
+    }
+  }
+  if (!_alias_context)
+    return _held;
+
+  for (auto& _edges : _alias_context->AliasEdgesMap) {
+    auto _src = _edges.first;
+    for (auto _dst : _edges.second) {
+      if (isa<StoreInst>(_dst) && _dst->getFunction() == &F)
+        _held.insert(_dst);
+      if (isa<StoreInst>(_src) && _src->getFunction() == &F
+          && _dst->getParent() != _src->getParent())
+        _held.insert(_src);
     }
   }
+  return _held;
 }
 
+/**
+ * Stores hold the branch of their block unless findHeldStores releases them.
+ * A store stream also holds the exiting branch of its loop, the stream
+ * acknowledges its last element only once its FIFO is written back, so the
+ * loop can't exit with data in flight.
+ */
 void
 GraphGeneratorPass::connectingStoreToBranch(Function& F) {
+  auto _held = findHeldStores(F);
   for (auto& BB : F) {
     for (auto& I : BB) {
-      if (isa<llvm::StoreInst>(I)) {
+      if (isa<llvm::StoreInst>(I) && _held.count(&I)) {
         auto _store_node = map_value_node[&I];
         auto _br_inst    = --I.getParent()->getInstList().end();
         _store_node->addControlOutputPort(map_value_node[&*_br_inst]);
         map_value_node[&*_br_inst]->addControlInputPort(_store_node);
+
+        // Streams only run in loops whose latch is the exiting block
+        auto _latch = returnStream(&I) ? LI->getLoopFor(&BB)->getLoopLatch() : nullptr;
+        if (_latch && _latch != &BB) {
+          auto _exit_br = map_value_node[_latch->getTerminator()];
+          _store_node->addControlOutputPort(_exit_br);
+          _exit_br->addControlInputPort(_store_node);
+        }
       }
     }
   }
@@ -1866,74 +2082,145 @@ GraphGeneratorPass::connectingStoreToBranch(Function& F) {
  */
 void
 GraphGeneratorPass::init(Function& F) {
+  auto _name = F.getName();
+
   // Running analysis on the elements
-  buildLoopNodes(F, *LI);
-  connectLoopEdge();
+  stats::runStage(_name, "buildLoopNodes", [&] { buildLoopNodes(F, *LI); });
+  stats::runStage(_name, "connectLoopEdge", [&] { connectLoopEdge(); });
   // findControlPorts(F);
-  findDataPorts(F);
-  fillBasicBlockDependencies(F);
+  stats::runStage(_name, "findDataPorts", [&] { findDataPorts(F); });
+  stats::runStage(
+      _name, "fillBasicBlockDependencies", [&] { fillBasicBlockDependencies(F); });
   // updateLoopDependencies(*LI);
-  connectOutToReturn(F);
-  connectParalleNodes(F);
-  connectingCalldependencies(F);
-  connectingStoreToBranch(F);
-  // connectingAliasEdges(F);
+  stats::runStage(_name, "connectOutToReturn", [&] { connectOutToReturn(F); });
+  stats::runStage(_name, "connectParalleNodes", [&] { connectParalleNodes(F); });
+  stats::runStage(
+      _name, "connectingCalldependencies", [&] { connectingCalldependencies(F); });
+  stats::runStage(_name, "connectingStoreToBranch", [&] { connectingStoreToBranch(F); });
+  stats::runStage(_name, "connectingAliasEdges", [&] { connectingAliasEdges(F); });
+  stats::runStage(_name, "annotateDataWidths", [&] { annotateDataWidths(F); });
 
   // Printing the graph
-  dependency_graph->optimizationPasses();
-  updateRouteIDs(F);
+  stats::runStage(
+      _name, "optimizationPasses", [&] { dependency_graph->optimizationPasses(); });
+  stats::runStage(_name, "updateRouteIDs", [&] { updateRouteIDs(F); });
   dependency_graph->printGraph(PrintType::Scala, config_path);
 
   // Printing muIR graph summary
   if (this->dump_muir) {
-    dependency_graph->printMUIR();
+    if (this->muir_binary)
+      stats::runStage(
+          _name, "printMUIRBinary", [&] { dependency_graph->printMUIRBinary(); });
+    else
+      stats::runStage(_name, "printMUIR", [&] { dependency_graph->printMUIR(); });
   }
+
+  dependency_graph->collectStats();
 }
 
-bool
-GraphGeneratorPass::runOnModule(Module& M) {
-  for (auto& F : M) {
-    if (F.isDeclaration())
-      continue;
-    if (F.getName() == this->dependency_graph->graph_info.Name) {
-      // Iterating over loops, and extracting loops information
-      // before running anyother analysis
-      auto& LI   = getAnalysis<LoopInfoWrapperPass>(F).getLoopInfo();
-      auto loops = getLoops(LI);
-
-      bool hasLoop = (loops.size() > 0);
-      do {
-        if (loops.size() == loop_sum.size())
-          break;
-
-        for (auto& L : loops) {
-          if (L->getSubLoops().size() == 0 || loop_sum.count(L) == 0) {
-            this->loop_sum.insert(std::make_pair(L, summarizeLoop(L, LI)));
-          }
-        }
+/**
+ * Dropping the state of the previous function and starting a new graph
+ */
+void
+GraphGeneratorPass::resetGraph(NodeInfo _n_info, raw_ostream& out) {
+  dependency_graph = std::make_unique<Graph>(_n_info, out);
+
+  loop_sum.clear();
+  blacklist_control_edge.clear();
+  value_numbering.clear();
+  live_in_edges.clear();
+  live_out_edges.clear();
+  carry_edges.clear();
+  live_in_edge_loop.clear();
+  live_out_edge_loop.clear();
+  carry_edge_node.clear();
+  live_in_ins_loop_edge.clear();
+  live_in_loop_loop_edge.clear();
+  live_out_ins_loop_edge.clear();
+  map_value_node.clear();
+  loop_value_node.clear();
+  memory_buffer_map.clear();
+  memory_partition = nullptr;
+  memory_streams   = nullptr;
+
+  LID = 0;
+}
+
+/**
+ * Building and printing the graph of a single function
+ */
+void
+GraphGeneratorPass::buildGraph(Function& F) {
+  // Iterating over loops, and extracting loops information
+  // before running anyother analysis
+  auto& LI   = getAnalysis<LoopInfoWrapperPass>(F).getLoopInfo();
+  auto loops = getLoops(LI);
+  this->LI   = &LI;
+  this->SE   = &getAnalysis<ScalarEvolutionWrapperPass>(F).getSE();
+
+  // Data edges crossing the loop boundaries are kept per operand slot
+  value_numbering.number(F);
+  live_in_edges.resize(value_numbering.getNumOperands());
+  live_out_edges.resize(value_numbering.getNumOperands());
+  carry_edges.resize(value_numbering.getNumOperands());
+
+  // Banks are created before any memory operation is connected, so they are
+  // numbered in the same order as the partition
+  memory_partition = nullptr;
+  if (auto _banking = getAnalysisIfAvailable<helpers::MemoryBanking>())
+    memory_partition = _banking->getPartition(&F);
+  if (memory_partition) {
+    for (auto _obj : memory_partition->banks)
+      dependency_graph->createMemoryBank(_obj);
+  }
+  memory_streams = getAnalysisIfAvailable<helpers::MemoryStreams>();
 
-      } while (hasLoop);
+  // getLoops returns the loops in post-order, each summary is built once from
+  // the summaries of its sub-loops
+  for (auto& L : loops) {
+    stats::StageTimer _timer(F.getName(), "summarizeLoop");
+    this->loop_sum.insert(std::make_pair(L, summarizeLoop(L, LI)));
+  }
 
-      visit(F);
+  stats::runStage(F.getName(), "visit", [&] { visit(F); });
 
 
-      // Injecting debug infos
-      auto& debug_info_pass = getAnalysis<debuginfo::DebugInfo>();
-      for (auto& bb : F) {
-        for (auto& ins : bb) {
-          auto inst_node_find = map_value_node.find(&ins);
-          if (inst_node_find != map_value_node.end()) {
-            auto inst_node = dyn_cast<InstructionNode>(inst_node_find->second);
-            for (auto val : debug_info_pass.node_operands[&ins]) {
-              inst_node->debug_parent_node.push_back(val);
-            }
-          }
-        }
+  // Injecting debug infos
+  auto& debug_info_pass = getAnalysis<debuginfo::DebugInfo>();
+  for (auto& bb : F) {
+    for (auto& ins : bb) {
+      auto inst_node_find = map_value_node.find(&ins);
+      if (inst_node_find != map_value_node.end()) {
+        auto inst_node = dyn_cast<InstructionNode>(inst_node_find->second);
+        auto _parents  = debug_info_pass.getNodeOperands(&ins);
+        inst_node->debug_parent_node.assign(_parents.begin(), _parents.end());
       }
+    }
+  }
 
 
-      init(F);
+  init(F);
+}
+
+bool
+GraphGeneratorPass::runOnModule(Module& M) {
+  for (auto& F : M) {
+    if (F.isDeclaration())
+      continue;
+
+    if (targets.empty()) {
+      if (F.getName() == this->dependency_graph->graph_info.Name)
+        buildGraph(F);
+      continue;
     }
+
+    // The analysis results are shared by all the target functions
+    auto _target = targets.find(F.getName().str());
+    if (_target == targets.end())
+      continue;
+
+    resetGraph(NodeInfo(0, F.getName().str()), *_target->second);
+    buildGraph(F);
   }
 
 
@@ -0,0 +1,602 @@
+#define DEBUG_TYPE "graphgen"
+
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include "Dandelion/Graph.h"
+#include "Dandelion/GraphPasses.h"
+#include "Dandelion/Node.h"
+
+#include <algorithm>
+#include <functional>
+#include <unordered_set>
+#include <vector>
+
+using namespace llvm;
+using namespace dandelion;
+
+//===----------------------------------------------------------------------===//
+//                          BitwidthAnalysis
+//===----------------------------------------------------------------------===//
+
+char passes::BitwidthAnalysis::ID = 0;
+
+/**
+ * Bits of the value a node outputs, XLEN if nothing narrower is known. A
+ * compare outputs a single bit whatever width it compares with.
+ */
+static uint32_t
+getValueWidth(Node* _node, const passes::BitwidthAnalysis::Result& _widths) {
+  if (isa<IcmpNode>(_node))
+    return 1;
+  if (auto _const = dyn_cast<ConstIntNode>(_node))
+    return _const->getValue() < 0 ? XLEN : std::max(Log2_32(_const->getValue()) + 1, 1U);
+  auto _width = _widths.find(_node);
+  return _width == _widths.end() ? XLEN : _width->second;
+}
+
+/**
+ * Widths of the data inputs of an instruction node, empty if one of the
+ * operands of its instruction doesn't have a port
+ */
+static std::vector<uint32_t>
+getOperandWidths(InstructionNode* _node,
+                 const passes::BitwidthAnalysis::Result& _widths) {
+  std::vector<uint32_t> _ops;
+  for (auto& _port : _node->input_data_range())
+    _ops.push_back(getValueWidth(_port.first, _widths));
+  auto _ins = _node->getInstruction();
+  if (!isa<PHINode>(_ins) && _ops.size() < _ins->getNumOperands())
+    _ops.clear();
+  return _ops;
+}
+
+/**
+ * Width the value of an instruction node can take given the widths of its
+ * operands, or zero if the node isn't an integer operation. Shifts right,
+ * divisions and remainders keep their value within the one of their operands,
+ * the signed ones only if their operands are non-negative, that is narrower
+ * than their type.
+ */
+static uint32_t
+getResultWidth(InstructionNode* _node, const passes::BitwidthAnalysis::Result& _widths) {
+  auto _ins = _node->getInstruction();
+  if (!_ins || !_ins->getType()->isIntegerTy() || isa<ICmpInst>(_ins))
+    return 0;
+
+  auto _ops = getOperandWidths(_node, _widths);
+  if (_ops.empty())
+    return XLEN;
+  auto _max_op = *std::max_element(_ops.begin(), _ops.end());
+  bool _non_negative = _max_op < _ins->getType()->getIntegerBitWidth();
+
+  uint32_t _width = XLEN;
+  switch (_ins->getOpcode()) {
+    case Instruction::Add: _width = std::max(_ops[0], _ops[1]) + 1; break;
+    case Instruction::Sub: break;
+    case Instruction::Mul: _width = _ops[0] + _ops[1]; break;
+    case Instruction::And: _width = std::min(_ops[0], _ops[1]); break;
+    case Instruction::Or:
+    case Instruction::Xor: _width = _max_op; break;
+    case Instruction::Shl:
+      if (auto _amount = dyn_cast<ConstantInt>(_ins->getOperand(1)))
+        _width = _ops[0] + _amount->getLimitedValue(XLEN);
+      break;
+    case Instruction::Select: _width = std::max(_ops[1], _ops[2]); break;
+    case Instruction::PHI: _width = _max_op; break;
+    // Extensions and truncations only keep the bits of non-negative values
+    case Instruction::ZExt: _width = _ops[0]; break;
+    case Instruction::SExt:
+    case Instruction::Trunc:
+      if (_ops[0] < std::min(_ins->getType()->getIntegerBitWidth(),
+                             _ins->getOperand(0)->getType()->getIntegerBitWidth()))
+        _width = _ops[0];
+      break;
+    case Instruction::LShr:
+    case Instruction::UDiv: _width = _ops[0]; break;
+    case Instruction::URem: _width = std::min(_ops[0], _ops[1]); break;
+    case Instruction::AShr:
+    case Instruction::SDiv:
+      if (_non_negative)
+        _width = _ops[0];
+      break;
+    case Instruction::SRem:
+      if (_non_negative)
+        _width = std::min(_ops[0], _ops[1]);
+      break;
+    default: return 0;
+  }
+  return std::min(_width, uint32_t(XLEN));
+}
+
+/**
+ * Width the operations which need their operands in full compute with, the
+ * signed ones need one more bit to keep them non-negative. Zero for the other
+ * nodes, they compute with the width of their value.
+ */
+static uint32_t
+getOperandComputeWidth(InstructionNode* _node,
+                       const passes::BitwidthAnalysis::Result& _widths) {
+  auto _ins = _node->getInstruction();
+  if (!_ins)
+    return 0;
+
+  bool _signed = false;
+  switch (_ins->getOpcode()) {
+    case Instruction::LShr:
+    case Instruction::UDiv:
+    case Instruction::URem: break;
+    case Instruction::AShr:
+    case Instruction::SDiv:
+    case Instruction::SRem: _signed = true; break;
+    case Instruction::ICmp: _signed = cast<ICmpInst>(_ins)->isSigned(); break;
+    default: return 0;
+  }
+  if (!_ins->getOperand(0)->getType()->isIntegerTy())
+    return 0;
+
+  auto _ops = getOperandWidths(_node, _widths);
+  if (_ops.empty())
+    return XLEN;
+  auto _max_op = *std::max_element(_ops.begin(), _ops.end());
+  return std::min(_max_op + (_signed ? 1 : 0), uint32_t(XLEN));
+}
+
+/**
+ * The value widths start from what the nodes already have, so the nodes of a
+ * muIR file keep what they were saved with, and they only shrink from there:
+ * each step takes the minimum of the width a node has and the one its
+ * operands give, and a width is never dropped. The operations which need
+ * their operands in full get the width of their operands at the end, it
+ * bounds their value too.
+ */
+passes::BitwidthAnalysis::Result
+passes::BitwidthAnalysis::run(Graph& _graph, AnalysisManager&) {
+  Result _widths;
+  for (auto _node : _graph.instructions()) {
+    if (_node->isNarrowed())
+      _widths[_node] = _node->getDataWidth();
+  }
+
+  for (auto _loop : _graph.loops()) {
+    auto _induction = _loop->getInductionVariable();
+    if (!_induction || _loop->getTripCount() == 0)
+      continue;
+    // A canonical induction variable counts from zero up to the trip count
+    auto _width = Log2_32(_loop->getTripCount()) + 1;
+    auto _found = _widths.find(_induction);
+    if (_found == _widths.end() || _width < _found->second)
+      _widths[_induction] = _width;
+  }
+
+  // The starting widths are proven by LLVM and every other one is computed
+  // from them, so each width on the way to the fixed point is safe to use
+  bool _changed = true;
+  while (_changed) {
+    _changed = false;
+    for (auto _node : _graph.instructions()) {
+      auto _width = getResultWidth(_node, _widths);
+      if (_width == 0 || _width >= XLEN)
+        continue;
+
+      auto _found = _widths.find(_node);
+      if (_found != _widths.end() && _found->second <= _width)
+        continue;
+      _widths[_node] = _width;
+      _changed = true;
+    }
+  }
+
+  // Found after the fixed point, the value widths of these nodes are still
+  // used by their operands while it runs
+  std::vector<std::pair<const Node*, uint32_t>> _compute;
+  for (auto _node : _graph.instructions()) {
+    if (auto _width = getOperandComputeWidth(_node, _widths))
+      _compute.push_back(std::make_pair(_node, _width));
+  }
+  for (auto& _entry : _compute) {
+    if (_entry.second >= XLEN)
+      _widths.erase(_entry.first);
+    else
+      _widths[_entry.first] = _entry.second;
+  }
+
+  // The constants feeding the datapath
+  for (auto _node : _graph.instructions()) {
+    for (auto& _port : _node->input_data_range()) {
+      auto _const = dyn_cast<ConstIntNode>(_port.first);
+      if (_const && _const->getValue() >= 0)
+        _widths[_const] = getValueWidth(_const, _widths);
+    }
+  }
+
+  return _widths;
+}
+
+//===----------------------------------------------------------------------===//
+//                          Transformations
+//===----------------------------------------------------------------------===//
+
+passes::PreservedAnalyses
+passes::GroundStoreNodes::run(Graph& _graph, AnalysisManager&) {
+  _graph.groundStoreNodes();
+  return PreservedAnalyses::all();
+}
+
+passes::PreservedAnalyses
+passes::NarrowWidths::run(Graph& _graph, AnalysisManager& _am) {
+  auto& _widths = _am.getResult<BitwidthAnalysis>();
+
+  auto _narrow = [&_widths](Node* _node) {
+    auto _width = _widths.find(_node);
+    _node->setDataWidth(_width == _widths.end() || _width->second >= XLEN
+                            ? 0
+                            : _width->second);
+  };
+  for (auto _node : _graph.instructions()) {
+    _narrow(_node);
+    for (auto& _port : _node->input_data_range()) {
+      if (isa<ConstIntNode>(_port.first))
+        _narrow(_port.first);
+    }
+  }
+
+  // The widths are what the analysis found, running it again gives the same
+  return PreservedAnalyses::all();
+}
+
+//===----------------------------------------------------------------------===//
+//                          FuseComputeNodes
+//===----------------------------------------------------------------------===//
+
+/**
+ * Width of an integer LLVM value, zero for the other types
+ */
+static uint32_t
+getTypeWidth(Value* _val) {
+  return _val->getType()->isIntegerTy() ? _val->getType()->getIntegerBitWidth() : 0;
+}
+
+/**
+ * Returns true if a fused node can compute the node: a combinational integer
+ * operation on values no wider than XLEN, with one data port for each operand
+ * and only the enable of its super node as control
+ */
+static bool
+isFusible(InstructionNode* _node) {
+  if (!isa<BinaryOperatorNode>(_node) && !isa<IcmpNode>(_node) && !isa<SelectNode>(_node)
+      && !isa<SextNode>(_node) && !isa<ZextNode>(_node) && !isa<TruncNode>(_node))
+    return false;
+  auto _ins = _node->getInstruction();
+  if (!_ins || !_node->getParentNode())
+    return false;
+
+  switch (_ins->getOpcode()) {
+    case Instruction::Add:
+    case Instruction::Sub:
+    case Instruction::Mul:
+    case Instruction::And:
+    case Instruction::Or:
+    case Instruction::Xor:
+    case Instruction::Shl:
+    case Instruction::LShr:
+    case Instruction::AShr:
+    case Instruction::ICmp:
+    case Instruction::Select:
+    case Instruction::ZExt:
+    case Instruction::SExt:
+    case Instruction::Trunc: break;
+    default: return false;
+  }
+
+  auto _width = getTypeWidth(_ins);
+  if (_width == 0 || _width > XLEN)
+    return false;
+  for (auto& _op : _ins->operands()) {
+    auto _op_width = getTypeWidth(_op);
+    if (_op_width == 0 || _op_width > XLEN)
+      return false;
+  }
+  // The shift amount is cut to the bits the width needs
+  if (_ins->isShift() && _width < 2)
+    return false;
+
+  if (_node->numDataInputPort() != _ins->getNumOperands()
+      || _node->numControlInputPort() != 1 || _node->numControlOutputPort() != 0
+      || !isa<SuperNode>(_node->inputControl_begin()->first))
+    return false;
+  SmallPtrSet<Node*, 4> _srcs;
+  for (auto& _port : _node->input_data_range()) {
+    if (!_srcs.insert(_port.first).second)
+      return false;
+  }
+  return true;
+}
+
+/**
+ * Rough delay of an operation in gate levels at its narrowed width.
+ * Extensions, truncations and constant shifts are only wiring, the carry of
+ * add, sub and compare grows with the width and a multiply adds its partial
+ * product tree to it.
+ */
+static int32_t
+getDelay(InstructionNode* _node, const passes::BitwidthAnalysis::Result& _widths) {
+  auto _ins   = _node->getInstruction();
+  auto _width = getTypeWidth(isa<ICmpInst>(_ins) ? _ins->getOperand(0) : _ins);
+  auto _found = _widths.find(_node);
+  if (_found != _widths.end())
+    _width = std::min(_width, _found->second);
+
+  switch (_ins->getOpcode()) {
+    case Instruction::ZExt:
+    case Instruction::SExt:
+    case Instruction::Trunc: return 0;
+    case Instruction::And:
+    case Instruction::Or:
+    case Instruction::Xor:
+    case Instruction::Select: return 1;
+    case Instruction::Shl:
+    case Instruction::LShr:
+    case Instruction::AShr:
+      return isa<ConstantInt>(_ins->getOperand(1)) ? 0 : Log2_32_Ceil(_width);
+    case Instruction::Mul: return 2 * Log2_32_Ceil(_width) + _width / 8;
+    default: return 1 + _width / 8;
+  }
+}
+
+/**
+ * Low bits of a value, a single bit is taken as a Bool
+ */
+static std::string
+printBits(const std::string& _value, uint32_t _width) {
+  if (_width == 1)
+    return _value + "(0)";
+  return _value + "(" + std::to_string(_width - 1) + ", 0)";
+}
+
+static std::string
+printConstant(ConstantInt* _const) {
+  if (_const->getBitWidth() == 1)
+    return _const->isZero() ? "false.B" : "true.B";
+  return "\"h" + utohexstr(_const->getZExtValue(), true) + "\".U("
+         + std::to_string(_const->getBitWidth()) + ".W)";
+}
+
+/**
+ * Chisel expression of an operation over the expressions of its operands.
+ * Every value keeps the width of its LLVM type and the one bit values are
+ * Bools, so the results wrap around the way the LLVM ones do. Only the root
+ * of a chain is extended back to XLEN.
+ */
+static std::string
+printOperation(Instruction* _ins, const std::vector<std::string>& _ops) {
+  auto _width  = getTypeWidth(_ins);
+  auto _amount = [&]() { return printBits(_ops[1], Log2_32_Ceil(_width)); };
+  auto _binary = [&](const char* _op) {
+    return "(" + _ops[0] + " " + _op + " " + _ops[1] + ")";
+  };
+
+  switch (_ins->getOpcode()) {
+    case Instruction::Add: return _binary("+");
+    case Instruction::Sub: return _binary("-");
+    case Instruction::Mul: return printBits(_binary("*"), _width);
+    case Instruction::And: return _binary("&");
+    case Instruction::Or: return _binary("|");
+    case Instruction::Xor: return _binary("^");
+    case Instruction::Shl:
+      return printBits("(" + _ops[0] + " << " + _amount() + ")", _width);
+    case Instruction::LShr: return "(" + _ops[0] + " >> " + _amount() + ")";
+    case Instruction::AShr: return "(" + _ops[0] + ".asSInt >> " + _amount() + ").asUInt";
+    case Instruction::ICmp: {
+      auto _cmp  = cast<ICmpInst>(_ins);
+      auto _sign = _cmp->isSigned() ? ".asSInt" : "";
+      const char* _op;
+      switch (_cmp->getPredicate()) {
+        case CmpInst::ICMP_EQ: _op = "==="; break;
+        case CmpInst::ICMP_NE: _op = "=/="; break;
+        case CmpInst::ICMP_UGT:
+        case CmpInst::ICMP_SGT: _op = ">"; break;
+        case CmpInst::ICMP_UGE:
+        case CmpInst::ICMP_SGE: _op = ">="; break;
+        case CmpInst::ICMP_ULT:
+        case CmpInst::ICMP_SLT: _op = "<"; break;
+        default: _op = "<="; break;
+      }
+      return "(" + _ops[0] + _sign + " " + _op + " " + _ops[1] + _sign + ")";
+    }
+    case Instruction::Select:
+      return "Mux(" + _ops[0] + ".asBool, " + _ops[1] + ", " + _ops[2] + ")";
+    case Instruction::ZExt:
+      return _ops[0] + ".asUInt.pad(" + std::to_string(_width) + ")";
+    case Instruction::SExt:
+      return _ops[0] + ".asSInt.pad(" + std::to_string(_width) + ").asUInt";
+    case Instruction::Trunc: return printBits(_ops[0], _width);
+    default: assert(!"The operation can not be fused!"); return "";
+  }
+}
+
+/**
+ * The chains are grown from their root, the only member whose value leaves
+ * the chain, through the operands which feed nothing else. An operand whose
+ * delay doesn't fit in what is left of the budget on its path starts a
+ * chain of its own.
+ */
+passes::PreservedAnalyses
+passes::FuseComputeNodes::run(Graph& _graph, AnalysisManager& _am) {
+  auto& _widths = _am.getResult<BitwidthAnalysis>();
+
+  std::unordered_set<InstructionNode*> _fusible;
+  for (auto _node : _graph.instructions()) {
+    if (isFusible(_node))
+      _fusible.insert(_node);
+  }
+
+  // The fusible node each fusible node feeds alone inside its super node
+  std::unordered_map<InstructionNode*, InstructionNode*> _consumer;
+  for (auto _node : _graph.instructions()) {
+    if (!_fusible.count(_node) || _node->numDataOutputPort() != 1)
+      continue;
+    auto _user = dyn_cast<InstructionNode>(_node->outputDataport_begin()->first);
+    if (_user && _fusible.count(_user)
+        && _user->getParentNode() == _node->getParentNode())
+      _consumer[_node] = _user;
+  }
+
+  std::vector<InstructionNode*> _roots;
+  for (auto _node : _graph.instructions()) {
+    if (_fusible.count(_node) && !_consumer.count(_node))
+      _roots.push_back(_node);
+  }
+
+  // Members of each chain, operands before their user and the root last
+  std::vector<std::vector<InstructionNode*>> _chains;
+  std::vector<InstructionNode*> _members;
+  std::function<void(InstructionNode*, int32_t)> _grow = [&](InstructionNode* _node,
+                                                            int32_t _slack) {
+    for (auto& _port : _node->input_data_range()) {
+      auto _op = dyn_cast<InstructionNode>(_port.first);
+      auto _user = _op ? _consumer.find(_op) : _consumer.end();
+      if (_user == _consumer.end() || _user->second != _node)
+        continue;
+      auto _delay = getDelay(_op, _widths);
+      if (_delay <= _slack)
+        _grow(_op, _slack - _delay);
+      else
+        _roots.push_back(_op);
+    }
+    _members.push_back(_node);
+  };
+  for (size_t i = 0; i < _roots.size(); i++) {
+    _members.clear();
+    auto _root = _roots[i];
+    _grow(_root, int32_t(fuseDelay) - getDelay(_root, _widths));
+    if (_members.size() > 1)
+      _chains.push_back(_members);
+  }
+
+  for (auto& _chain : _chains) {
+    // The constants only the chain uses are folded into the expression
+    std::vector<ConstIntNode*> _constants;
+    for (auto _member : _chain) {
+      uint32_t _idx = 0;
+      for (auto& _port : _member->input_data_range()) {
+        auto _const = dyn_cast<ConstIntNode>(_port.first);
+        if (_const && _const->numDataOutputPort() == 1
+            && _const->numControlInputPort() == 1
+            && isa<ConstantInt>(_member->getInstruction()->getOperand(_idx)))
+          _constants.push_back(_const);
+        _idx++;
+      }
+    }
+    SmallPtrSet<Node*, 8> _folded(_constants.begin(), _constants.end());
+
+    auto _fused = _graph.fuseInstructions(_chain, _constants);
+
+    std::unordered_map<Node*, std::string> _values;
+    for (auto _member : _chain) {
+      auto _ins = _member->getInstruction();
+      std::vector<std::string> _ops;
+      for (auto& _port : _member->input_data_range()) {
+        auto _op    = _ins->getOperand(_ops.size());
+        auto _value = _values.find(_port.first);
+        if (_value != _values.end()) {
+          _ops.push_back(_value->second);
+        } else if (_folded.count(_port.first)) {
+          _ops.push_back(printConstant(cast<ConstantInt>(_op)));
+        } else {
+          auto _in = _fused->returnDataInputPortIndex(_port.first).getID();
+          _ops.push_back(printBits("in(" + std::to_string(_in) + ")", getTypeWidth(_op)));
+        }
+      }
+      _values[_member] = printOperation(_ins, _ops);
+    }
+    // The other nodes and the constants carry their values sign extended to
+    // XLEN, the root is extended the same way unless it is a Bool
+    auto _root_width = getTypeWidth(_chain.back()->getInstruction());
+    auto& _expr      = _values[_chain.back()];
+    if (_root_width > 1 && _root_width < XLEN)
+      _fused->setExpression("(" + _expr + ").asSInt.pad(xlen).asUInt");
+    else
+      _fused->setExpression(_expr);
+  }
+  _graph.eraseFusedNodes();
+
+  DEBUG(dbgs() << "\t Fused " << _chains.size() << " chains of "
+               << _graph.graph_info.Name << "\n");
+  return PreservedAnalyses::none();
+}
+
+//===----------------------------------------------------------------------===//
+//                            Pass registry
+//===----------------------------------------------------------------------===//
+
+namespace {
+
+struct PassInfo {
+  const char* name;
+  const char* desc;
+  std::unique_ptr<passes::GraphPass> (*create)();
+};
+
+template <typename PassT>
+std::unique_ptr<passes::GraphPass>
+createPass() {
+  return std::make_unique<PassT>();
+}
+
+const PassInfo registered_passes[] = {
+    {"ground-stores",
+     "Ground the store nodes nothing consumes",
+     createPass<passes::GroundStoreNodes>},
+    {"narrow-widths",
+     "Narrow the integer nodes to the widths of their values",
+     createPass<passes::NarrowWidths>},
+    {"fuse-compute",
+     "Fuse the single consumer chains of integer operations",
+     createPass<passes::FuseComputeNodes>},
+};
+
+const PassInfo*
+findPass(StringRef _name) {
+  for (auto& _info : registered_passes) {
+    if (_name == _info.name)
+      return &_info;
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+bool
+passes::isRegisteredPass(StringRef _name) {
+  return findPass(_name) != nullptr;
+}
+
+std::unique_ptr<passes::GraphPass>
+passes::createGraphPass(StringRef _name) {
+  auto _info = findPass(_name);
+  return _info ? _info->create() : nullptr;
+}
+
+void
+passes::printRegisteredPasses(raw_ostream& _out) {
+  for (auto& _info : registered_passes)
+    _out << "  " << left_justify(_info.name, 20) << " - " << _info.desc << "\n";
+}
+
+void
+passes::buildPipeline(passes::PassManager& _pm, char _opt_level) {
+  // A store nothing consumes stalls on its output unless it is grounded
+  _pm.addPass(std::make_unique<passes::GroundStoreNodes>());
+
+  if (_opt_level >= '1' && narrowWidths)
+    _pm.addPass(std::make_unique<passes::NarrowWidths>());
+
+  // The chains are fused after narrowing so their delays are the ones of the
+  // narrowed operations
+  if (_opt_level >= '2')
+    _pm.addPass(std::make_unique<passes::FuseComputeNodes>());
+}
@@ -0,0 +1,929 @@
+#define DEBUG_TYPE "graphgen"
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/Host.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include "Common.h"
+#include "Dandelion/Graph.h"
+#include "Dandelion/MuIRBinary.h"
+#include "Dandelion/Node.h"
+
+#include <cstring>
+#include <string>
+#include <system_error>
+#include <vector>
+
+using namespace llvm;
+using namespace dandelion;
+using namespace dandelion::muir;
+using namespace helpers;
+
+//===----------------------------------------------------------------------===//
+//                            MuIR Writer
+//===----------------------------------------------------------------------===//
+
+namespace {
+
+/**
+ * Collects the flat tables of a binary muIR file, nodes are numbered in the
+ * order they are first reached
+ */
+class MuIRWriter {
+public:
+  std::vector<Node*> node_order;
+  DenseMap<const Node*, uint32_t> node_index;
+
+  std::vector<NodeRecord> nodes;
+  std::vector<SuperNodeRecord> super_nodes;
+  std::vector<LoopRecord> loops;
+  std::vector<ArgumentRecord> arguments;
+  std::vector<EdgeRecord> edges;
+  std::vector<uint32_t> lists;
+  std::string strings;
+  StringMap<uint32_t> string_index;
+
+  // Number of the nodes which are indexed from the graph lists
+  uint32_t graph_nodes = 0;
+
+  // The empty string is always at offset zero
+  MuIRWriter() {
+    addString("");
+  }
+
+  uint32_t
+  addString(StringRef _str) {
+    auto _it = string_index.insert(std::make_pair(_str, strings.size()));
+    if (_it.second) {
+      strings.append(_str.begin(), _str.end());
+      strings.push_back('\0');
+    }
+    return _it.first->second;
+  }
+
+  uint32_t
+  getIndex(Node* _node) {
+    if (_node == nullptr)
+      return NoNode;
+    auto _it = node_index.insert(std::make_pair(_node, node_order.size()));
+    if (_it.second)
+      node_order.push_back(_node);
+    return _it.first->second;
+  }
+
+  template <typename R>
+  ListRef
+  addNodes(R&& _range) {
+    ListRef _list{static_cast<uint32_t>(lists.size()), 0};
+    for (auto _node : _range) {
+      lists.push_back(getIndex(_node));
+      _list.count++;
+    }
+    return _list;
+  }
+
+  template <typename R>
+  ListRef
+  addPorts(R&& _range) {
+    ListRef _list{static_cast<uint32_t>(lists.size()), 0};
+    for (auto _port : _range) {
+      lists.push_back(getIndex(_port.first));
+      lists.push_back(_port.second.getID());
+      _list.count++;
+    }
+    return _list;
+  }
+
+  NodeRecord makeNodeRecord(Node*);
+  void write(raw_ostream&, StringRef);
+};
+
+}  // namespace
+
+NodeRecord
+MuIRWriter::makeNodeRecord(Node* _node) {
+  NodeRecord _rec;
+  std::memset(&_rec, 0, sizeof(_rec));
+  _rec.kind       = _node->getType();
+  _rec.data_type  = Node::UknownType;
+  _rec.id         = _node->getID();
+  _rec.name       = addString(_node->getName());
+  _rec.parent     = NoNode;
+  _rec.link       = NoNode;
+  _rec.data_width = _node->getDataWidth();
+
+  if (auto _ins = dyn_cast<InstructionNode>(_node)) {
+    _rec.sub_kind  = _ins->getOpCode();
+    _rec.data_type = _ins->getDataType();
+    _rec.parent    = getIndex(_ins->getParentNode());
+    _rec.opcode    = _ins->getLLVMOpCode();
+    if (auto _icmp = dyn_cast<IcmpNode>(_node))
+      _rec.predicate = _icmp->getPredicate();
+    if (auto _fcmp = dyn_cast<FcmpNode>(_node))
+      _rec.predicate = _fcmp->getPredicate();
+
+    std::string _text;
+    raw_string_ostream _out(_text);
+    _ins->printInstruction(_out);
+    _rec.text = addString(_out.str());
+    if (auto _fused = dyn_cast<FusedComputeNode>(_node))
+      _rec.expression = addString(_fused->getExpression());
+
+    if (auto _alloca = dyn_cast<AllocaNode>(_node))
+      _rec.value = _alloca->getSize() | (uint64_t(_alloca->getNumByte()) << 32);
+    // Stride and trip count of the streams
+    if (auto _load = dyn_cast<LoadNode>(_node)) {
+      _rec.width = _load->getAccessSize();
+      _rec.value = _load->getStreamTripCount()
+                   | (uint64_t(uint32_t(_load->getStreamStride())) << 32);
+    }
+    if (auto _store = dyn_cast<StoreNode>(_node)) {
+      _rec.width = _store->getAccessSize();
+      _rec.value = _store->getStreamTripCount()
+                   | (uint64_t(uint32_t(_store->getStreamStride())) << 32);
+    }
+
+    _rec.debug_parents = ListRef{static_cast<uint32_t>(lists.size()), 0};
+    for (auto _d_parent : _ins->debug_parent_node) {
+      lists.push_back(_d_parent);
+      _rec.debug_parents.count++;
+    }
+
+    _rec.element_sizes = ListRef{static_cast<uint32_t>(lists.size()), 0};
+    if (auto _gep = dyn_cast<GepNode>(_node)) {
+      for (auto _size : _gep->getGepInfo().element_size) {
+        lists.push_back(_size);
+        _rec.element_sizes.count++;
+      }
+    }
+  } else if (auto _arg = dyn_cast<ArgumentNode>(_node)) {
+    _rec.sub_kind  = _arg->getArgType();
+    _rec.data_type = _arg->getDataArgType();
+    _rec.parent    = getIndex(_arg->getParentCallNode());
+    _rec.link      = getIndex(_arg->getParentNode());
+  } else if (auto _container = dyn_cast<ContainerNode>(_node)) {
+    _rec.sub_kind = _container->getContainerType();
+    if (auto _loop = dyn_cast<LoopNode>(_node))
+      _rec.parent = getIndex(_loop->getParentLoopNode());
+  } else if (auto _const_int = dyn_cast<ConstIntNode>(_node)) {
+    _rec.value = static_cast<int64_t>(_const_int->getValue());
+  } else if (auto _const_fp = dyn_cast<ConstFPNode>(_node)) {
+    _rec.value = _const_fp->getFloatIEEE().bits;
+  } else if (auto _mem = dyn_cast<ScratchpadNode>(_node)) {
+    _rec.link  = getIndex(_mem->getAllocaNode());
+    _rec.value = _mem->getMemSize() | (uint64_t(_mem->getMemByte()) << 32);
+  }
+
+  _rec.ports[DataInput]           = addPorts(_node->input_data_range());
+  _rec.ports[DataOutput]          = addPorts(_node->output_data_range());
+  _rec.ports[ControlInput]        = addPorts(_node->input_control_range());
+  _rec.ports[ControlOutput]       = addPorts(_node->output_control_range());
+  _rec.ports[MemoryReadRequest]   = addPorts(_node->read_req_range());
+  _rec.ports[MemoryReadResponse]  = addPorts(_node->read_resp_range());
+  _rec.ports[MemoryWriteRequest]  = addPorts(_node->write_req_range());
+  _rec.ports[MemoryWriteResponse] = addPorts(_node->write_resp_range());
+
+  return _rec;
+}
+
+void
+MuIRWriter::write(raw_ostream& _out, StringRef _name) {
+  assert(sys::IsLittleEndianHost && "Binary muIR is only written on little endian hosts!");
+
+  FileHeader _header;
+  std::memset(&_header, 0, sizeof(_header));
+  _header.magic       = Magic;
+  _header.version     = Version;
+  _header.name        = addString(_name);
+  _header.graph_nodes = graph_nodes;
+
+  // Laying out the tables
+  uint64_t _offset = sizeof(FileHeader);
+  auto _place      = [&_offset](TableRef& _table, size_t _count, size_t _size) {
+    _offset       = alignTo(_offset, 8);
+    _table.offset = _offset;
+    _table.count  = _count;
+    _offset += _count * _size;
+  };
+  _place(_header.nodes, nodes.size(), sizeof(NodeRecord));
+  _place(_header.super_nodes, super_nodes.size(), sizeof(SuperNodeRecord));
+  _place(_header.loops, loops.size(), sizeof(LoopRecord));
+  _place(_header.arguments, arguments.size(), sizeof(ArgumentRecord));
+  _place(_header.edges, edges.size(), sizeof(EdgeRecord));
+  _place(_header.lists, lists.size(), sizeof(uint32_t));
+  _place(_header.strings, strings.size(), sizeof(char));
+  assert(_offset <= UINT32_MAX && "Binary muIR file is larger than 4GB!");
+
+  uint64_t _pos = 0;
+  auto _emit    = [&_out, &_pos](const TableRef& _table, const void* _data, size_t _bytes) {
+    for (; _pos < _table.offset; _pos++)
+      _out << '\0';
+    _out.write(reinterpret_cast<const char*>(_data), _bytes);
+    _pos += _bytes;
+  };
+  _emit(TableRef{0, 1}, &_header, sizeof(_header));
+  _emit(_header.nodes, nodes.data(), nodes.size() * sizeof(NodeRecord));
+  _emit(_header.super_nodes,
+        super_nodes.data(),
+        super_nodes.size() * sizeof(SuperNodeRecord));
+  _emit(_header.loops, loops.data(), loops.size() * sizeof(LoopRecord));
+  _emit(_header.arguments, arguments.data(), arguments.size() * sizeof(ArgumentRecord));
+  _emit(_header.edges, edges.data(), edges.size() * sizeof(EdgeRecord));
+  _emit(_header.lists, lists.data(), lists.size() * sizeof(uint32_t));
+  _emit(_header.strings, strings.data(), strings.size());
+}
+
+/**
+ * Printing the graph in the binary muIR format, unlike printMUIR no
+ * intermediate tree is built and the file is written in one go
+ */
+void
+Graph::printMUIRBinary() {
+  MuIRWriter _writer;
+
+  // Fixed order for the graph lists and the container arguments, the rest of
+  // the nodes are numbered when they are reached from the ports. The loader
+  // rebuilds the lists from the same order.
+  _writer.getIndex(split_call.get());
+  for (auto& _bb : super_node_list)
+    _writer.getIndex(_bb);
+  for (auto& _ins : inst_list)
+    _writer.getIndex(_ins);
+  for (auto& _arg : arg_list)
+    _writer.getIndex(_arg);
+  for (auto& _glob : glob_list)
+    _writer.getIndex(_glob);
+  for (auto& _const : const_int_list)
+    _writer.getIndex(_const);
+  for (auto& _const : const_fp_list)
+    _writer.getIndex(_const);
+  for (auto& _loop : loop_nodes)
+    _writer.getIndex(_loop);
+  for (auto& _arg : split_call->live_in_vals_lists())
+    _writer.getIndex(_arg.get());
+  for (auto& _arg : split_call->live_in_ptrs_lists())
+    _writer.getIndex(_arg.get());
+  for (auto& _loop : loop_nodes) {
+    for (auto& _arg : _loop->live_in_lists())
+      _writer.getIndex(_arg.get());
+    for (auto& _arg : _loop->live_out_lists())
+      _writer.getIndex(_arg.get());
+    for (auto& _arg : _loop->carry_depen_lists())
+      _writer.getIndex(_arg.get());
+  }
+  for (auto& _mem : scratchpad_memories)
+    _writer.getIndex(_mem);
+  for (auto& _call : call_in_list)
+    _writer.getIndex(_call);
+  for (auto& _call : call_out_list)
+    _writer.getIndex(_call);
+  for (auto _unit : getMemoryUnits())
+    _writer.getIndex(_unit);
+  auto _fpu_index     = _writer.getIndex(floating_point_unit.get());
+  _writer.graph_nodes = _writer.node_order.size();
+
+  for (auto& _bb : super_node_list) {
+    SuperNodeRecord _rec;
+    _rec.node         = _writer.getIndex(_bb);
+    _rec.type         = _bb->getNodeType();
+    _rec.instructions = _writer.addNodes(_bb->instructions());
+    _rec.phis         = _writer.addNodes(_bb->phis());
+
+    _rec.constants = _writer.addNodes(_bb->cints());
+    _rec.constants.count += _writer.addNodes(_bb->cfps()).count;
+    _writer.super_nodes.push_back(_rec);
+  }
+
+  for (auto& _loop : loop_nodes) {
+    LoopRecord _rec;
+    std::memset(&_rec, 0, sizeof(_rec));
+    _rec.node        = _writer.getIndex(_loop);
+    _rec.parent_loop = _writer.getIndex(_loop->getParentLoopNode());
+    _rec.induction   = _writer.getIndex(_loop->getInductionVariable());
+    _rec.trip_count  = _loop->getTripCount();
+    _rec.blocks      = _writer.addNodes(_loop->bblocks());
+
+    _rec.carries = ListRef{static_cast<uint32_t>(_writer.lists.size()), 0};
+    for (auto& _carry : _loop->carry_depen_lists()) {
+      if (_carry->getArgType() != ArgumentNode::CarryDependency)
+        continue;
+      for (auto& _data_in : _carry->input_data_range()) {
+        _writer.lists.push_back(_writer.getIndex(_data_in.first));
+        _rec.carries.count++;
+      }
+    }
+    _writer.loops.push_back(_rec);
+  }
+
+  for (auto& _arg : split_call->live_in_vals_lists()) {
+    _writer.arguments.push_back(
+        ArgumentRecord{_writer.getIndex(_arg.get()), SplitCallNode::Vals});
+  }
+  for (auto& _arg : split_call->live_in_ptrs_lists()) {
+    _writer.arguments.push_back(
+        ArgumentRecord{_writer.getIndex(_arg.get()), SplitCallNode::Ptrs});
+  }
+
+  for (auto _edge : edge_list) {
+    auto _src = _edge->getSrc();
+    auto _tar = _edge->getTar();
+    _writer.edges.push_back(
+        EdgeRecord{_edge->getType(),
+                   PortRef{_writer.getIndex(_src.first), _src.second.getID()},
+                   PortRef{_writer.getIndex(_tar.first), _tar.second.getID()}});
+  }
+
+  // Node records are made last, the node order can still grow while the
+  // ports are visited
+  for (uint32_t i = 0; i < _writer.node_order.size(); i++) {
+    auto _node = _writer.node_order[i];
+    _writer.nodes.push_back(_writer.makeNodeRecord(_node));
+  }
+
+  // The floating point unit is built with the kind of the scratchpads, its
+  // record is tagged with its own kind to tell them apart
+  _writer.nodes[_fpu_index].kind = Node::FloatingPointTy;
+
+  SmallVector<char, 0> _buffer;
+  raw_svector_ostream _out(_buffer);
+  _writer.write(_out, this->graph_info.Name);
+
+  writeIfChanged(this->graph_info.Name + ".muir.bin",
+                 StringRef(_buffer.data(), _buffer.size()));
+}
+
+//===----------------------------------------------------------------------===//
+//                            MuIR Reader
+//===----------------------------------------------------------------------===//
+
+MuIRFile::MuIRFile(std::unique_ptr<MemoryBuffer> _buffer)
+  : buffer(std::move(_buffer)),
+    header(reinterpret_cast<const FileHeader*>(buffer->getBufferStart())) {}
+
+ErrorOr<std::unique_ptr<MuIRFile>>
+MuIRFile::open(StringRef path) {
+  // Big files are memory mapped by MemoryBuffer
+  auto _buffer = MemoryBuffer::getFile(path, -1, false);
+  if (!_buffer)
+    return _buffer.getError();
+
+  // The records are read in place, the file is written little endian
+  if (!sys::IsLittleEndianHost)
+    return std::make_error_code(std::errc::not_supported);
+
+  auto _invalid = std::make_error_code(std::errc::invalid_argument);
+  uint64_t _size = (*_buffer)->getBufferSize();
+  if (_size < sizeof(FileHeader))
+    return _invalid;
+
+  auto _start  = (*_buffer)->getBufferStart();
+  auto _header = reinterpret_cast<const FileHeader*>(_start);
+  if (_header->magic != Magic || _header->version != Version)
+    return _invalid;
+
+  // Each table has to be aligned for its records
+  auto _fits = [_size](const TableRef& _table, size_t _record_size, size_t _align) {
+    return (_table.offset % _align == 0)
+           && (uint64_t(_table.offset) + uint64_t(_table.count) * _record_size <= _size);
+  };
+  if (!_fits(_header->nodes, sizeof(NodeRecord), alignof(NodeRecord))
+      || !_fits(_header->super_nodes, sizeof(SuperNodeRecord), alignof(SuperNodeRecord))
+      || !_fits(_header->loops, sizeof(LoopRecord), alignof(LoopRecord))
+      || !_fits(_header->arguments, sizeof(ArgumentRecord), alignof(ArgumentRecord))
+      || !_fits(_header->edges, sizeof(EdgeRecord), alignof(EdgeRecord))
+      || !_fits(_header->lists, sizeof(uint32_t), alignof(uint32_t))
+      || !_fits(_header->strings, sizeof(char), alignof(char)))
+    return _invalid;
+
+  // Strings have to be null terminated
+  if (_header->strings.count == 0
+      || _start[_header->strings.offset + _header->strings.count - 1] != '\0'
+      || _header->name >= _header->strings.count
+      || _header->graph_nodes > _header->nodes.count)
+    return _invalid;
+
+  std::unique_ptr<MuIRFile> _file(new MuIRFile(std::move(*_buffer)));
+  if (!_file->verify())
+    return _invalid;
+
+  return std::move(_file);
+}
+
+/**
+ * Instruction types which are rebuilt by createInstructionNode, call ports
+ * are taken from their call node
+ */
+static bool
+isLoadableInstruction(uint32_t _sub_kind) {
+  switch (_sub_kind) {
+    case InstructionNode::BinaryInstructionTy:
+    case InstructionNode::IcmpInstructionTy:
+    case InstructionNode::BranchInstructionTy:
+    case InstructionNode::PhiInstructionTy:
+    case InstructionNode::AllocaInstructionTy:
+    case InstructionNode::GetElementPtrArrayInstTy:
+    case InstructionNode::GetElementPtrStructInstTy:
+    case InstructionNode::GetElementPtrInstTy:
+    case InstructionNode::LoadInstructionTy:
+    case InstructionNode::StoreInstructionTy:
+    case InstructionNode::SextInstructionTy:
+    case InstructionNode::ZextInstructionTy:
+    case InstructionNode::BitCastInstructionTy:
+    case InstructionNode::STIoFPInstructionTy:
+    case InstructionNode::FPToUIInstructionTy:
+    case InstructionNode::TruncInstructionTy:
+    case InstructionNode::SelectInstructionTy:
+    case InstructionNode::FaddInstructionTy:
+    case InstructionNode::FsubInstructionTy:
+    case InstructionNode::FmulInstructionTy:
+    case InstructionNode::FdiveInstructionTy:
+    case InstructionNode::FcmpInstructionTy:
+#ifdef TAPIR
+    case InstructionNode::DetachInstructionTy:
+    case InstructionNode::ReattachInstructionTy:
+    case InstructionNode::SyncInstructionTy:
+#endif
+    case InstructionNode::ReturnInstrunctionTy:
+    case InstructionNode::CallInstructionTy:
+    case InstructionNode::CallInInstructionTy:
+    case InstructionNode::CallOutInstructionTy:
+    case InstructionNode::FusedInstructionTy: return true;
+    default: return false;
+  }
+}
+
+bool
+MuIRFile::verify() const {
+  auto _records = nodes();
+
+  auto _string = [this](uint32_t _offset) { return _offset < header->strings.count; };
+  auto _list   = [this](const ListRef& _ref, uint64_t _width) {
+    return uint64_t(_ref.begin) + _width * _ref.count <= header->lists.count;
+  };
+  // Index of a node of the given kind, NoNode is only taken if it's allowed
+  auto _node = [&_records](uint32_t _index, uint32_t _kind, bool _none) {
+    if (_index == NoNode)
+      return _none;
+    return _index < _records.size()
+           && (_kind == Node::UnkonwTy || _records[_index].kind == _kind);
+  };
+  auto _nodes = [&](const ListRef& _ref, uint32_t _kind) {
+    if (!_list(_ref, 1))
+      return false;
+    for (auto _index : getList(_ref)) {
+      if (!_node(_index, _kind, false))
+        return false;
+    }
+    return true;
+  };
+  auto _loop = [&](uint32_t _index) {
+    return _node(_index, Node::ContainerTy, true)
+           && (_index == NoNode
+               || _records[_index].sub_kind == ContainerNode::LoopNodeTy);
+  };
+
+  DenseSet<uint32_t> _call_ids;
+  for (auto& _rec : _records) {
+    if (_rec.kind == Node::InstructionNodeTy
+        && _rec.sub_kind == InstructionNode::CallInstructionTy)
+      _call_ids.insert(_rec.id);
+  }
+
+  for (auto& _rec : _records) {
+    if (!_string(_rec.name) || !_list(_rec.debug_parents, 1)
+        || !_list(_rec.element_sizes, 1))
+      return false;
+
+    for (uint32_t _kind = 0; _kind < NumPortKinds; _kind++) {
+      if (!_list(_rec.ports[_kind], 2))
+        return false;
+      for (auto& _port : getPorts(_rec.ports[_kind])) {
+        if (!_node(_port.node, Node::UnkonwTy, true))
+          return false;
+      }
+    }
+
+    switch (_rec.kind) {
+      case Node::SuperNodeTy:
+      case Node::GlobalValueTy:
+      case Node::ConstIntTy:
+      case Node::ConstFPTy:
+      case Node::MemoryUnitTy:
+      case Node::FloatingPointTy: break;
+      case Node::InstructionNodeTy:
+        if (!isLoadableInstruction(_rec.sub_kind) || !_string(_rec.text)
+            || !_string(_rec.expression)
+            || !_node(_rec.parent, Node::SuperNodeTy, true))
+          return false;
+        // The operation of the nodes printed by their opcode or predicate
+        if ((_rec.sub_kind == InstructionNode::BinaryInstructionTy
+             || _rec.sub_kind == InstructionNode::FaddInstructionTy
+             || _rec.sub_kind == InstructionNode::FsubInstructionTy
+             || _rec.sub_kind == InstructionNode::FmulInstructionTy
+             || _rec.sub_kind == InstructionNode::FdiveInstructionTy)
+            && !Instruction::isBinaryOp(_rec.opcode))
+          return false;
+        if (_rec.sub_kind == InstructionNode::IcmpInstructionTy
+            && !CmpInst::isIntPredicate(CmpInst::Predicate(_rec.predicate)))
+          return false;
+        if (_rec.sub_kind == InstructionNode::FcmpInstructionTy
+            && !CmpInst::isFPPredicate(CmpInst::Predicate(_rec.predicate)))
+          return false;
+        // Call ports are taken from the call node with the same ID
+        if ((_rec.sub_kind == InstructionNode::CallInInstructionTy
+             || _rec.sub_kind == InstructionNode::CallOutInstructionTy)
+            && !_call_ids.count(_rec.id))
+          return false;
+        break;
+      case Node::ContainerTy:
+        if (_rec.sub_kind != ContainerNode::LoopNodeTy
+            && _rec.sub_kind != ContainerNode::SplitCallTy)
+          return false;
+        break;
+      case Node::FunctionArgTy:
+        if (_rec.sub_kind > ArgumentNode::CarryDependency
+            || !_node(_rec.parent, Node::ContainerTy, true)
+            || !_node(_rec.link, Node::UnkonwTy, true))
+          return false;
+        break;
+      case Node::StackUnitTy:
+        if (!_node(_rec.link, Node::InstructionNodeTy, true)
+            || (_rec.link != NoNode
+                && _records[_rec.link].sub_kind != InstructionNode::AllocaInstructionTy))
+          return false;
+        break;
+      default: return false;
+    }
+  }
+
+  for (auto& _rec : super_nodes()) {
+    if (!_node(_rec.node, Node::SuperNodeTy, false)
+        || !_nodes(_rec.instructions, Node::InstructionNodeTy)
+        || !_nodes(_rec.phis, Node::InstructionNodeTy)
+        || !_nodes(_rec.constants, Node::UnkonwTy))
+      return false;
+    for (auto _index : getList(_rec.phis)) {
+      if (_records[_index].sub_kind != InstructionNode::PhiInstructionTy)
+        return false;
+    }
+    for (auto _index : getList(_rec.constants)) {
+      if (_records[_index].kind != Node::ConstIntTy
+          && _records[_index].kind != Node::ConstFPTy)
+        return false;
+    }
+  }
+
+  for (auto& _rec : loops()) {
+    if (_rec.node == NoNode || !_loop(_rec.node) || !_loop(_rec.parent_loop)
+        || !_node(_rec.induction, Node::InstructionNodeTy, true)
+        || !_nodes(_rec.blocks, Node::SuperNodeTy)
+        || !_nodes(_rec.carries, Node::UnkonwTy))
+      return false;
+  }
+
+  for (auto& _rec : arguments()) {
+    if (!_node(_rec.node, Node::FunctionArgTy, false))
+      return false;
+  }
+
+  for (auto& _rec : edges()) {
+    if (!_node(_rec.src.node, Node::UnkonwTy, true)
+        || !_node(_rec.tar.node, Node::UnkonwTy, true))
+      return false;
+  }
+
+  return true;
+}
+
+StringRef
+MuIRFile::getString(uint32_t _offset) const {
+  assert(_offset < header->strings.count && "String is out of the string table!");
+  return StringRef(buffer->getBufferStart() + header->strings.offset + _offset);
+}
+
+ArrayRef<uint32_t>
+MuIRFile::getList(const ListRef& _list) const {
+  assert(uint64_t(_list.begin) + _list.count <= header->lists.count
+         && "List is out of the lists table!");
+  return getTable<uint32_t>(header->lists).slice(_list.begin, _list.count);
+}
+
+ArrayRef<PortRef>
+MuIRFile::getPorts(const ListRef& _list) const {
+  assert(uint64_t(_list.begin) + 2 * uint64_t(_list.count) <= header->lists.count
+         && "Port list is out of the lists table!");
+  return ArrayRef<PortRef>(
+      reinterpret_cast<const PortRef*>(getTable<uint32_t>(header->lists).data()
+                                       + _list.begin),
+      _list.count);
+}
+
+//===----------------------------------------------------------------------===//
+//                            MuIR Loader
+//===----------------------------------------------------------------------===//
+
+namespace {
+
+/**
+ * Creates an instruction node of the recorded type, loaded nodes don't have
+ * any LLVM instruction behind them. The recorded opcode is set by the caller.
+ */
+InstructionNode*
+createInstructionNode(Arena& _arena,
+                      const NodeRecord& _rec,
+                      NodeInfo _info,
+                      MemoryNode* _mem) {
+  switch (_rec.sub_kind) {
+    case InstructionNode::BinaryInstructionTy:
+      return _arena.create<BinaryOperatorNode>(_info);
+    case InstructionNode::IcmpInstructionTy: {
+      auto _icmp = _arena.create<IcmpNode>(_info);
+      _icmp->setPredicate(static_cast<CmpInst::Predicate>(_rec.predicate));
+      return _icmp;
+    }
+    case InstructionNode::BranchInstructionTy: return _arena.create<BranchNode>(_info);
+    case InstructionNode::PhiInstructionTy: return _arena.create<PhiSelectNode>(_info);
+    case InstructionNode::AllocaInstructionTy:
+      return _arena.create<AllocaNode>(_info,
+                                       static_cast<uint32_t>(_rec.value >> 32),
+                                       static_cast<uint32_t>(_rec.value));
+    case InstructionNode::GetElementPtrArrayInstTy:
+    case InstructionNode::GetElementPtrStructInstTy:
+    case InstructionNode::GetElementPtrInstTy: return _arena.create<GepNode>(_info);
+    case InstructionNode::LoadInstructionTy: {
+      auto _load = _arena.create<LoadNode>(_info, nullptr, _mem);
+      _load->setAccessSize(_rec.width);
+      _load->setStream(static_cast<int32_t>(_rec.value >> 32),
+                       static_cast<uint32_t>(_rec.value));
+      return _load;
+    }
+    case InstructionNode::StoreInstructionTy: {
+      auto _store = _arena.create<StoreNode>(_info, nullptr, _mem);
+      _store->setAccessSize(_rec.width);
+      _store->setStream(static_cast<int32_t>(_rec.value >> 32),
+                        static_cast<uint32_t>(_rec.value));
+      return _store;
+    }
+    case InstructionNode::SextInstructionTy: return _arena.create<SextNode>(_info);
+    case InstructionNode::ZextInstructionTy: return _arena.create<ZextNode>(_info);
+    case InstructionNode::BitCastInstructionTy: return _arena.create<BitcastNode>(_info);
+    case InstructionNode::STIoFPInstructionTy: return _arena.create<STIoFPNode>(_info);
+    case InstructionNode::FPToUIInstructionTy: return _arena.create<FPToUINode>(_info);
+    case InstructionNode::TruncInstructionTy: return _arena.create<TruncNode>(_info);
+    case InstructionNode::SelectInstructionTy: return _arena.create<SelectNode>(_info);
+    case InstructionNode::FaddInstructionTy:
+    case InstructionNode::FsubInstructionTy:
+    case InstructionNode::FmulInstructionTy:
+      return _arena.create<FaddOperatorNode>(_info);
+    case InstructionNode::FdiveInstructionTy:
+      return _arena.create<FdiveOperatorNode>(_info);
+    case InstructionNode::FcmpInstructionTy: {
+      auto _fcmp = _arena.create<FcmpNode>(_info);
+      _fcmp->setPredicate(static_cast<CmpInst::Predicate>(_rec.predicate));
+      return _fcmp;
+    }
+#ifdef TAPIR
+    case InstructionNode::DetachInstructionTy: return _arena.create<DetachNode>(_info);
+    case InstructionNode::ReattachInstructionTy:
+      return _arena.create<ReattachNode>(_info);
+    case InstructionNode::SyncInstructionTy: return _arena.create<SyncNode>(_info);
+#endif
+    case InstructionNode::ReturnInstrunctionTy: return _arena.create<ReturnNode>(_info);
+    case InstructionNode::CallInstructionTy: return _arena.create<CallNode>(_info);
+    case InstructionNode::FusedInstructionTy:
+      return _arena.create<FusedComputeNode>(_info);
+    default: return nullptr;
+  }
+}
+
+}  // namespace
+
+/**
+ * Rebuilding the graph from a binary muIR file. Nodes are created in three
+ * steps: the nodes which stand on their own, then the ones which need
+ * another node to exist (arguments, call ports and scratchpads) and at the
+ * end all the links and ports between them.
+ * NOTE: The graph has to be empty, split call, memory unit and floating point
+ * unit of the graph take the place of the loaded ones. Indices and node kinds
+ * are checked once by MuIRFile::open, they are not checked again here.
+ */
+void
+Graph::loadMUIRBinary(const MuIRFile& _file) {
+  auto _records = _file.nodes();
+  std::vector<Node*> _nodes(_records.size(), nullptr);
+  DenseMap<uint32_t, CallNode*> _call_nodes;
+
+  auto _info = [&_file](const NodeRecord& _rec) {
+    return NodeInfo(_rec.id, _file.getString(_rec.name).str());
+  };
+  auto _at = [&_nodes](uint32_t _index) -> Node* {
+    return _index == NoNode ? nullptr : _nodes[_index];
+  };
+
+  for (uint32_t i = 0; i < _records.size(); i++) {
+    auto& _rec   = _records[i];
+    bool _listed = i < _file.getGraphNodes();
+
+    switch (_rec.kind) {
+      case Node::SuperNodeTy: {
+        auto _bb = arena.create<SuperNode>(_info(_rec));
+        if (_listed)
+          super_node_list.push_back(_bb);
+        _nodes[i] = _bb;
+        break;
+      }
+      case Node::InstructionNodeTy: {
+        // Call ports are owned by their call node
+        if (_rec.sub_kind == InstructionNode::CallInInstructionTy
+            || _rec.sub_kind == InstructionNode::CallOutInstructionTy)
+          break;
+
+        auto _ins = createInstructionNode(arena, _rec, _info(_rec), memory_unit.get());
+        assert(_ins && "Unknown instruction type in muIR file!");
+        _ins->setDataType(static_cast<Node::DataType>(_rec.data_type));
+        _ins->setLLVMOpCode(_rec.opcode);
+        _ins->setInstructionText(_file.getString(_rec.text));
+        if (auto _fused = dyn_cast<FusedComputeNode>(_ins)) {
+          _fused->setExpression(_file.getString(_rec.expression).str());
+          _fused->setModuleName(this->graph_info.Name + "_" + _fused->getScalaName());
+        }
+        for (auto _d_parent : _file.getList(_rec.debug_parents))
+          _ins->debug_parent_node.push_back(_d_parent);
+
+        auto _element_sizes = _file.getList(_rec.element_sizes);
+        if (auto _gep = dyn_cast<GepNode>(_ins)) {
+          if (!_element_sizes.empty())
+            _gep->setGepInfo(GepInfo(_element_sizes.vec()));
+        }
+
+        if (auto _call = dyn_cast<CallNode>(_ins))
+          _call_nodes[_rec.id] = _call;
+        if (_listed)
+          inst_list.push_back(_ins);
+        _nodes[i] = _ins;
+        break;
+      }
+      case Node::GlobalValueTy: {
+        auto _glob = arena.create<GlobalValueNode>(_info(_rec));
+        if (_listed)
+          glob_list.push_back(_glob);
+        _nodes[i] = _glob;
+        break;
+      }
+      case Node::ConstIntTy: {
+        auto _const = arena.create<ConstIntNode>(_info(_rec), static_cast<int>(_rec.value));
+        if (_listed)
+          const_int_list.push_back(_const);
+        _nodes[i] = _const;
+        break;
+      }
+      case Node::ConstFPTy: {
+        FloatingPointIEEE754 _value;
+        _value.bits = _rec.value;
+        auto _const = arena.create<ConstFPNode>(_info(_rec), _value);
+        if (_listed)
+          const_fp_list.push_back(_const);
+        _nodes[i] = _const;
+        break;
+      }
+      case Node::ContainerTy: {
+        if (_rec.sub_kind == ContainerNode::SplitCallTy) {
+          _nodes[i] = split_call.get();
+          break;
+        }
+        auto _loop = arena.create<LoopNode>(_info(_rec));
+        if (_listed)
+          loop_nodes.push_back(_loop);
+        _nodes[i] = _loop;
+        break;
+      }
+      case Node::MemoryUnitTy: {
+        // The shared unit is numbered zero, the banks come after it
+        if (_rec.id == 0) {
+          _nodes[i] = memory_unit.get();
+          break;
+        }
+        auto _bank = arena.create<MemoryNode>(_info(_rec), true);
+        if (_listed)
+          memory_banks.push_back(_bank);
+        _nodes[i] = _bank;
+        break;
+      }
+      case Node::FloatingPointTy: _nodes[i] = floating_point_unit.get(); break;
+      case Node::FunctionArgTy:
+      case Node::StackUnitTy: break;
+      default: assert(!"Unknown node type in muIR file!");
+    }
+  }
+
+  for (uint32_t i = 0; i < _records.size(); i++) {
+    if (_nodes[i])
+      continue;
+
+    auto& _rec   = _records[i];
+    bool _listed = i < _file.getGraphNodes();
+
+    if (_rec.kind == Node::InstructionNodeTy) {
+      auto _call = _call_nodes.lookup(_rec.id);
+      assert(_call && "Call port without its call node in muIR file!");
+      if (_rec.sub_kind == InstructionNode::CallInInstructionTy) {
+        _call->getCallIn()->setParent(this);
+        if (_listed)
+          pushCallIn(_call->getCallIn());
+        _nodes[i] = _call->getCallIn();
+      } else {
+        _call->getCallOut()->setParent(this);
+        if (_listed)
+          pushCallOut(_call->getCallOut());
+        _nodes[i] = _call->getCallOut();
+      }
+    } else if (_rec.kind == Node::StackUnitTy) {
+      auto _mem =
+          arena.create<ScratchpadNode>(_info(_rec),
+                                       cast_or_null<AllocaNode>(_at(_rec.link)),
+                                       static_cast<uint32_t>(_rec.value),
+                                       static_cast<uint32_t>(_rec.value >> 32));
+      if (_listed)
+        scratchpad_memories.push_back(_mem);
+      _nodes[i] = _mem;
+    } else {
+      // Source nodes of the arguments are linked later, they can be
+      // arguments themselves
+      auto _container = cast_or_null<ContainerNode>(_at(_rec.parent));
+      auto _arg_type  = static_cast<ArgumentNode::ArgumentType>(_rec.sub_kind);
+      auto _data_type = static_cast<Node::DataType>(_rec.data_type);
+      if (_container) {
+        _nodes[i] = _container->pushArgument(
+            std::make_shared<ArgumentNode>(_info(_rec), _arg_type, _data_type, _container));
+      } else {
+        arg_list.push_back(arena.create<ArgumentNode>(_info(_rec), _arg_type, _data_type));
+        _nodes[i] = arg_list.back();
+      }
+    }
+  }
+
+  for (uint32_t i = 0; i < _records.size(); i++) {
+    auto& _rec = _records[i];
+    auto _node = _nodes[i];
+
+    if (auto _ins = dyn_cast<InstructionNode>(_node))
+      _ins->setParentNode(cast_or_null<SuperNode>(_at(_rec.parent)));
+    else if (auto _arg = dyn_cast<ArgumentNode>(_node))
+      _arg->setParentNode(_at(_rec.link));
+    _node->setDataWidth(_rec.data_width);
+
+    // Data and control ports keep their recorded IDs, memory ports are
+    // always numbered by their position
+    for (auto& _port : _file.getPorts(_rec.ports[DataInput]))
+      _node->addDataInputPort(_at(_port.node), _port.port);
+    for (auto& _port : _file.getPorts(_rec.ports[DataOutput]))
+      _node->addDataOutputPort(_at(_port.node), _port.port);
+    for (auto& _port : _file.getPorts(_rec.ports[ControlInput]))
+      _node->addControlInputPort(_at(_port.node), _port.port);
+    for (auto& _port : _file.getPorts(_rec.ports[ControlOutput]))
+      _node->addControlOutputPort(_at(_port.node), _port.port);
+    for (auto& _port : _file.getPorts(_rec.ports[MemoryReadRequest]))
+      _node->addReadMemoryReqPort(_at(_port.node));
+    for (auto& _port : _file.getPorts(_rec.ports[MemoryReadResponse]))
+      _node->addReadMemoryRespPort(_at(_port.node));
+    for (auto& _port : _file.getPorts(_rec.ports[MemoryWriteRequest]))
+      _node->addWriteMemoryReqPort(_at(_port.node));
+    for (auto& _port : _file.getPorts(_rec.ports[MemoryWriteResponse]))
+      _node->addWriteMemoryRespPort(_at(_port.node));
+  }
+
+  for (auto& _rec : _file.super_nodes()) {
+    auto _bb = cast<SuperNode>(_nodes[_rec.node]);
+    _bb->setNodeType(static_cast<SuperNode::SuperNodeType>(_rec.type));
+    for (auto _index : _file.getList(_rec.instructions))
+      _bb->addInstruction(cast<InstructionNode>(_nodes[_index]));
+    for (auto _index : _file.getList(_rec.phis))
+      _bb->addPhiInstruction(cast<PhiSelectNode>(_nodes[_index]));
+    for (auto _index : _file.getList(_rec.constants)) {
+      if (auto _const = dyn_cast<ConstIntNode>(_nodes[_index]))
+        _bb->addconstIntNode(_const);
+      else
+        _bb->addconstFPNode(cast<ConstFPNode>(_nodes[_index]));
+    }
+  }
+
+  for (auto& _rec : _file.loops()) {
+    auto _loop = cast<LoopNode>(_nodes[_rec.node]);
+    _loop->setParentLoop(cast_or_null<LoopNode>(_at(_rec.parent_loop)));
+    _loop->setIndeuctionVariable(cast_or_null<InstructionNode>(_at(_rec.induction)));
+    _loop->setTripCount(_rec.trip_count);
+    for (auto _index : _file.getList(_rec.blocks))
+      _loop->pushSuperNode(cast<SuperNode>(_nodes[_index]));
+  }
+
+  for (auto& _rec : _file.edges()) {
+    insertEdge(static_cast<Edge::EdgeType>(_rec.type),
+               Port(_at(_rec.src.node), PortID(_rec.src.port)),
+               Port(_at(_rec.tar.node), PortID(_rec.tar.port)));
+  }
+}
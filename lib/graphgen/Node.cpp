@@ -35,6 +35,183 @@ printFloatingPointIEEE754(FloatingPointIEEE754 _number) {
   return _output.str();
 }
 
+/**
+ * Memory type parameter of a load or store of _size bytes, empty unless the
+ * memory is packed. Sub-word loads are sign extended, the same as the
+ * constants and the other XLEN values of the datapath, so a load that feeds a
+ * compare or a sext directly sees the right value. Only 1, 2, 4 and 8 byte
+ * accesses are supported.
+ */
+static std::string
+printMemoryType(uint32_t _size) {
+  if (!packedMemory || _size == 0)
+    return "";
+
+  switch (_size) {
+    case 1: return ", Typ = MT_B";
+    case 2: return ", Typ = MT_H";
+    case 4: return ", Typ = MT_W";
+    case 8: return ", Typ = MT_D";
+    default: assert(!"Unsupported memory access size!"); return "";
+  }
+}
+
+/**
+ * Parameters of a node narrowed below XLEN, the module is built with an XLEN
+ * of its own. Empty for the full width nodes.
+ */
+static std::string
+printNarrowedParameters(Node* _node) {
+  if (!_node->isNarrowed())
+    return "";
+  return "(p.alterPartial({ case XLEN => " + std::to_string(_node->getDataWidth())
+         + " }))";
+}
+
+//===----------------------------------------------------------------------===//
+//                            PortList Class
+//===----------------------------------------------------------------------===//
+
+void
+PortList::rebuildIndex() {
+  node_index.clear();
+  for (uint32_t _pos = 0; _pos < entries.size(); ++_pos)
+    node_index[entries[_pos].first].push_back(_pos);
+}
+
+void
+PortList::push_back(PortEntry _entry) {
+  node_index[_entry.first].push_back(entries.size());
+  entries.push_back(_entry);
+}
+
+void
+PortList::resize(size_t _s) {
+  entries.resize(_s);
+  rebuildIndex();
+}
+
+PortList::iterator
+PortList::find(const Node* _node) {
+  auto ff = node_index.find(_node);
+  if (ff == node_index.end())
+    return entries.end();
+
+  return entries.begin() + ff->second.front();
+}
+
+bool
+PortList::contains(const Node* _node) const {
+  return node_index.count(_node) != 0;
+}
+
+size_t
+PortList::count(const Node* _node) const {
+  auto ff = node_index.find(_node);
+  return ff == node_index.end() ? 0 : ff->second.size();
+}
+
+std::list<PortEntry>
+PortList::findAll(const Node* _node) const {
+  std::list<PortEntry> result;
+  auto ff = node_index.find(_node);
+  if (ff == node_index.end())
+    return result;
+
+  for (auto _pos : ff->second)
+    result.push_back(entries[_pos]);
+  return result;
+}
+
+void
+PortList::remove(const Node* _node) {
+  if (!contains(_node))
+    return;
+
+  entries.erase(std::remove_if(entries.begin(),
+                               entries.end(),
+                               [_node](auto& arg) -> bool { return arg.first == _node; }),
+                entries.end());
+  rebuildIndex();
+}
+
+/**
+ * Replacing the first entry connected to src with tar
+ */
+void
+PortList::replaceNode(const Node* src, Node* tar) {
+  auto ff = node_index.find(src);
+  if (ff == node_index.end() || src == tar)
+    return;
+
+  auto _pos = ff->second.front();
+  ff->second.erase(ff->second.begin());
+  if (ff->second.empty())
+    node_index.erase(ff);
+
+  entries[_pos].first = tar;
+  auto& _tar_pos      = node_index[tar];
+  _tar_pos.insert(std::upper_bound(_tar_pos.begin(), _tar_pos.end(), _pos), _pos);
+}
+
+void
+PortList::remap(function_ref<Node*(Node*)> _fn) {
+  uint32_t _id = 0;
+  auto _kept   = entries.begin();
+  for (auto& _entry : entries) {
+    auto _node = _fn(_entry.first);
+    if (!_node)
+      continue;
+    _kept->first = _node;
+    _kept->second.setID(_id++);
+    ++_kept;
+  }
+  entries.erase(_kept, entries.end());
+  rebuildIndex();
+}
+
+//===----------------------------------------------------------------------===//
+//                            PortExpression Class
+//===----------------------------------------------------------------------===//
+
+void
+PortExpression::write(raw_ostream& _out) const {
+  switch (kind) {
+    case InputEnable:
+      if (arg == NoArg)
+        node->emitInputEnable(_out, pt);
+      else if (arg == IndexArg)
+        node->emitInputEnable(_out, pt, index);
+      else
+        node->emitInputEnable(_out, pt, entry);
+      break;
+    case OutputEnable:
+      if (arg == NoArg)
+        node->emitOutputEnable(_out, pt);
+      else if (arg == IndexArg)
+        node->emitOutputEnable(_out, pt, index);
+      else
+        node->emitOutputEnable(_out, pt, entry);
+      break;
+    case InputData:
+      if (arg == NoArg)
+        node->emitInputData(_out, pt);
+      else
+        node->emitInputData(_out, pt, index);
+      break;
+    case OutputData:
+      if (arg == NoArg)
+        node->emitOutputData(_out, pt);
+      else
+        node->emitOutputData(_out, pt, index);
+      break;
+    case MemReadInput: node->emitMemReadInput(_out, pt, index); break;
+    case MemReadOutput: node->emitMemReadOutput(_out, pt, index); break;
+    case MemWriteInput: node->emitMemWriteInput(_out, pt, index); break;
+    case MemWriteOutput: node->emitMemWriteOutput(_out, pt, index); break;
+  }
+}
+
 //===----------------------------------------------------------------------===//
 //                            Node Class
 //===----------------------------------------------------------------------===//
@@ -42,129 +219,113 @@ printFloatingPointIEEE754(FloatingPointIEEE754 _number) {
 PortID
 Node::addDataInputPort(Node* n) {
   auto _port_info = PortID(port_data.data_input_port.size());
-  port_data.data_input_port.emplace_back(std::make_pair(n, _port_info));
+  port_data.data_input_port.push_back(std::make_pair(n, _port_info));
   return _port_info;
 }
 
 PortID
 Node::addDataInputPort(Node* n, uint32_t _id) {
   auto _port_info = PortID(_id);
-  port_data.data_input_port.emplace_back(std::make_pair(n, _port_info));
+  port_data.data_input_port.push_back(std::make_pair(n, _port_info));
   return _port_info;
 }
 
 PortID
 Node::addDataOutputPort(Node* n) {
   auto _port_info = PortID(port_data.data_output_port.size());
-  port_data.data_output_port.emplace_back(std::make_pair(n, _port_info));
+  port_data.data_output_port.push_back(std::make_pair(n, _port_info));
   return _port_info;
 }
 
 PortID
 Node::addDataOutputPort(Node* n, uint32_t _id) {
   auto _port_info = PortID(_id);
-  port_data.data_output_port.emplace_back(std::make_pair(n, _port_info));
+  port_data.data_output_port.push_back(std::make_pair(n, _port_info));
   return _port_info;
 }
 
 PortID
 Node::addControlInputPort(Node* n) {
   auto _port_info = PortID(port_control.control_input_port.size());
-  port_control.control_input_port.emplace_back(std::make_pair(n, _port_info));
+  port_control.control_input_port.push_back(std::make_pair(n, _port_info));
   return _port_info;
 }
 
 PortID
 Node::addControlInputPort(Node* n, uint32_t _id) {
   auto _port_info = PortID(_id);
-  port_control.control_input_port.emplace_back(std::make_pair(n, _port_info));
+  port_control.control_input_port.push_back(std::make_pair(n, _port_info));
   return _port_info;
 }
 
 PortID
 Node::addControlOutputPort(Node* n) {
   auto _port_info = PortID(port_control.control_output_port.size());
-  port_control.control_output_port.emplace_back(std::make_pair(n, _port_info));
+  port_control.control_output_port.push_back(std::make_pair(n, _port_info));
   return _port_info;
 }
 
 PortID
 Node::addControlOutputPort(Node* n, uint32_t _id) {
   auto _port_info = PortID(_id);
-  port_control.control_output_port.emplace_back(std::make_pair(n, _port_info));
+  port_control.control_output_port.push_back(std::make_pair(n, _port_info));
   return _port_info;
 }
 
 PortID
 Node::addReadMemoryReqPort(Node* const n) {
   auto _port_info = PortID(read_port_data.memory_req_port.size());
-  read_port_data.memory_req_port.emplace_back(std::make_pair(n, _port_info));
+  read_port_data.memory_req_port.push_back(std::make_pair(n, _port_info));
   return _port_info;
 }
 
 PortID
 Node::addReadMemoryRespPort(Node* const n) {
   auto _port_info = PortID(read_port_data.memory_resp_port.size());
-  read_port_data.memory_resp_port.emplace_back(std::make_pair(n, _port_info));
+  read_port_data.memory_resp_port.push_back(std::make_pair(n, _port_info));
   return _port_info;
 }
 
 PortID
 Node::addWriteMemoryReqPort(Node* const n) {
   auto _port_info = PortID(write_port_data.memory_req_port.size());
-  write_port_data.memory_req_port.emplace_back(std::make_pair(n, _port_info));
+  write_port_data.memory_req_port.push_back(std::make_pair(n, _port_info));
   return _port_info;
 }
 
 PortID
 Node::addWriteMemoryRespPort(Node* const n) {
   auto _port_info = PortID(write_port_data.memory_resp_port.size());
-  write_port_data.memory_resp_port.emplace_back(std::make_pair(n, _port_info));
+  write_port_data.memory_resp_port.push_back(std::make_pair(n, _port_info));
   return _port_info;
 }
 
 Node*
 Node::returnControlOutputPortNode(uint32_t index) {
-  auto node = port_control.control_output_port.begin();
-  std::advance(node, index);
-  return node->first;
+  return port_control.control_output_port[index].first;
 }
 
 PortID
 Node::returnDataOutputPortIndex(Node* _node) {
-  auto ff = std::find_if(this->port_data.data_output_port.begin(),
-                         this->port_data.data_output_port.end(),
-                         [&_node](auto& arg) -> bool { return arg.first == _node; });
+  auto ff = this->port_data.data_output_port.find(_node);
   if (ff == this->port_data.data_output_port.end())
     assert(!"Node doesn't exist\n");
 
-  return find_if(this->port_data.data_output_port.begin(),
-                 this->port_data.data_output_port.end(),
-                 [&_node](auto& arg) -> bool { return arg.first == _node; })
-      ->second;
+  return ff->second;
 }
 
 PortID
 Node::returnDataInputPortIndex(Node* _node) {
-  auto ff = std::find_if(this->port_data.data_input_port.begin(),
-                         this->port_data.data_input_port.end(),
-                         [&_node](auto& arg) -> bool { return arg.first == _node; });
-
+  auto ff = this->port_data.data_input_port.find(_node);
   if (ff == this->port_data.data_input_port.end())
     assert(!"Node doesn't exist\n");
 
-  return find_if(this->port_data.data_input_port.begin(),
-                 this->port_data.data_input_port.end(),
-                 [&_node](auto& arg) -> bool { return arg.first == _node; })
-      ->second;
+  return ff->second;
 }
 
 PortID
 Node::returnControlOutputPortIndex(Node* _node) {
-  auto ff = std::find_if(this->port_control.control_output_port.begin(),
-                         this->port_control.control_output_port.end(),
-                         [&_node](auto& arg) -> bool { return arg.first == _node; });
-
+  auto ff = this->port_control.control_output_port.find(_node);
   if (ff == this->port_control.control_output_port.end())
     assert(!"Node doesn't exist\n");
 
@@ -173,10 +334,7 @@ Node::returnControlOutputPortIndex(Node* _node) {
 
 PortID
 Node::returnControlInputPortIndex(Node* _node) {
-  auto ff = find_if(this->port_control.control_input_port.begin(),
-                    this->port_control.control_input_port.end(),
-                    [&_node](auto& arg) -> bool { return arg.first == _node; });
-
+  auto ff = this->port_control.control_input_port.find(_node);
   if (ff == this->port_control.control_input_port.end())
     throw std::runtime_error("Input node doesn't exist");
 
@@ -185,148 +343,93 @@ Node::returnControlInputPortIndex(Node* _node) {
 
 bool
 Node::existControlInput(Node* _node) {
-  return find_if(this->port_control.control_input_port.begin(),
-                 this->port_control.control_input_port.end(),
-                 [&_node](auto& arg) -> bool { return arg.first == _node; })
-         != this->port_control.control_input_port.end();
+  return this->port_control.control_input_port.contains(_node);
 }
 
 bool
 Node::existControlOutput(Node* _node) {
-  return find_if(this->port_control.control_output_port.begin(),
-                 this->port_control.control_output_port.end(),
-                 [&_node](auto& arg) -> bool { return arg.first == _node; })
-         != this->port_control.control_output_port.end();
+  return this->port_control.control_output_port.contains(_node);
 }
 
 bool
 Node::existDataInput(Node* _node) {
-  return find_if(this->port_data.data_input_port.begin(),
-                 this->port_data.data_input_port.end(),
-                 [&_node](auto& arg) -> bool { return arg.first == _node; })
-         != this->port_data.data_input_port.end();
+  return this->port_data.data_input_port.contains(_node);
 }
 
 bool
 Node::existDataOutput(Node* _node) {
-  return find_if(this->port_data.data_output_port.begin(),
-                 this->port_data.data_output_port.end(),
-                 [&_node](auto& arg) -> bool { return arg.first == _node; })
-         != this->port_data.data_output_port.end();
+  return this->port_data.data_output_port.contains(_node);
 }
 
 // Return memory indexes
 PortID
 Node::returnMemoryReadInputPortIndex(Node* _node) {
-  return find_if(this->read_port_data.memory_req_port.begin(),
-                 this->read_port_data.memory_req_port.end(),
-                 [&_node](auto& arg) -> bool { return arg.first == _node; })
-      ->second;
+  return this->read_port_data.memory_req_port.find(_node)->second;
 }
 
 PortID
 Node::returnMemoryReadOutputPortIndex(Node* _node) {
-  return find_if(this->read_port_data.memory_resp_port.begin(),
-                 this->read_port_data.memory_resp_port.end(),
-                 [&_node](auto& arg) -> bool { return arg.first == _node; })
-      ->second;
+  return this->read_port_data.memory_resp_port.find(_node)->second;
 }
 
 PortID
 Node::returnMemoryWriteInputPortIndex(Node* _node) {
-  return find_if(this->write_port_data.memory_req_port.begin(),
-                 this->write_port_data.memory_req_port.end(),
-                 [&_node](auto& arg) -> bool { return arg.first == _node; })
-      ->second;
+  return this->write_port_data.memory_req_port.find(_node)->second;
 }
 
 PortID
 Node::returnMemoryWriteOutputPortIndex(Node* _node) {
-  return find_if(this->write_port_data.memory_resp_port.begin(),
-                 this->write_port_data.memory_resp_port.end(),
-                 [&_node](auto& arg) -> bool { return arg.first == _node; })
-      ->second;
+  return this->write_port_data.memory_resp_port.find(_node)->second;
 }
 
-std::list<PortEntry>::iterator
+PortList::iterator
 Node::findDataInputNode(Node* _node) {
-  return find_if(this->port_data.data_input_port.begin(),
-                 this->port_data.data_input_port.end(),
-                 [_node](auto& arg) -> bool { return arg.first == _node; });
+  return this->port_data.data_input_port.find(_node);
 }
 
-std::list<PortEntry>::iterator
+PortList::iterator
 Node::findDataOutputNode(Node* _node) {
-  return find_if(this->port_data.data_output_port.begin(),
-                 this->port_data.data_output_port.end(),
-                 [_node](auto& arg) -> bool { return arg.first == _node; });
+  return this->port_data.data_output_port.find(_node);
 }
 
-std::list<PortEntry>::iterator
+PortList::iterator
 Node::findControlInputNode(Node* _node) {
-  return find_if(this->port_control.control_input_port.begin(),
-                 this->port_control.control_input_port.end(),
-                 [_node](auto& arg) -> bool { return arg.first == _node; });
+  return this->port_control.control_input_port.find(_node);
 }
 
-std::list<PortEntry>::iterator
+PortList::iterator
 Node::findControlOutputNode(Node* _node) {
-  return find_if(this->port_control.control_output_port.begin(),
-                 this->port_control.control_output_port.end(),
-                 [_node](auto& arg) -> bool { return arg.first == _node; });
+  return this->port_control.control_output_port.find(_node);
 }
 
 std::list<PortEntry>
 Node::findDataInputNodeList(Node* _node) {
-  std::list<PortEntry> result;
-  copy_if(this->port_data.data_input_port.begin(),
-          this->port_data.data_input_port.end(),
-          std::back_inserter(result),
-          [_node](auto& arg) -> bool { return arg.first == _node; });
-  return result;
+  return this->port_data.data_input_port.findAll(_node);
 }
 
 std::list<PortEntry>
 Node::findDataOutputNodeList(Node* _node) {
-  std::list<PortEntry> result;
-  copy_if(this->port_data.data_output_port.begin(),
-          this->port_data.data_output_port.end(),
-          std::back_inserter(result),
-          [_node](auto& arg) -> bool { return arg.first == _node; });
-  return result;
+  return this->port_data.data_output_port.findAll(_node);
 }
 
 std::list<PortEntry>
 Node::findControlInputNodeList(Node* _node) {
-  std::list<PortEntry> result;
-  copy_if(this->port_control.control_input_port.begin(),
-          this->port_control.control_input_port.end(),
-          std::back_inserter(result),
-          [_node](auto& arg) -> bool { return arg.first == _node; });
-  return result;
+  return this->port_control.control_input_port.findAll(_node);
 }
 
 std::list<PortEntry>
 Node::findControlOutputNodeList(Node* _node) {
-  std::list<PortEntry> result;
-  copy_if(this->port_control.control_output_port.begin(),
-          this->port_control.control_output_port.end(),
-          std::back_inserter(result),
-          [_node](auto& arg) -> bool { return arg.first == _node; });
-
-  return result;
+  return this->port_control.control_output_port.findAll(_node);
 }
 
 void
 Node::removeNodeDataInputNode(Node* _node) {
-  this->port_data.data_input_port.remove_if(
-      [_node](auto& arg) -> bool { return arg.first == _node; });
+  this->port_data.data_input_port.remove(_node);
 }
 
 void
 Node::removeNodeDataOutputNode(Node* _node) {
-  this->port_data.data_output_port.remove_if(
-      [_node](auto& arg) -> bool { return arg.first == _node; });
+  this->port_data.data_output_port.remove(_node);
 
   // Updating portIDs
   uint32_t _id = 0;
@@ -337,78 +440,51 @@ Node::removeNodeDataOutputNode(Node* _node) {
 
 void
 Node::removeNodeControlInputNode(Node* _node) {
-  this->port_control.control_input_port.remove_if(
-      [_node](auto& arg) -> bool { return arg.first == _node; });
+  this->port_control.control_input_port.remove(_node);
 }
 
 void
 Node::removeNodeControlOutputNode(Node* _node) {
-  this->port_control.control_output_port.remove_if(
-      [_node](auto& arg) -> bool { return arg.first == _node; });
+  this->port_control.control_output_port.remove(_node);
 }
 
 void
-Node::replaceControlInputNode(Node* src, Node* tar) {
-  // std::replace(this->port_control.control_input_port.begin(),
-  // this->port_control.control_input_port.end(), src, tar);
-  auto count = std::count_if(port_control.control_input_port.begin(),
-                             port_control.control_input_port.end(),
-                             [src](auto& arg) -> bool { return arg.first == src; });
+Node::remapControlOutputNodes(function_ref<Node*(Node*)> _fn) {
+  this->port_control.control_output_port.remap(_fn);
+}
 
-  assert(count == 1 && "Can not have multiple edge from one node to another!");
+void
+Node::replaceControlInputNode(Node* src, Node* tar) {
+  assert(port_control.control_input_port.count(src) == 1
+         && "Can not have multiple edge from one node to another!");
 
-  auto _src_node   = std::find_if(port_control.control_input_port.begin(),
-                                port_control.control_input_port.end(),
-                                [src](auto& arg) -> bool { return arg.first == src; });
-  _src_node->first = tar;
+  port_control.control_input_port.replaceNode(src, tar);
 }
 
 void
 Node::replaceControlOutputNode(Node* src, Node* tar) {
   // We can't replace if we have multiple edge from src to dst
   // with different port numbers
-  // std::replace(port_control.control_output_port.begin(),
-  // port_control.control_output_port.end(), src, tar);
-  auto count = std::count_if(port_control.control_output_port.begin(),
-                             port_control.control_output_port.end(),
-                             [src](auto& arg) -> bool { return arg.first == src; });
-
-  assert(count == 1 && "Can not have multiple edge from one node to another!");
+  assert(port_control.control_output_port.count(src) == 1
+         && "Can not have multiple edge from one node to another!");
 
-  auto _src_node   = std::find_if(port_control.control_output_port.begin(),
-                                port_control.control_output_port.end(),
-                                [src](auto& arg) -> bool { return arg.first == src; });
-  _src_node->first = tar;
+  port_control.control_output_port.replaceNode(src, tar);
 }
 
 void
 Node::replaceDataInputNode(Node* src, Node* tar) {
-  auto count = std::count_if(port_data.data_input_port.begin(),
-                             port_data.data_input_port.end(),
-                             [src](auto& arg) -> bool { return arg.first == src; });
+  assert(port_data.data_input_port.count(src) == 1
+         && "Can not have multiple edge from one node to another!");
 
-  assert(count == 1 && "Can not have multiple edge from one node to another!");
-
-  auto _src_node   = std::find_if(port_data.data_input_port.begin(),
-                                port_data.data_input_port.end(),
-                                [src](auto& arg) -> bool { return arg.first == src; });
-  _src_node->first = tar;
+  port_data.data_input_port.replaceNode(src, tar);
 }
 
 void
 Node::replaceDataOutputNode(Node* src, Node* tar) {
-  // std::replace(port_data.data_output_port.begin(),
-  // port_data.data_output_port.end(), src, tar);
-  auto count = std::count_if(port_data.data_output_port.begin(),
-                             port_data.data_output_port.end(),
-                             [src](auto& arg) -> bool { return arg.first == src; });
-
-  assert(count == 1 && "Can not have multiple edge from one node to another!");
+  assert(port_data.data_output_port.count(src) == 1
+         && "Can not have multiple edge from one node to another!");
 
-  auto _src_node   = std::find_if(port_data.data_output_port.begin(),
-                                port_data.data_output_port.end(),
-                                [src](auto& arg) -> bool { return arg.first == src; });
-  _src_node->first = tar;
+  port_data.data_output_port.replaceNode(src, tar);
 }
 
 //===----------------------------------------------------------------------===//
@@ -435,130 +511,134 @@ SuperNode::addconstFPNode(ConstFPNode* node) {
   this->const_fp_list.push_back(node);
 }
 
+void
+SuperNode::remapInstructions(function_ref<InstructionNode*(InstructionNode*)> _fn) {
+  for (auto _it = instruction_list.begin(); _it != instruction_list.end();) {
+    if (auto _node = _fn(*_it)) {
+      *_it = _node;
+      ++_it;
+    } else {
+      _it = instruction_list.erase(_it);
+    }
+  }
+}
+
+void
+SuperNode::removeconstIntNodes(function_ref<bool(ConstIntNode*)> _fn) {
+  const_int_list.remove_if(_fn);
+}
+
 std::string
 SuperNode::printDefinition(PrintType pt) {
   string _text;
-  string _name(this->getName());
+  auto& _name = this->getScalaName();
   switch (pt) {
-    case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "  val $name = Module(new $type(NumInputs = $num_in, NumOuts = "
-              "$num_out, BID = $bid))\n\n";
-
+    case PrintType::Scala: {
+      static const TemplateString _tmpl_no_mask(
+          "  val $name = Module(new $type(NumInputs = $num_in, NumOuts = "
+          "$num_out, BID = $bid))\n\n",
+          {"$type", "$name", "$num_in", "$num_out", "$bid", "$num_phi"});
+      static const TemplateString _tmpl_mask(
+          "  val $name = Module(new $type("
+          "NumInputs = $num_in, "
+          "NumOuts = "
+          "$num_out, NumPhi = $num_phi, BID = $bid))\n\n",
+          {"$type", "$name", "$num_in", "$num_out", "$bid", "$num_phi"});
+
+      auto& _tmpl =
+          this->getNodeType() == SuperNodeType::Mask ? _tmpl_mask : _tmpl_no_mask;
+      string _type;
       switch (this->getNodeType()) {
         case SuperNodeType::NoMask:
-          helperReplace(
-              _text,
-              "$type",
-              HWoptLevel == '1' ? "BasicBlockNoMaskFastNode" : "BasicBlockNoMaskNode");
-          break;
-        case SuperNodeType::Mask:
-          _text = "  val $name = Module(new $type("
-                  "NumInputs = $num_in, "
-                  "NumOuts = "
-                  "$num_out, NumPhi = $num_phi, BID = $bid))\n\n";
-          helperReplace(_text, "$type", "BasicBlockNode");
+          _type = HWoptLevel >= '1' ? "BasicBlockNoMaskFastNode" : "BasicBlockNoMaskNode";
           break;
+        case SuperNodeType::Mask: _type = "BasicBlockNode"; break;
       }
 
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$num_in", this->numControlInputPort());
-      helperReplace(_text, "$num_out", std::to_string(this->numControlOutputPort()));
-      helperReplace(_text, "$bid", this->getID());
-      helperReplace(_text, "$num_phi", this->getNumPhi());
+      _text = _tmpl.render({_type,
+                            _name.c_str(),
+                            this->numControlInputPort(),
+                            std::to_string(this->numControlOutputPort()),
+                            this->getID(),
+                            this->getNumPhi()});
 
-      break;
+    } break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
   return _text;
 }
 
-std::string
-SuperNode::printInputEnable(PrintType _pt, uint32_t _id) {
-  string _name(this->getName());
-  std::replace(_name.begin(), _name.end(), '.', '_');
-  string _text;
+void
+SuperNode::emitInputEnable(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      _text = "$name.io.predicateIn($id)";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _id);
+      static const TemplateString _tmpl("$name.io.predicateIn($id)", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _id});
       break;
     default: break;
   }
-
-  return _text;
 }
 
-std::string
-SuperNode::printInputEnable(PrintType pt, std::pair<Node*, PortID> _node) {
-  string _text;
-  string _name(this->getName());
+void
+SuperNode::emitInputEnable(raw_ostream& _out,
+                           PrintType pt,
+                           std::pair<Node*, PortID> _node) {
+  auto& _name = this->getScalaName();
   switch (pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      if (this->getNodeType() == SuperNode::Mask)
-        _text = "$name.io.predicateIn($id)";
+      static const TemplateString _tmpl_id("$name.io.predicateIn($id)", {"$name", "$id"});
+      static const TemplateString _tmpl("$name.io.predicateIn", {"$name"});
+      if (this->getNodeType() == SuperNode::Mask || HWoptLevel >= '1')
+        _tmpl_id.render(_out, {_name.c_str(), _node.second.getID()});
       else
-        _text = HWoptLevel == '1' ? "$name.io.predicateIn($id)" : "$name.io.predicateIn";
-
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _node.second.getID());
+        _tmpl.render(_out, {_name.c_str()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-SuperNode::printOutputEnable(PrintType pt, uint32_t _id) {
-  string _text;
-  string _name(this->getName());
+void
+SuperNode::emitOutputEnable(raw_ostream& _out, PrintType pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.Out($id)";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _id);
+      static const TemplateString _tmpl("$name.io.Out($id)", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _id});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-SuperNode::printOutputEnable(PrintType pt, std::pair<Node*, PortID> _node) {
-  string _text;
-  string _name(this->getName());
+void
+SuperNode::emitOutputEnable(raw_ostream& _out,
+                            PrintType pt,
+                            std::pair<Node*, PortID> _node) {
+  auto& _name = this->getScalaName();
   switch (pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.Out($id)";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _node.second.getID());
+      static const TemplateString _tmpl("$name.io.Out($id)", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _node.second.getID()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
 std::string
 SuperNode::printMaskOutput(PrintType pt, uint32_t _id) {
   string _text;
-  string _name(this->getName());
+  auto& _name = this->getScalaName();
   switch (pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.MaskBB($id)";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _id);
+      static const TemplateString _tmpl("$name.io.MaskBB($id)", {"$name", "$id"});
+      _text = _tmpl.render({_name.c_str(), _id});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
@@ -570,12 +650,11 @@ SuperNode::printMaskOutput(PrintType pt, uint32_t _id) {
 std::string
 SuperNode::printActivateEnable(PrintType pt) {
   string _text;
-  string _name(this->getName());
+  auto& _name = this->getScalaName();
   switch (pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.activate";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.activate", {"$name"});
+      _text = _tmpl.render({_name.c_str()});
       // helperReplace(_text, "$id", _id);
 
       break;
@@ -592,22 +671,31 @@ SuperNode::printActivateEnable(PrintType pt) {
 std::string
 MemoryNode::printDefinition(PrintType pt) {
   string _text;
-  string _name(this->getName());
+  auto& _name = this->getScalaName();
   switch (pt) {
     case PrintType::Scala: {
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "  //Cache\n"
-              "  val $name = Module(new $module_type(ID = $id, NumRead = "
-              "$num_rd, NumWrite = $num_wr))\n"
-              "\n"
-              "  io.MemReq <> $name.io.cache.MemReq\n"
-              "  $name.io.cache.MemResp <> io.MemResp\n\n";
-      ;
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$module_type", "CacheMemoryEngine");
-      helperReplace(_text, "$id", std::to_string(this->getID()));
-      helperReplace(_text, "$num_rd", this->numReadDataInputPort());
-      helperReplace(_text, "$num_wr", this->numWriteDataInputPort());
+      static const TemplateString _tmpl(
+          "  //Cache\n"
+          "  val $name = Module(new $module_type(ID = $id, NumRead = "
+          "$num_rd, NumWrite = $num_wr))\n"
+          "\n"
+          "  io.MemReq <> $name.io.cache.MemReq\n"
+          "  $name.io.cache.MemResp <> io.MemResp\n\n",
+          {"$name", "$module_type", "$id", "$num_rd", "$num_wr"});
+      static const TemplateString _bank_tmpl(
+          "  //Memory bank\n"
+          "  val $name = Module(new $module_type(ID = $id, NumRead = "
+          "$num_rd, NumWrite = $num_wr))\n"
+          "\n"
+          "  $name_mem_req <> $name.io.cache.MemReq\n"
+          "  $name.io.cache.MemResp <> $name_mem_resp\n\n",
+          {"$name", "$module_type", "$id", "$num_rd", "$num_wr"});
+      _text = (bank ? _bank_tmpl : _tmpl)
+                  .render({_name.c_str(),
+                           "CacheMemoryEngine",
+                           std::to_string(this->getID()),
+                           this->numReadDataInputPort(),
+                           this->numWriteDataInputPort()});
 
     } break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
@@ -616,86 +704,65 @@ MemoryNode::printDefinition(PrintType pt) {
   return _text;
 }
 
-std::string
-MemoryNode::printMemReadInput(PrintType _pt, uint32_t _id) {
-  string _name(this->getName());
-  std::replace(_name.begin(), _name.end(), '.', '_');
-  string _text;
+void
+MemoryNode::emitMemReadInput(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      _text = "$name.io.rd.mem($mid).MemReq";
-
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$mid", _id);
+      static const TemplateString _tmpl("$name.io.rd.mem($mid).MemReq",
+                                        {"$name", "$mid"});
+      _tmpl.render(_out, {_name.c_str(), _id});
       // TODO add mid
       break;
     default: break;
   }
-
-  return _text;
 }
 
-std::string
-MemoryNode::printMemReadOutput(PrintType _pt, uint32_t _id) {
-  string _name(this->getName());
-  std::replace(_name.begin(), _name.end(), '.', '_');
-  string _text;
+void
+MemoryNode::emitMemReadOutput(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      _text = "$name.io.rd.mem($mid).MemResp";
-
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$mid", _id);
+      static const TemplateString _tmpl("$name.io.rd.mem($mid).MemResp",
+                                        {"$name", "$mid"});
+      _tmpl.render(_out, {_name.c_str(), _id});
       // TODO add mid
       break;
     default: break;
   }
-
-  return _text;
 }
 
-std::string
-MemoryNode::printMemWriteInput(PrintType _pt, uint32_t _id) {
-  string _name(this->getName());
-  std::replace(_name.begin(), _name.end(), '.', '_');
-  string _text;
+void
+MemoryNode::emitMemWriteInput(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      _text = "$name.io.wr.mem($mid).MemReq";
-
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$mid", _id);
+      static const TemplateString _tmpl("$name.io.wr.mem($mid).MemReq",
+                                        {"$name", "$mid"});
+      _tmpl.render(_out, {_name.c_str(), _id});
       // TODO add mid
       break;
     default: break;
   }
-
-  return _text;
 }
 
-std::string
-MemoryNode::printMemWriteOutput(PrintType _pt, uint32_t _id) {
-  string _name(this->getName());
-  std::replace(_name.begin(), _name.end(), '.', '_');
-  string _text;
+void
+MemoryNode::emitMemWriteOutput(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      _text = "$name.io.wr.mem($mid).MemResp";
-
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$mid", _id);
+      static const TemplateString _tmpl("$name.io.wr.mem($mid).MemResp",
+                                        {"$name", "$mid"});
+      _tmpl.render(_out, {_name.c_str(), _id});
       // TODO add mid
       break;
     default: break;
   }
-
-  return _text;
 }
 
 std::string
 MemoryNode::printUninitilizedUnit(PrintType _pt) {
-  string _name(this->getName());
-  std::replace(_name.begin(), _name.end(), '.', '_');
+  auto& _name = this->getScalaName();
   string _text;
   switch (_pt) {
     case PrintType::Scala:
@@ -710,6 +777,29 @@ MemoryNode::printUninitilizedUnit(PrintType _pt) {
   return _text;
 }
 
+/**
+ * Memory interface of a bank, it is connected to the memory arbiter of the
+ * root accelerator
+ */
+std::string
+MemoryNode::printMemIO(PrintType _pt) {
+  auto& _name = this->getScalaName();
+  string _text;
+  switch (_pt) {
+    case PrintType::Scala: {
+      static const TemplateString _tmpl(
+          "  val $name_mem_req = IO(Decoupled(new MemReq))\n"
+          "  val $name_mem_resp = IO(Flipped(Valid(new MemResp)))\n\n",
+          {"$name"});
+      _text = _tmpl.render({_name.c_str()});
+      break;
+    }
+    default: break;
+  }
+
+  return _text;
+}
+
 //===----------------------------------------------------------------------===//
 //                            ContainerNode Class
 //===----------------------------------------------------------------------===//
@@ -843,6 +933,25 @@ ContainerNode::insertCarryDepenArgument(llvm::Value* _val,
   return ff->get();
 }
 
+ArgumentNode*
+ContainerNode::pushArgument(std::shared_ptr<ArgumentNode> _arg) {
+  switch (_arg->getArgType()) {
+    case ArgumentNode::LiveIn:
+      if (_arg->getDataArgType() == Node::PointerType)
+        live_in_ptrs.push_back(_arg);
+      else
+        live_in_vals.push_back(_arg);
+      break;
+    case ArgumentNode::LoopLiveIn: live_in.push_back(_arg); break;
+    case ArgumentNode::LiveOut:
+    case ArgumentNode::LoopLiveOut: live_out.push_back(_arg); break;
+    case ArgumentNode::CarryDependency: carry_depen.push_back(_arg); break;
+    default: assert(!"Argument type is unkonw!");
+  }
+
+  return _arg.get();
+}
+
 Node*
 ContainerNode::findLiveInNode(llvm::Value* _val) {
   Node* return_ptr = nullptr;
@@ -1068,7 +1177,7 @@ ContainerNode::numCarryDepenArgList(ArgumentNode::ArgumentType type) {
 std::string
 SplitCallNode::printDefinition(PrintType _pt) {
   string _text("");
-  string _name(this->getName());
+  auto& _name = this->getScalaName();
 
   auto make_argument_port = [](const auto& _list) {
     std::vector<uint32_t> _arg_count;
@@ -1079,15 +1188,12 @@ SplitCallNode::printDefinition(PrintType _pt) {
 
   switch (_pt) {
     case PrintType::Scala: {
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "  val $name = Module(new $type(ptrsArgTypes = "
-              "List($<ptrs_input_vector>), valsArgTypes = "
-              "List($<vals_input_vector>)))\n"
-              "  $name.io.In <> io.in\n\n";
-
-      helperReplace(_text, "$name", _name);
-      helperReplace(_text, "$type", "SplitCallDCR");
-      helperReplace(_text, "$id", std::to_string(this->getID()));
+      static const TemplateString _tmpl(
+          "  val $name = Module(new $type(ptrsArgTypes = "
+          "List($<ptrs_input_vector>), valsArgTypes = "
+          "List($<vals_input_vector>)))\n"
+          "  $name.io.In <> io.in\n\n",
+          {"$name", "$type", "$id", "$<ptrs_input_vector>", "$<vals_input_vector>"});
 
       // TODO make a list of liveins first
       auto find_function = [](auto& node) {
@@ -1104,10 +1210,11 @@ SplitCallNode::printDefinition(PrintType _pt) {
                    std::back_inserter(_local_list_vals),
                    find_function);
 
-      helperReplace(
-          _text, "$<ptrs_input_vector>", make_argument_port(_local_list_ptrs), ", ");
-      helperReplace(
-          _text, "$<vals_input_vector>", make_argument_port(_local_list_vals), ", ");
+      _text = _tmpl.render({_name,
+                            "SplitCallDCR",
+                            std::to_string(this->getID()),
+                            TemplateArg(make_argument_port(_local_list_ptrs), ", "),
+                            TemplateArg(make_argument_port(_local_list_vals), ", ")});
 
       break;
     }
@@ -1117,38 +1224,31 @@ SplitCallNode::printDefinition(PrintType _pt) {
   return _text;
 }
 
-std::string
-SplitCallNode::printOutputEnable(PrintType _pt, uint32_t _id) {
-  string _name(this->getName());
-  std::replace(_name.begin(), _name.end(), '.', '_');
-  string _text;
+void
+SplitCallNode::emitOutputEnable(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      _text = "$name.io.Out.enable";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.Out.enable", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
       break;
     default: break;
   }
-
-  return _text;
 }
 
-std::string
-SplitCallNode::printOutputData(PrintType _pt, uint32_t _idx) {
-  string _text;
-  string _name(this->getName());
+void
+SplitCallNode::emitOutputData(raw_ostream& _out, PrintType _pt, uint32_t _idx) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.Out.data(\"field$id\")";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _idx);
+      static const TemplateString _tmpl("$name.io.Out.data(\"field$id\")",
+                                        {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _idx});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
 //===----------------------------------------------------------------------===//
@@ -1157,20 +1257,7 @@ SplitCallNode::printOutputData(PrintType _pt, uint32_t _idx) {
 
 void
 BranchNode::replaceControlOutputNode(Node* src, Node* tar) {
-  // We can't replace if we have multiple edge from src to dst
-  // with different port numbers
-  // std::replace(port_control.control_output_port.begin(),
-  // port_control.control_output_port.end(), src, tar);
-  auto count = std::count_if(outputControl_begin(),
-                             outputControl_end(),
-                             [src](auto& arg) -> bool { return arg.first == src; });
-
-  assert(count == 1 && "Can not have multiple edge from one node to another!");
-
-  auto _src_node   = std::find_if(outputControl_begin(),
-                                outputControl_end(),
-                                [src](auto& arg) -> bool { return arg.first == src; });
-  _src_node->first = tar;
+  Node::replaceControlOutputNode(src, tar);
 
   auto _src_predicate = std::find_if(
       output_predicate.begin(), output_predicate.end(), [src](auto& arg) -> bool {
@@ -1182,37 +1269,29 @@ BranchNode::replaceControlOutputNode(Node* src, Node* tar) {
   output_predicate.splice(output_predicate.end(), output_predicate, _src_predicate);
 }
 
-std::string
-BranchNode::printInputEnable(PrintType _pt, uint32_t _id) {
-  string _name(this->getName());
-  std::replace(_name.begin(), _name.end(), '.', '_');
-  string _text;
+void
+BranchNode::emitInputEnable(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      _text = "$name.io.PredOp($id)";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.PredOp($id)", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _id - 1});
       // std::cout << _id << "\n";
       // std::cout << this->numControlInputPort() << "\n";
-      helperReplace(_text, "$id", _id - 1);
       break;
     default: break;
   }
-
-  return _text;
 }
 
-std::string
-BranchNode::printOutputEnable(PrintType _pt, uint32_t _id) {
-  string _name(this->getName());
-  std::replace(_name.begin(), _name.end(), '.', '_');
-  string _text;
+void
+BranchNode::emitOutputEnable(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
       // The branch is UBranch and there is no true and false outptu
       if (this->numDataInputPort() == 0) {
-        _text = "$name.io.Out($id)";
-        helperReplace(_text, "$name", _name.c_str());
-        helperReplace(_text, "$id", _id);
+        static const TemplateString _tmpl_0("$name.io.Out($id)", {"$name", "$id"});
+        _tmpl_0.render(_out, {_name.c_str(), _id});
       } else {
         // The branch is CBranch and there is true and false outptut
         auto node            = this->returnControlOutputPortNode(_id);
@@ -1229,16 +1308,16 @@ BranchNode::printOutputEnable(PrintType _pt, uint32_t _id) {
               continue;
             } else {
               if (pr.second == BranchNode::PredicateResult::True) {
-                _text = "$name.io.TrueOutput($id)";
-                helperReplace(_text, "$name", _name.c_str());
-                helperReplace(_text, "$id", true_index);
+                static const TemplateString _tmpl_1("$name.io.TrueOutput($id)",
+                                                    {"$name", "$id"});
+                _tmpl_1.render(_out, {_name.c_str(), true_index});
               } else if (pr.second == BranchNode::PredicateResult::False) {
-                _text = "$name.io.FalseOutput($id)";
-                helperReplace(_text, "$name", _name.c_str());
-                helperReplace(_text, "$id", false_index);
+                static const TemplateString _tmpl_2("$name.io.FalseOutput($id)",
+                                                    {"$name", "$id"});
+                _tmpl_2.render(_out, {_name.c_str(), false_index});
               } else {
-                _text = "$name.io.CONDITIONAL?";
-                helperReplace(_text, "$name", _name.c_str());
+                static const TemplateString _tmpl_3("$name.io.CONDITIONAL?", {"$name"});
+                _tmpl_3.render(_out, {_name.c_str()});
               }
               break;
             }
@@ -1253,24 +1332,18 @@ BranchNode::printOutputEnable(PrintType _pt, uint32_t _id) {
       break;
     default: break;
   }
-
-  return _text;
 }
 
-std::string
-BranchNode::printInputData(PrintType _pt, uint32_t _id) {
-  string _name(this->getName());
-  std::replace(_name.begin(), _name.end(), '.', '_');
-  string _text;
+void
+BranchNode::emitInputData(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      _text = "$name.io.CmpIO";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.CmpIO", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
       break;
     default: break;
   }
-
-  return _text;
 }
 
 //===----------------------------------------------------------------------===//
@@ -1285,6 +1358,18 @@ InstructionNode::getInstruction() {
   return this->parent_instruction;
 }
 
+/**
+ * Printing the parent instruction, nodes without an LLVM instruction print
+ * the text they are loaded with
+ */
+void
+InstructionNode::printInstruction(raw_ostream& _out) {
+  if (this->parent_instruction)
+    this->parent_instruction->print(_out);
+  else
+    _out << this->instruction_text;
+}
+
 ConstantInt*
 ConstIntNode::getConstantParent() {
   return this->parent_const_int;
@@ -1296,16 +1381,17 @@ ConstIntNode::getConstantParent() {
 std::string
 ArgumentNode::printDefinition(PrintType _pt) {
   string _text;
-  string _name(this->getName());
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "  val $name = Module(new $type(NumOuts = "
-              "$num_out, ID = $id))\n\n";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$num_out", std::to_string(this->numDataOutputPort()));
-      helperReplace(_text, "$id", this->getID());
-      helperReplace(_text, "$type", "ArgumentNode");
+      static const TemplateString _tmpl(
+          "  val $name = Module(new $type(NumOuts = "
+          "$num_out, ID = $id))\n\n",
+          {"$name", "$num_out", "$id", "$type"});
+      _text = _tmpl.render({_name.c_str(),
+                            std::to_string(this->numDataOutputPort()),
+                            this->getID(),
+                            "ArgumentNode"});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
@@ -1314,48 +1400,40 @@ ArgumentNode::printDefinition(PrintType _pt) {
   return _text;
 }
 
-std::string
-ArgumentNode::printInputData(PrintType _pt, uint32_t _idx) {
-  string _text;
-  string _name(this->getName());
+void
+ArgumentNode::emitInputData(raw_ostream& _out, PrintType _pt, uint32_t _idx) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala: {
       switch (this->getArgType()) {
         case ArgumentNode::LiveIn: {
-          std::replace(_name.begin(), _name.end(), '.', '_');
-          _text = "$call.io.In($id)";
-          helperReplace(_text, "$call", this->parent_call_node->getName());
-          helperReplace(_text, "$id", _idx);
+          static const TemplateString _tmpl_0("$call.io.In($id)", {"$call", "$id"});
+          _tmpl_0.render(_out, {this->parent_call_node->getName(), _idx});
 
           break;
         }
         case ArgumentNode::LiveOut: {
-          std::replace(_name.begin(), _name.end(), '.', '_');
-          _text = "$call.io.InLiveOut($id)";
-          helperReplace(_text, "$call", this->parent_call_node->getName());
-          helperReplace(_text, "$id", _idx);
+          static const TemplateString _tmpl_1("$call.io.InLiveOut($id)",
+                                              {"$call", "$id"});
+          _tmpl_1.render(_out, {this->parent_call_node->getName(), _idx});
           break;
         }
         case ArgumentNode::LoopLiveIn: {
-          std::replace(_name.begin(), _name.end(), '.', '_');
-          _text = "$call.io.InLiveIn($id)";
-          helperReplace(_text, "$call", this->parent_call_node->getName());
-          helperReplace(_text, "$id", _idx);
+          static const TemplateString _tmpl_2("$call.io.InLiveIn($id)", {"$call", "$id"});
+          _tmpl_2.render(_out, {this->parent_call_node->getName(), _idx});
 
           break;
         }
         case ArgumentNode::LoopLiveOut: {
-          std::replace(_name.begin(), _name.end(), '.', '_');
-          _text = "$call.io.InLiveOut($id)";
-          helperReplace(_text, "$call", this->parent_call_node->getName());
-          helperReplace(_text, "$id", _idx);
+          static const TemplateString _tmpl_3("$call.io.InLiveOut($id)",
+                                              {"$call", "$id"});
+          _tmpl_3.render(_out, {this->parent_call_node->getName(), _idx});
           break;
         }
         case ArgumentNode::CarryDependency: {
-          std::replace(_name.begin(), _name.end(), '.', '_');
-          _text = "$call.io.CarryDepenIn($id)";
-          helperReplace(_text, "$call", this->parent_call_node->getName());
-          helperReplace(_text, "$id", _idx);
+          static const TemplateString _tmpl_4("$call.io.CarryDepenIn($id)",
+                                              {"$call", "$id"});
+          _tmpl_4.render(_out, {this->parent_call_node->getName(), _idx});
           break;
         }
 
@@ -1367,79 +1445,76 @@ ArgumentNode::printInputData(PrintType _pt, uint32_t _idx) {
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-ArgumentNode::printOutputData(PrintType _pt, uint32_t _idx) {
-  string _text;
-  string _name(this->getName());
+void
+ArgumentNode::emitOutputData(raw_ostream& _out, PrintType _pt, uint32_t _idx) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala: {
       switch (this->getArgType()) {
         case ArgumentNode::LiveIn: {
-          std::replace(_name.begin(), _name.end(), '.', '_');
-          _text = "$call.io.$out.$data.elements(\"field$num\")($id)";
-          helperReplace(_text, "$call", this->parent_call_node->getName());
-          helperReplace(
-              _text, "$num", this->parent_call_node->findLiveInArgumentIndex(this));
-          helperReplace(_text, "$out", "Out");
-
-          helperReplace(_text, "$id", _idx);
+          static const TemplateString _tmpl_0(
+              "$call.io.$out.$data.elements(\"field$num\")($id)",
+              {"$call", "$num", "$out", "$id", "$data"});
 
+          // Other data types are left unresolved
+          string _data("$data");
           if (this->getDataArgType() == ArgumentNode::PointerType)
-            helperReplace(_text, "$data", "dataPtrs");
+            _data = "dataPtrs";
           else if (this->getDataArgType() == ArgumentNode::IntegerType)
-            helperReplace(_text, "$data", "dataVals");
+            _data = "dataVals";
+
+          _tmpl_0.render(_out, {this->parent_call_node->getName(),
+                                this->parent_call_node->findLiveInArgumentIndex(this),
+                                "Out",
+                                _idx,
+                                _data});
 
           break;
         }
         case ArgumentNode::LiveOut: {
-          std::replace(_name.begin(), _name.end(), '.', '_');
-          _text = "$call.io.$out($id)";
-          helperReplace(_text, "$call", this->parent_call_node->getName());
-          helperReplace(
-              _text, "$num", this->parent_call_node->findLiveOutArgumentIndex(this));
-          helperReplace(_text, "$out", "Out");
-
-          helperReplace(_text, "$id", _idx);
+          static const TemplateString _tmpl_1("$call.io.$out($id)",
+                                              {"$call", "$num", "$out", "$id"});
+          _tmpl_1.render(_out, {this->parent_call_node->getName(),
+                                this->parent_call_node->findLiveOutArgumentIndex(this),
+                                "Out",
+                                _idx});
           break;
         }
         case ArgumentNode::LoopLiveIn: {
-          std::replace(_name.begin(), _name.end(), '.', '_');
-          _text = "$call.io.$out.elements(\"field$num\")($id)";
-          helperReplace(_text, "$call", this->parent_call_node->getName());
-          helperReplace(
-              _text, "$num", this->parent_call_node->findLiveInArgumentIndex(this));
-          if (this->parent_call_node->getContainerType() == ContainerNode::LoopNodeTy)
-            helperReplace(_text, "$out", "OutLiveIn");
-          else
-            helperReplace(_text, "$out", "Out");
-
-          helperReplace(_text, "$id", _idx);
+          static const TemplateString _tmpl_2(
+              "$call.io.$out.elements(\"field$num\")($id)",
+              {"$call", "$num", "$out", "$id"});
+          _tmpl_2.render(_out,
+              {this->parent_call_node->getName(),
+               this->parent_call_node->findLiveInArgumentIndex(this),
+               this->parent_call_node->getContainerType() == ContainerNode::LoopNodeTy
+                   ? "OutLiveIn"
+                   : "Out",
+               _idx});
 
           break;
         }
         case ArgumentNode::LoopLiveOut: {
-          std::replace(_name.begin(), _name.end(), '.', '_');
-          _text = "$call.io.$out.elements(\"field$num\")($id)";
-          helperReplace(_text, "$call", this->parent_call_node->getName());
-          helperReplace(
-              _text, "$num", this->parent_call_node->findLiveOutArgumentIndex(this));
-          helperReplace(_text, "$out", "OutLiveOut");
-
-          helperReplace(_text, "$id", _idx);
+          static const TemplateString _tmpl_3(
+              "$call.io.$out.elements(\"field$num\")($id)",
+              {"$call", "$num", "$out", "$id"});
+          _tmpl_3.render(_out, {this->parent_call_node->getName(),
+                                this->parent_call_node->findLiveOutArgumentIndex(this),
+                                "OutLiveOut",
+                                _idx});
           break;
         }
         case ArgumentNode::CarryDependency: {
-          std::replace(_name.begin(), _name.end(), '.', '_');
-          _text = "$call.io.$out.elements(\"field$num\")($id)";
-          helperReplace(_text, "$call", this->parent_call_node->getName());
-          helperReplace(
-              _text, "$num", this->parent_call_node->findCarryDepenArgumentIndex(this));
-          helperReplace(_text, "$out", "CarryDepenOut");
-
-          helperReplace(_text, "$id", _idx);
+          static const TemplateString _tmpl_4(
+              "$call.io.$out.elements(\"field$num\")($id)",
+              {"$call", "$num", "$out", "$id"});
+          _tmpl_4.render(_out,
+              {this->parent_call_node->getName(),
+               this->parent_call_node->findCarryDepenArgumentIndex(this),
+               "CarryDepenOut",
+               _idx});
           break;
         }
         default: assert(!"Unrecognized type of node\n"); break;
@@ -1450,7 +1525,6 @@ ArgumentNode::printOutputData(PrintType _pt, uint32_t _idx) {
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
 //===----------------------------------------------------------------------===//
@@ -1473,18 +1547,20 @@ SuperNode::getBasicBlock() {
 std::string
 BinaryOperatorNode::printDefinition(PrintType _pt) {
   string _text;
-  string _name(this->getName());
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "  val $name = Module(new $type(NumOuts = "
-              "$num_out, ID = $id, opCode = \"$opcode\")(sign = false, Debug "
-              "= false))\n\n";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$num_out", std::to_string(this->numDataOutputPort()));
-      helperReplace(_text, "$id", this->getID());
-      helperReplace(_text, "$type", "ComputeNode");
-      helperReplace(_text, "$opcode", this->getOpCodeName());
+      static const TemplateString _tmpl(
+          "  val $name = Module(new $type(NumOuts = "
+          "$num_out, ID = $id, opCode = \"$opcode\")(sign = false, Debug "
+          "= false)$narrow)\n\n",
+          {"$name", "$num_out", "$id", "$type", "$opcode", "$narrow"});
+      _text = _tmpl.render({_name.c_str(),
+                            std::to_string(this->numDataOutputPort()),
+                            this->getID(),
+                            "ComputeNode",
+                            this->getOpCodeName(),
+                            printNarrowedParameters(this)});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
@@ -1493,62 +1569,53 @@ BinaryOperatorNode::printDefinition(PrintType _pt) {
   return _text;
 }
 
-std::string
-BinaryOperatorNode::printInputEnable(PrintType _pt) {
-  string _text;
-  string _name(this->getName());
+void
+BinaryOperatorNode::emitInputEnable(raw_ostream& _out, PrintType _pt) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.enable";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.enable", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-BinaryOperatorNode::printOutputData(PrintType _pt, uint32_t _id) {
-  string _text;
-  string _name(this->getName());
+void
+BinaryOperatorNode::emitOutputData(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.Out($id)";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _id);
+      static const TemplateString _tmpl("$name.io.Out($id)", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _id});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-BinaryOperatorNode::printInputData(PrintType _pt, uint32_t _idx) {
-  string _text;
-  string _name(this->getName());
+void
+BinaryOperatorNode::emitInputData(raw_ostream& _out, PrintType _pt, uint32_t _idx) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
       if (this->getOpCodeName() == "ashr")
         WARNING("Make sure shift ordering is correct");
 
-      std::replace(_name.begin(), _name.end(), '.', '_');
+      static const TemplateString _tmpl_left("$name.io.LeftIO", {"$name"});
+      static const TemplateString _tmpl_right("$name.io.RightIO", {"$name"});
       if (_idx == 0)
-        _text = "$name.io.LeftIO";
+        _tmpl_left.render(_out, {_name.c_str()});
       else
-        _text = "$name.io.RightIO";
-      helperReplace(_text, "$name", _name.c_str());
+        _tmpl_right.render(_out, {_name.c_str()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
 //===----------------------------------------------------------------------===//
@@ -1558,17 +1625,18 @@ BinaryOperatorNode::printInputData(PrintType _pt, uint32_t _idx) {
 std::string
 FaddOperatorNode::printDefinition(PrintType _pt) {
   string _text;
-  string _name(this->getName());
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "  val $name = Module(new $type(NumOuts = "
-              "$num_out, ID = $id, opCode = \"$opcode\")(fType))\n\n";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$num_out", std::to_string(this->numDataOutputPort()));
-      helperReplace(_text, "$id", this->getID());
-      helperReplace(_text, "$type", "FPComputeNode");
-      helperReplace(_text, "$opcode", this->getOpCodeName());
+      static const TemplateString _tmpl(
+          "  val $name = Module(new $type(NumOuts = "
+          "$num_out, ID = $id, opCode = \"$opcode\")(fType))\n\n",
+          {"$name", "$num_out", "$id", "$type", "$opcode"});
+      _text = _tmpl.render({_name.c_str(),
+                            std::to_string(this->numDataOutputPort()),
+                            this->getID(),
+                            "FPComputeNode",
+                            this->getOpCodeName()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
@@ -1577,59 +1645,50 @@ FaddOperatorNode::printDefinition(PrintType _pt) {
   return _text;
 }
 
-std::string
-FaddOperatorNode::printInputEnable(PrintType _pt) {
-  string _text;
-  string _name(this->getName());
+void
+FaddOperatorNode::emitInputEnable(raw_ostream& _out, PrintType _pt) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.enable";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.enable", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-FaddOperatorNode::printOutputData(PrintType _pt, uint32_t _id) {
-  string _text;
-  string _name(this->getName());
+void
+FaddOperatorNode::emitOutputData(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.Out($id)";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _id);
+      static const TemplateString _tmpl("$name.io.Out($id)", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _id});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-FaddOperatorNode::printInputData(PrintType _pt, uint32_t _idx) {
-  string _text;
-  string _name(this->getName());
+void
+FaddOperatorNode::emitInputData(raw_ostream& _out, PrintType _pt, uint32_t _idx) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
+      static const TemplateString _tmpl_left("$name.io.LeftIO", {"$name"});
+      static const TemplateString _tmpl_right("$name.io.RightIO", {"$name"});
       if (_idx == 0)
-        _text = "$name.io.LeftIO";
+        _tmpl_left.render(_out, {_name.c_str()});
       else
-        _text = "$name.io.RightIO";
-      helperReplace(_text, "$name", _name.c_str());
+        _tmpl_right.render(_out, {_name.c_str()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
 //===----------------------------------------------------------------------===//
@@ -1639,19 +1698,20 @@ FaddOperatorNode::printInputData(PrintType _pt, uint32_t _idx) {
 std::string
 FdiveOperatorNode::printDefinition(PrintType _pt) {
   string _text;
-  string _name(this->getName());
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "  val $name = Module(new $type(NumOuts = "
-              "$num_out, ID = $id, RouteID = $route_id, opCode = "
-              "\"$opcode\")(fType))\n\n";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$num_out", std::to_string(this->numDataOutputPort()));
-      helperReplace(_text, "$id", this->getID());
-      helperReplace(_text, "$route_id", this->getRouteID());
-      helperReplace(_text, "$type", "FPDivSqrtNode");
-      helperReplace(_text, "$opcode", this->getOpCodeName());
+      static const TemplateString _tmpl(
+          "  val $name = Module(new $type(NumOuts = "
+          "$num_out, ID = $id, RouteID = $route_id, opCode = "
+          "\"$opcode\")(fType))\n\n",
+          {"$name", "$num_out", "$id", "$route_id", "$type", "$opcode"});
+      _text = _tmpl.render({_name.c_str(),
+                            std::to_string(this->numDataOutputPort()),
+                            this->getID(),
+                            this->getRouteID(),
+                            "FPDivSqrtNode",
+                            this->getOpCodeName()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
@@ -1660,95 +1720,78 @@ FdiveOperatorNode::printDefinition(PrintType _pt) {
   return _text;
 }
 
-std::string
-FdiveOperatorNode::printInputEnable(PrintType _pt) {
-  string _text;
-  string _name(this->getName());
+void
+FdiveOperatorNode::emitInputEnable(raw_ostream& _out, PrintType _pt) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.enable";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.enable", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-FdiveOperatorNode::printOutputData(PrintType _pt, uint32_t _id) {
-  string _text;
-  string _name(this->getName());
+void
+FdiveOperatorNode::emitOutputData(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.Out($id)";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _id);
+      static const TemplateString _tmpl("$name.io.Out($id)", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _id});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-FdiveOperatorNode::printInputData(PrintType _pt, uint32_t _idx) {
-  string _text;
-  string _name(this->getName());
+void
+FdiveOperatorNode::emitInputData(raw_ostream& _out, PrintType _pt, uint32_t _idx) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
+      static const TemplateString _tmpl_left("$name.io.a", {"$name"});
+      static const TemplateString _tmpl_right("$name.io.b", {"$name"});
       if (_idx == 0)
-        _text = "$name.io.a";
+        _tmpl_left.render(_out, {_name.c_str()});
       else
-        _text = "$name.io.b";
-      helperReplace(_text, "$name", _name.c_str());
+        _tmpl_right.render(_out, {_name.c_str()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-FdiveOperatorNode::printMemReadInput(PrintType _pt, uint32_t _idx) {
-  string _text;
-  string _name(this->getName());
+void
+FdiveOperatorNode::emitMemReadInput(raw_ostream& _out, PrintType _pt, uint32_t _idx) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.FUResp";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _idx);
+      static const TemplateString _tmpl("$name.io.FUResp", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _idx});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-FdiveOperatorNode::printMemReadOutput(PrintType _pt, uint32_t _idx) {
-  string _text;
-  string _name(this->getName());
+void
+FdiveOperatorNode::emitMemReadOutput(raw_ostream& _out, PrintType _pt, uint32_t _idx) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.FUReq";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _idx);
+      static const TemplateString _tmpl("$name.io.FUReq", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _idx});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
 //===----------------------------------------------------------------------===//
@@ -1758,21 +1801,19 @@ FdiveOperatorNode::printMemReadOutput(PrintType _pt, uint32_t _idx) {
 std::string
 FcmpNode::printDefinition(PrintType _pt) {
   string _text;
-  string _name(this->getName());
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "  val $name = Module(new $type(NumOuts = "
-              "$num_out, ID = $id, opCode = \"$opcode\")(fType))\n\n";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$num_out", std::to_string(this->numDataOutputPort()));
-      helperReplace(_text, "$id", this->getID());
-      helperReplace(_text, "$type", "FPCompareNode");
-      helperReplace(
-          _text,
-          "$opcode",
-          this->op_codes[llvm::ICmpInst::getPredicateName(
-              dyn_cast<llvm::FCmpInst>(this->getInstruction())->getPredicate())]);
+      static const TemplateString _tmpl(
+          "  val $name = Module(new $type(NumOuts = "
+          "$num_out, ID = $id, opCode = \"$opcode\")(fType))\n\n",
+          {"$name", "$num_out", "$id", "$type", "$opcode"});
+      _text = _tmpl.render(
+          {_name.c_str(),
+           std::to_string(this->numDataOutputPort()),
+           this->getID(),
+           "FPCompareNode",
+           this->op_codes[llvm::CmpInst::getPredicateName(this->getPredicate())]});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
@@ -1781,59 +1822,50 @@ FcmpNode::printDefinition(PrintType _pt) {
   return _text;
 }
 
-std::string
-FcmpNode::printInputEnable(PrintType _pt) {
-  string _text;
-  string _name(this->getName());
+void
+FcmpNode::emitInputEnable(raw_ostream& _out, PrintType _pt) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.enable";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.enable", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-FcmpNode::printInputData(PrintType _pt, uint32_t _idx) {
-  string _text;
-  string _name(this->getName());
+void
+FcmpNode::emitInputData(raw_ostream& _out, PrintType _pt, uint32_t _idx) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
+      static const TemplateString _tmpl_left("$name.io.LeftIO", {"$name"});
+      static const TemplateString _tmpl_right("$name.io.RightIO", {"$name"});
       if (_idx == 0)
-        _text = "$name.io.LeftIO";
+        _tmpl_left.render(_out, {_name.c_str()});
       else
-        _text = "$name.io.RightIO";
-      helperReplace(_text, "$name", _name.c_str());
+        _tmpl_right.render(_out, {_name.c_str()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-FcmpNode::printOutputData(PrintType _pt, uint32_t _id) {
-  string _text;
-  string _name(this->getName());
+void
+FcmpNode::emitOutputData(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.Out($id)";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _id);
+      static const TemplateString _tmpl("$name.io.Out($id)", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _id});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
 //===----------------------------------------------------------------------===//
@@ -1848,18 +1880,18 @@ ConstFPNode::getConstantParent() {
 std::string
 ConstFPNode::printDefinition(PrintType _pt) {
   string _text;
-  string _name(this->getName());
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "  val $name = Module(new $type(value = $valL"
-              ", ID = $id))\n\n";
-      helperReplace(_text, "$name", _name.c_str());
-      // helperReplace(_text, "$num_out",
+      static const TemplateString _tmpl(
+          "  val $name = Module(new $type(value = $valL"
+          ", ID = $id))\n\n",
+          {"$name", "$id", "$type", "$val"});
+      _text = _tmpl.render({_name.c_str(),
+                            this->getID(),
+                            "ConstFastNode",
+                            printFloatingPointIEEE754(this->getFloatIEEE())});
       // std::to_string(this->numDataOutputPort()));
-      helperReplace(_text, "$id", this->getID());
-      helperReplace(_text, "$type", "ConstFastNode");
-      helperReplace(_text, "$val", printFloatingPointIEEE754(this->getFloatIEEE()));
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
@@ -1868,40 +1900,33 @@ ConstFPNode::printDefinition(PrintType _pt) {
   return _text;
 }
 
-std::string
-ConstFPNode::printOutputData(PrintType _pt, uint32_t _id) {
-  string _text;
-  string _name(this->getName());
+void
+ConstFPNode::emitOutputData(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
       //_text = "$name.io.Out($id)";
-      _text = "$name.io.Out";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _id);
+      static const TemplateString _tmpl("$name.io.Out", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _id});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-ConstFPNode::printInputEnable(PrintType pt) {
-  string _text;
-  string _name(this->getName());
+void
+ConstFPNode::emitInputEnable(raw_ostream& _out, PrintType pt) {
+  auto& _name = this->getScalaName();
   switch (pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.enable";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.enable", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
 //===----------------------------------------------------------------------===//
@@ -1911,88 +1936,76 @@ ConstFPNode::printInputEnable(PrintType pt) {
 std::string
 IcmpNode::printDefinition(PrintType _pt) {
   string _text;
-  string _name(this->getName());
-  switch (_pt) {
-    case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "  val $name = Module(new $type(NumOuts = "
-              "$num_out, ID = $id, opCode = \"$opcode\")(sign = $sign, Debug "
-              "= false))\n\n";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$num_out", std::to_string(this->numDataOutputPort()));
-      helperReplace(_text, "$id", this->getID());
-      helperReplace(_text, "$type", "ComputeNode");
-      helperReplace(
-          _text,
-          "$opcode",
-          llvm::ICmpInst::getPredicateName(
-              dyn_cast<llvm::ICmpInst>(this->getInstruction())->getSignedPredicate()));
-
-      if (dyn_cast<llvm::ICmpInst>(this->getInstruction())->isSigned())
-        helperReplace(_text, "$sign", "true");
-      else
-        helperReplace(_text, "$sign", "false");
+  auto& _name = this->getScalaName();
+  switch (_pt) {
+    case PrintType::Scala: {
+      static const TemplateString _tmpl(
+          "  val $name = Module(new $type(NumOuts = "
+          "$num_out, ID = $id, opCode = \"$opcode\")(sign = $sign, Debug "
+          "= false)$narrow)\n\n",
+          {"$name", "$num_out", "$id", "$type", "$opcode", "$sign", "$narrow"});
+      auto _pred = this->getPredicate();
+      _text      = _tmpl.render(
+          {_name.c_str(),
+           std::to_string(this->numDataOutputPort()),
+           this->getID(),
+           "ComputeNode",
+           llvm::CmpInst::getPredicateName(llvm::ICmpInst::getSignedPredicate(_pred)),
+           llvm::CmpInst::isSigned(_pred) ? "true" : "false",
+           printNarrowedParameters(this)});
 
       break;
+    }
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
   return _text;
 }
 
-std::string
-IcmpNode::printInputEnable(PrintType _pt) {
-  string _text;
-  string _name(this->getName());
+void
+IcmpNode::emitInputEnable(raw_ostream& _out, PrintType _pt) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.enable";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.enable", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-IcmpNode::printInputData(PrintType _pt, uint32_t _idx) {
-  string _text;
-  string _name(this->getName());
+void
+IcmpNode::emitInputData(raw_ostream& _out, PrintType _pt, uint32_t _idx) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
+      static const TemplateString _tmpl_left("$name.io.LeftIO", {"$name"});
+      static const TemplateString _tmpl_right("$name.io.RightIO", {"$name"});
       if (_idx == 0)
-        _text = "$name.io.LeftIO";
+        _tmpl_left.render(_out, {_name.c_str()});
       else
-        _text = "$name.io.RightIO";
-      helperReplace(_text, "$name", _name.c_str());
+        _tmpl_right.render(_out, {_name.c_str()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-IcmpNode::printOutputData(PrintType _pt, uint32_t _id) {
-  string _text;
-  string _name(this->getName());
+void
+IcmpNode::emitOutputData(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.Out($id)";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _id);
+      static const TemplateString _tmpl("$name.io.Out($id)", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _id});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
 //===----------------------------------------------------------------------===//
@@ -2002,78 +2015,91 @@ IcmpNode::printOutputData(PrintType _pt, uint32_t _id) {
 std::string
 BranchNode::printDefinition(PrintType _pt) {
   string _text;
-  string _name(this->getName());
+  auto& _name = this->getScalaName();
   switch (_pt) {
-    case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
+    case PrintType::Scala: {
+      static const std::initializer_list<const char*> _keys{
+          "$type", "$false", "$true", "$pred", "$nout", "$npo", "$name", "$id"};
+      static const TemplateString _tmpl_pred(
+          "  val $name = Module(new $type(NumPredOps=$npo, ID = "
+          "$id))\n\n",
+          _keys);
+      static const TemplateString _tmpl_pred_out(
+          "  val $name = Module(new $type(NumPredOps=$npo, "
+          "NumOuts=$nout, ID = "
+          "$id))\n\n",
+          _keys);
+      static const TemplateString _tmpl_out(
+          "  val $name = Module(new $type(NumOuts=$nout, ID = "
+          "$id))\n\n",
+          _keys);
+      static const TemplateString _tmpl_id(
+          "  val $name = Module(new $type(ID = "
+          "$id))\n\n",
+          _keys);
+      static const TemplateString _tmpl_cond(
+          "  val $name = Module(new $type(NumTrue = $true, NumFalse "
+          "= $false, NumPredecessor = $pred, ID = "
+          "$id))\n\n",
+          _keys);
+
+      const TemplateString* _tmpl = &_tmpl_id;
       if (this->numControlInputPort() > 1 && this->numControlOutputPort() == 1
           && this->numDataInputPort() == 0)
-        _text = "  val $name = Module(new $type(NumPredOps=$npo, ID = "
-                "$id))\n\n";
+        _tmpl = &_tmpl_pred;
       else if (this->numControlInputPort() > 1 && this->numControlOutputPort() > 1
                && this->numDataInputPort() == 0)
-        _text = "  val $name = Module(new $type(NumPredOps=$npo, "
-                "NumOuts=$nout, ID = "
-                "$id))\n\n";
+        _tmpl = &_tmpl_pred_out;
       else if (this->numControlInputPort() == 1 && this->numControlOutputPort() > 1
                && this->numDataInputPort() == 0)
-        _text = "  val $name = Module(new $type(NumOuts=$nout, ID = "
-                "$id))\n\n";
-      else
-        _text = "  val $name = Module(new $type(ID = "
-                "$id))\n\n";
+        _tmpl = &_tmpl_out;
 
+      string _type("UBranchNode");
+      // Getting port index
+      uint32_t p_true_index  = 0;
+      uint32_t p_false_index = 0;
       if (this->numDataInputPort() > 0) {
-        _text = "  val $name = Module(new $type(NumTrue = $true, NumFalse "
-                "= $false, NumPredecessor = $pred, ID = "
-                "$id))\n\n";
+        _tmpl = &_tmpl_cond;
+        _type = (this->getEndingLoopBranch()) ? "CBranchNodeVariableLoop"
+                                              : "CBranchNodeVariable";
 
-        // Getting port index
-        uint32_t p_true_index  = 0;
-        uint32_t p_false_index = 0;
         for (auto _p : output_predicate) {
           if (_p.second == this->PredicateResult::False)
             p_false_index++;
           else if (_p.second == this->PredicateResult::True)
             p_true_index++;
         }
-        helperReplace(_text,
-                      "$type",
-                      (this->getEndingLoopBranch()) ? "CBranchNodeVariableLoop"
-                                                    : "CBranchNodeVariable");
-        helperReplace(_text, "$false", p_false_index);
-        helperReplace(_text, "$true", p_true_index);
-        helperReplace(_text, "$pred", this->numControlInputPort() - 1);
+      }
 
-      } else
-        helperReplace(_text, "$type", "UBranchNode");
-      helperReplace(_text, "$nout", this->numControlOutputPort());
-      helperReplace(_text, "$npo", this->numControlInputPort() - 1);
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", this->getID());
+      _text = _tmpl->render({_type,
+                             p_false_index,
+                             p_true_index,
+                             this->numControlInputPort() - 1,
+                             this->numControlOutputPort(),
+                             this->numControlInputPort() - 1,
+                             _name.c_str(),
+                             this->getID()});
 
       break;
+    }
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
   return _text;
 }
 
-std::string
-BranchNode::printInputEnable(PrintType _pt) {
-  string _text;
-  string _name(this->getName());
+void
+BranchNode::emitInputEnable(raw_ostream& _out, PrintType _pt) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.enable";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.enable", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
 //===----------------------------------------------------------------------===//
@@ -2083,17 +2109,18 @@ BranchNode::printInputEnable(PrintType _pt) {
 std::string
 SelectNode::printDefinition(PrintType _pt) {
   string _text;
-  string _name(this->getName());
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "  val $name = Module(new $type("
-              "NumOuts = $num_out, ID = $id)(fast = false))\n\n";
-      helperReplace(_text, "$type", "SelectNode");
-      helperReplace(_text, "$num_out", std::to_string(this->numDataOutputPort()));
-
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", this->getID());
+      static const TemplateString _tmpl(
+          "  val $name = Module(new $type("
+          "NumOuts = $num_out, ID = $id)(fast = false)$narrow)\n\n",
+          {"$type", "$num_out", "$name", "$id", "$narrow"});
+      _text = _tmpl.render({"SelectNode",
+                            std::to_string(this->numDataOutputPort()),
+                            _name.c_str(),
+                            this->getID(),
+                            printNarrowedParameters(this)});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
@@ -2102,66 +2129,56 @@ SelectNode::printDefinition(PrintType _pt) {
   return _text;
 }
 
-std::string
-SelectNode::printInputEnable(PrintType _pt) {
-  string _text;
-  string _name(this->getName());
+void
+SelectNode::emitInputEnable(raw_ostream& _out, PrintType _pt) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.enable";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.enable", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-SelectNode::printInputData(PrintType _pt, uint32_t _id) {
-  string _text;
-  string _name(this->getName());
+void
+SelectNode::emitInputData(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
+      static const TemplateString _tmpl_select("$name.io.Select", {"$name"});
+      static const TemplateString _tmpl_in1("$name.io.InData1", {"$name"});
+      static const TemplateString _tmpl_in2("$name.io.InData2", {"$name"});
       if (_id == 0)
-        _text = "$name.io.Select";
+        _tmpl_select.render(_out, {_name.c_str()});
       else if (_id == 1)
-        _text = "$name.io.InData1";
+        _tmpl_in1.render(_out, {_name.c_str()});
       else if (_id == 2)
-        _text = "$name.io.InData2";
+        _tmpl_in2.render(_out, {_name.c_str()});
       else
         assert(!"Select nod can not have more than three inputs! (select, "
                 "input1, input2)");
 
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _id);
-
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-SelectNode::printOutputData(PrintType _pt, uint32_t _id) {
-  string _text;
-  string _name(this->getName());
+void
+SelectNode::emitOutputData(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.Out($id)";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _id);
+      static const TemplateString _tmpl("$name.io.Out($id)", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _id});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
 //===----------------------------------------------------------------------===//
@@ -2171,20 +2188,20 @@ SelectNode::printOutputData(PrintType _pt, uint32_t _id) {
 std::string
 PhiSelectNode::printDefinition(PrintType _pt) {
   string _text;
-  string _name(this->getName());
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "  val $name = Module(new $type(NumInputs = $num_in, "
-              "NumOutputs = $num_out, ID = $id, Res = $reverse))\n\n";
-
-      helperReplace(_text, "$type", "PhiFastNode");
-      helperReplace(_text, "$num_in", std::to_string(this->numDataInputPort()));
-      helperReplace(_text, "$num_out", std::to_string(this->numDataOutputPort()));
-
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", this->getID());
-      helperReplace(_text, "$reverse", this->reverse ? "true" : "false");
+      static const TemplateString _tmpl(
+          "  val $name = Module(new $type(NumInputs = $num_in, "
+          "NumOutputs = $num_out, ID = $id, Res = $reverse)$narrow)\n\n",
+          {"$type", "$num_in", "$num_out", "$name", "$id", "$reverse", "$narrow"});
+      _text = _tmpl.render({"PhiFastNode",
+                            std::to_string(this->numDataInputPort()),
+                            std::to_string(this->numDataOutputPort()),
+                            _name.c_str(),
+                            this->getID(),
+                            this->reverse ? "true" : "false",
+                            printNarrowedParameters(this)});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
@@ -2193,68 +2210,56 @@ PhiSelectNode::printDefinition(PrintType _pt) {
   return _text;
 }
 
-std::string
-PhiSelectNode::printInputEnable(PrintType _pt) {
-  string _text;
-  string _name(this->getName());
+void
+PhiSelectNode::emitInputEnable(raw_ostream& _out, PrintType _pt) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.enable";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.enable", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-PhiSelectNode::printInputData(PrintType _pt, uint32_t _id) {
-  string _text;
-  string _name(this->getName());
+void
+PhiSelectNode::emitInputData(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.InData($id)";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _id);
+      static const TemplateString _tmpl("$name.io.InData($id)", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _id});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-PhiSelectNode::printOutputData(PrintType _pt, uint32_t _id) {
-  string _text;
-  string _name(this->getName());
+void
+PhiSelectNode::emitOutputData(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.Out($id)";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _id);
+      static const TemplateString _tmpl("$name.io.Out($id)", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _id});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
 std::string
 PhiSelectNode::printMaskInput(PrintType _pt) {
   string _text;
-  string _name(this->getName());
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.Mask";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.Mask", {"$name"});
+      _text = _tmpl.render({_name.c_str()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
@@ -2270,20 +2275,19 @@ PhiSelectNode::printMaskInput(PrintType _pt) {
 std::string
 ReturnNode::printDefinition(PrintType _pt) {
   string _text;
-  string _name(this->getName());
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "  val $name = Module(new $type(retTypes = "
-              "List($<input_list>), "
-              "ID = $id))\n\n";
-      helperReplace(_text, "$type", "RetNode2");
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", this->getID());
-      helperReplace(_text,
-                    "$<input_list>",
-                    std::vector<uint32_t>(this->numDataInputPort(), 32),
-                    ", ");
+      static const TemplateString _tmpl(
+          "  val $name = Module(new $type(retTypes = "
+          "List($<input_list>), "
+          "ID = $id))\n\n",
+          {"$type", "$name", "$id", "$<input_list>"});
+      _text = _tmpl.render(
+          {"RetNode2",
+           _name.c_str(),
+           this->getID(),
+           TemplateArg(std::vector<uint32_t>(this->numDataInputPort(), 32), ", ")});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
@@ -2292,94 +2296,77 @@ ReturnNode::printDefinition(PrintType _pt) {
   return _text;
 }
 
-std::string
-ReturnNode::printInputEnable(PrintType _pt) {
-  string _text;
-  string _name(this->getName());
+void
+ReturnNode::emitInputEnable(raw_ostream& _out, PrintType _pt) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.In.enable";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.In.enable", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
 
-std::string
-ReturnNode::printInputEnable(PrintType _pt, uint32_t _idx) {
-  string _text;
-  string _name(this->getName());
+void
+ReturnNode::emitInputEnable(raw_ostream& _out, PrintType _pt, uint32_t _idx) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.In.Succ($id)";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _idx);
+      static const TemplateString _tmpl("$name.io.In.Succ($id)", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _idx});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
 
-std::string
-ReturnNode::printInputData(PrintType _pt, uint32_t _id) {
-  string _text;
-  string _name(this->getName());
+void
+ReturnNode::emitInputData(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.In.data(\"field$id\")";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _id);
+      static const TemplateString _tmpl("$name.io.In.data(\"field$id\")",
+                                        {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _id});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-ReturnNode::printOutputData(PrintType _pt, uint32_t _id) {
-  string _text;
-  string _name(this->getName());
+void
+ReturnNode::emitOutputData(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.Out";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _id);
+      static const TemplateString _tmpl("$name.io.Out", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _id});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-ReturnNode::printOutputData(PrintType _pt) {
-  string _text;
-  string _name(this->getName());
+void
+ReturnNode::emitOutputData(raw_ostream& _out, PrintType _pt) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.Out";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.Out", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
 //===----------------------------------------------------------------------===//
@@ -2389,131 +2376,150 @@ ReturnNode::printOutputData(PrintType _pt) {
 std::string
 LoadNode::printDefinition(PrintType _pt) {
   string _text("");
-  string _name(this->getName());
+  auto& _name = this->getScalaName();
 
   switch (_pt) {
-    case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "  val $name = Module(new $type(NumPredOps = $npo, "
-              "NumSuccOps = $nso, "
-              "NumOuts = $num_out, ID = $id, RouteID = $rid))\n\n";
-      helperReplace(_text, "$type", "UnTypLoadCache");
-
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", this->getID());
-      helperReplace(_text, "$rid", this->getRouteID());
-      helperReplace(_text, "$num_out", this->numDataOutputPort());
-      helperReplace(_text, "$npo", this->numControlInputPort() - 1);
-      helperReplace(_text, "$nso", this->numControlOutputPort());
+    case PrintType::Scala: {
+      static const TemplateString _tmpl(
+          "  val $name = Module(new $type(NumPredOps = $npo, "
+          "NumSuccOps = $nso, "
+          "NumOuts = $num_out, ID = $id, RouteID = $rid$mem_type))\n\n",
+          {"$type", "$name", "$id", "$rid", "$num_out", "$npo", "$nso", "$mem_type"});
+      // Streams issue burst requests from the first address into a FIFO
+      static const TemplateString _stream_tmpl(
+          "  val $name = Module(new $type(NumPredOps = $npo, "
+          "NumSuccOps = $nso, "
+          "NumOuts = $num_out, ID = $id, RouteID = $rid, "
+          "Stride = $stride, TripCount = $trip$mem_type))\n\n",
+          {"$type",
+           "$name",
+           "$id",
+           "$rid",
+           "$num_out",
+           "$npo",
+           "$nso",
+           "$stride",
+           "$trip",
+           "$mem_type"});
+      auto _mem_type = printMemoryType(this->getAccessSize());
+      if (this->isStream())
+        _text = _stream_tmpl.render({"UnTypStreamLoad",
+                                     _name.c_str(),
+                                     this->getID(),
+                                     this->getRouteID(),
+                                     this->numDataOutputPort(),
+                                     this->numControlInputPort() - 1,
+                                     this->numControlOutputPort(),
+                                     this->getStreamStride(),
+                                     this->getStreamTripCount(),
+                                     _mem_type});
+      else
+        _text = _tmpl.render({"UnTypLoadCache",
+                              _name.c_str(),
+                              this->getID(),
+                              this->getRouteID(),
+                              this->numDataOutputPort(),
+                              this->numControlInputPort() - 1,
+                              this->numControlOutputPort(),
+                              _mem_type});
 
       break;
+    }
     default: assert(!"Don't support!");
   }
   return _text;
 }
 
-std::string
-LoadNode::printInputEnable(PrintType pt) {
-  string _text;
-  string _name(this->getName());
+void
+LoadNode::emitInputEnable(raw_ostream& _out, PrintType pt) {
+  auto& _name = this->getScalaName();
   switch (pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.enable";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.enable", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-LoadNode::printInputEnable(PrintType pt, uint32_t _id) {
-  string _text;
-  string _name(this->getName());
+void
+LoadNode::emitInputEnable(raw_ostream& _out, PrintType pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.PredOp($id)";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _id - 1);
+      static const TemplateString _tmpl("$name.io.PredOp($id)", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _id - 1});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-LoadNode::printOutputData(PrintType _pt, uint32_t _idx) {
-  string _text;
-  string _name(this->getName());
-  switch (_pt) {
+void
+LoadNode::emitOutputEnable(raw_ostream& _out, PrintType pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
+  switch (pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.Out($id)";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _idx);
+      static const TemplateString _tmpl("$name.io.SuccOp($id)", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _id});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-LoadNode::printInputData(PrintType _pt, uint32_t _id) {
-  string _name(this->getName());
-  std::replace(_name.begin(), _name.end(), '.', '_');
-  string _text;
+void
+LoadNode::emitOutputData(raw_ostream& _out, PrintType _pt, uint32_t _idx) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      _text = "$name.io.GepAddr";
+      static const TemplateString _tmpl("$name.io.Out($id)", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _idx});
 
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$mem", mem_unit->getName());
       break;
-    default: break;
+    case PrintType::Dot: assert(!"Dot file format is not supported!");
+    default: assert(!"Uknown print type!");
   }
-
-  return _text;
 }
 
-std::string
-LoadNode::printMemReadInput(PrintType _pt, uint32_t _id) {
-  string _name(this->getName());
-  std::replace(_name.begin(), _name.end(), '.', '_');
-  string _text;
+void
+LoadNode::emitInputData(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      _text = "$name.io.MemResp";
-
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.GepAddr", {"$name", "$mem"});
+      _tmpl.render(_out, {_name.c_str(), mem_unit->getName()});
       break;
     default: break;
   }
-
-  return _text;
 }
 
-std::string
-LoadNode::printMemReadOutput(PrintType _pt, uint32_t _id) {
-  string _name(this->getName());
-  std::replace(_name.begin(), _name.end(), '.', '_');
-  string _text;
+void
+LoadNode::emitMemReadInput(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      _text = "$name.io.MemReq";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.MemResp", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
       break;
     default: break;
   }
+}
 
-  return _text;
+void
+LoadNode::emitMemReadOutput(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
+  switch (_pt) {
+    case PrintType::Scala:
+      static const TemplateString _tmpl("$name.io.MemReq", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
+      break;
+    default: break;
+  }
 }
 
 //===----------------------------------------------------------------------===//
@@ -2523,145 +2529,149 @@ LoadNode::printMemReadOutput(PrintType _pt, uint32_t _id) {
 std::string
 StoreNode::printDefinition(PrintType _pt) {
   string _text("");
-  string _name(this->getName());
+  auto& _name = this->getScalaName();
 
   switch (_pt) {
-    case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "  val $name = Module(new $type(NumPredOps = $npo, "
-              "NumSuccOps = $nso, "
-              "ID = $id, RouteID = $rid))\n\n";
-      helperReplace(_text, "$type", "UnTypStoreCache");
-
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", this->getID());
-      helperReplace(_text, "$rid", this->getRouteID());
-      helperReplace(_text, "$npo", this->numControlInputPort() - 1);
-      helperReplace(_text, "$nso", this->numControlOutputPort());
+    case PrintType::Scala: {
+      static const TemplateString _tmpl(
+          "  val $name = Module(new $type(NumPredOps = $npo, "
+          "NumSuccOps = $nso, "
+          "ID = $id, RouteID = $rid$mem_type))\n\n",
+          {"$type", "$name", "$id", "$rid", "$npo", "$nso", "$mem_type"});
+      // Streams collect the data in a FIFO and write it back in bursts, the
+      // successor enable of the last element waits for the write back
+      static const TemplateString _stream_tmpl(
+          "  val $name = Module(new $type(NumPredOps = $npo, "
+          "NumSuccOps = $nso, "
+          "ID = $id, RouteID = $rid, Stride = $stride, TripCount = $trip$mem_type))\n\n",
+          {"$type",
+           "$name",
+           "$id",
+           "$rid",
+           "$npo",
+           "$nso",
+           "$stride",
+           "$trip",
+           "$mem_type"});
+      auto _mem_type = printMemoryType(this->getAccessSize());
+      if (this->isStream())
+        _text = _stream_tmpl.render({"UnTypStreamStore",
+                                     _name.c_str(),
+                                     this->getID(),
+                                     this->getRouteID(),
+                                     this->numControlInputPort() - 1,
+                                     this->numControlOutputPort(),
+                                     this->getStreamStride(),
+                                     this->getStreamTripCount(),
+                                     _mem_type});
+      else
+        _text = _tmpl.render({"UnTypStoreCache",
+                              _name.c_str(),
+                              this->getID(),
+                              this->getRouteID(),
+                              this->numControlInputPort() - 1,
+                              this->numControlOutputPort(),
+                              _mem_type});
 
       break;
+    }
     default: assert(!"Don't support!");
   }
   return _text;
 }
 
-std::string
-StoreNode::printInputEnable(PrintType pt, uint32_t _id) {
-  string _text;
-  string _name(this->getName());
+void
+StoreNode::emitInputEnable(raw_ostream& _out, PrintType pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.PredOp($id)";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _id - 1);
+      static const TemplateString _tmpl("$name.io.PredOp($id)", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _id - 1});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-StoreNode::printInputEnable(PrintType pt) {
-  string _text;
-  string _name(this->getName());
+void
+StoreNode::emitInputEnable(raw_ostream& _out, PrintType pt) {
+  auto& _name = this->getScalaName();
   switch (pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.enable";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.enable", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-StoreNode::printOutputEnable(PrintType pt, uint32_t _id) {
-  string _text;
-  string _name(this->getName());
+void
+StoreNode::emitOutputEnable(raw_ostream& _out, PrintType pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.SuccOp($id)";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _id);
+      static const TemplateString _tmpl("$name.io.SuccOp($id)", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _id});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-StoreNode::printOutputEnable(PrintType pt) {
-  string _text;
-  string _name(this->getName());
+void
+StoreNode::emitOutputEnable(raw_ostream& _out, PrintType pt) {
+  auto& _name = this->getScalaName();
   switch (pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.SuccOp($id)";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.SuccOp($id)", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-StoreNode::printInputData(PrintType _pt, uint32_t _id) {
-  string _name(this->getName());
-  std::replace(_name.begin(), _name.end(), '.', '_');
-  string _text;
+void
+StoreNode::emitInputData(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
+      static const TemplateString _tmpl_data("$name.io.inData", {"$name"});
+      static const TemplateString _tmpl_addr("$name.io.GepAddr", {"$name"});
       if (_id == 0)
-        _text = "$name.io.inData";
+        _tmpl_data.render(_out, {_name.c_str()});
       else
-        _text = "$name.io.GepAddr";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _id);
+        _tmpl_addr.render(_out, {_name.c_str()});
       break;
     default: break;
   }
-
-  return _text;
 }
 
-std::string
-StoreNode::printMemWriteInput(PrintType _pt, uint32_t _id) {
-  string _name(this->getName());
-  std::replace(_name.begin(), _name.end(), '.', '_');
-  string _text;
+void
+StoreNode::emitMemWriteInput(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      _text = "$name.io.MemResp";
-
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.MemResp", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
       break;
     default: break;
   }
-
-  return _text;
 }
 
 std::string
 StoreNode::printGround(PrintType _pt) {
-  string _name(this->getName());
-  std::replace(_name.begin(), _name.end(), '.', '_');
+  auto& _name = this->getScalaName();
   string _text;
   switch (_pt) {
     case PrintType::Scala:
-      _text = "$name.io.Out(0).ready := true.B";
-
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.Out(0).ready := true.B", {"$name"});
+      _text = _tmpl.render({_name.c_str()});
       break;
     default: break;
   }
@@ -2669,38 +2679,28 @@ StoreNode::printGround(PrintType _pt) {
   return _text;
 }
 
-std::string
-StoreNode::printMemWriteOutput(PrintType _pt, uint32_t _id) {
-  string _name(this->getName());
-  std::replace(_name.begin(), _name.end(), '.', '_');
-  string _text;
+void
+StoreNode::emitMemWriteOutput(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      _text = "$name.io.MemReq";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.MemReq", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
       break;
     default: break;
   }
-
-  return _text;
 }
 
-std::string
-StoreNode::printOutputData(PrintType _pt, uint32_t _id) {
-  string _name(this->getName());
-  std::replace(_name.begin(), _name.end(), '.', '_');
-  string _text;
+void
+StoreNode::emitOutputData(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      _text = "$name.io.Out($id)";
-
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _id);
+      static const TemplateString _tmpl("$name.io.Out($id)", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _id});
       break;
     default: break;
   }
-
-  return _text;
 }
 
 //===----------------------------------------------------------------------===//
@@ -2710,17 +2710,19 @@ StoreNode::printOutputData(PrintType _pt, uint32_t _id) {
 std::string
 ConstIntNode::printDefinition(PrintType _pt) {
   string _text;
-  string _name(this->getName());
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "  val $name = Module(new $type(value = $val"
-              ", ID = $id))\n\n";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$num_out", std::to_string(this->numDataOutputPort()));
-      helperReplace(_text, "$id", this->getID());
-      helperReplace(_text, "$type", "ConstFastNode");
-      helperReplace(_text, "$val", this->getValue());
+      static const TemplateString _tmpl(
+          "  val $name = Module(new $type(value = $val"
+          ", ID = $id)$narrow)\n\n",
+          {"$name", "$num_out", "$id", "$type", "$val", "$narrow"});
+      _text = _tmpl.render({_name.c_str(),
+                            std::to_string(this->numDataOutputPort()),
+                            this->getID(),
+                            "ConstFastNode",
+                            this->getValue(),
+                            printNarrowedParameters(this)});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
@@ -2729,39 +2731,32 @@ ConstIntNode::printDefinition(PrintType _pt) {
   return _text;
 }
 
-std::string
-ConstIntNode::printOutputData(PrintType _pt, uint32_t _id) {
-  string _text;
-  string _name(this->getName());
+void
+ConstIntNode::emitOutputData(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.Out";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _id);
+      static const TemplateString _tmpl("$name.io.Out", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _id});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-ConstIntNode::printInputEnable(PrintType pt) {
-  string _text;
-  string _name(this->getName());
+void
+ConstIntNode::emitInputEnable(raw_ostream& _out, PrintType pt) {
+  auto& _name = this->getScalaName();
   switch (pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.enable";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.enable", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
 //===----------------------------------------------------------------------===//
@@ -2771,14 +2766,15 @@ ConstIntNode::printInputEnable(PrintType pt) {
 std::string
 SextNode::printDefinition(PrintType _pt) {
   string _text;
-  string _name(this->getName());
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "  val $name = Module(new $type(NumOuts = $num_out))\n\n";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$num_out", std::to_string(this->numDataOutputPort()));
-      helperReplace(_text, "$type", "SextNode");
+      static const TemplateString _tmpl(
+          "  val $name = Module(new $type(NumOuts = $num_out))\n\n",
+          {"$name", "$num_out", "$type"});
+      _text = _tmpl.render({_name.c_str(),
+                            std::to_string(this->numDataOutputPort()),
+                            "SextNode"});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
@@ -2787,55 +2783,44 @@ SextNode::printDefinition(PrintType _pt) {
   return _text;
 }
 
-std::string
-SextNode::printInputData(PrintType _pt, uint32_t _id) {
-  string _name(this->getName());
-  std::replace(_name.begin(), _name.end(), '.', '_');
-  string _text;
+void
+SextNode::emitInputData(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      _text = "$name.io.Input";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.Input", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
       break;
     default: break;
   }
-
-  return _text;
 }
 
-std::string
-SextNode::printOutputData(PrintType _pt, uint32_t _id) {
-  string _text;
-  string _name(this->getName());
+void
+SextNode::emitOutputData(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.Out($id)";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _id);
+      static const TemplateString _tmpl("$name.io.Out($id)", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _id});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-SextNode::printInputEnable(PrintType pt) {
-  string _text;
-  string _name(this->getName());
+void
+SextNode::emitInputEnable(raw_ostream& _out, PrintType pt) {
+  auto& _name = this->getScalaName();
   switch (pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.enable";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.enable", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
 //===----------------------------------------------------------------------===//
@@ -2845,14 +2830,15 @@ SextNode::printInputEnable(PrintType pt) {
 std::string
 ZextNode::printDefinition(PrintType _pt) {
   string _text;
-  string _name(this->getName());
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "  val $name = Module(new $type(NumOuts = $num_out))\n\n";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$num_out", std::to_string(this->numDataOutputPort()));
-      helperReplace(_text, "$type", "ZextNode");
+      static const TemplateString _tmpl(
+          "  val $name = Module(new $type(NumOuts = $num_out))\n\n",
+          {"$name", "$num_out", "$type"});
+      _text = _tmpl.render({_name.c_str(),
+                            std::to_string(this->numDataOutputPort()),
+                            "ZextNode"});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
@@ -2861,55 +2847,44 @@ ZextNode::printDefinition(PrintType _pt) {
   return _text;
 }
 
-std::string
-ZextNode::printInputData(PrintType _pt, uint32_t _id) {
-  string _name(this->getName());
-  std::replace(_name.begin(), _name.end(), '.', '_');
-  string _text;
+void
+ZextNode::emitInputData(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      _text = "$name.io.Input";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.Input", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
       break;
     default: break;
   }
-
-  return _text;
 }
 
-std::string
-ZextNode::printOutputData(PrintType _pt, uint32_t _id) {
-  string _text;
-  string _name(this->getName());
+void
+ZextNode::emitOutputData(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.Out($id)";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _id);
+      static const TemplateString _tmpl("$name.io.Out($id)", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _id});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-ZextNode::printInputEnable(PrintType pt) {
-  string _text;
-  string _name(this->getName());
+void
+ZextNode::emitInputEnable(raw_ostream& _out, PrintType pt) {
+  auto& _name = this->getScalaName();
   switch (pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.enable";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.enable", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
 //===----------------------------------------------------------------------===//
@@ -2919,14 +2894,15 @@ ZextNode::printInputEnable(PrintType pt) {
 std::string
 TruncNode::printDefinition(PrintType _pt) {
   string _text;
-  string _name(this->getName());
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "  val $name = Module(new $type(NumOuts = $num_out))\n\n";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$num_out", std::to_string(this->numDataOutputPort()));
-      helperReplace(_text, "$type", "TruncNode");
+      static const TemplateString _tmpl(
+          "  val $name = Module(new $type(NumOuts = $num_out))\n\n",
+          {"$name", "$num_out", "$type"});
+      _text = _tmpl.render({_name.c_str(),
+                            std::to_string(this->numDataOutputPort()),
+                            "TruncNode"});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
@@ -2935,55 +2911,44 @@ TruncNode::printDefinition(PrintType _pt) {
   return _text;
 }
 
-std::string
-TruncNode::printInputData(PrintType _pt, uint32_t _id) {
-  string _name(this->getName());
-  std::replace(_name.begin(), _name.end(), '.', '_');
-  string _text;
+void
+TruncNode::emitInputData(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      _text = "$name.io.Input";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.Input", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
       break;
     default: break;
   }
-
-  return _text;
 }
 
-std::string
-TruncNode::printOutputData(PrintType _pt, uint32_t _id) {
-  string _text;
-  string _name(this->getName());
+void
+TruncNode::emitOutputData(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.Out($id)";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _id);
+      static const TemplateString _tmpl("$name.io.Out($id)", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _id});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-TruncNode::printInputEnable(PrintType pt) {
-  string _text;
-  string _name(this->getName());
+void
+TruncNode::emitInputEnable(raw_ostream& _out, PrintType pt) {
+  auto& _name = this->getScalaName();
   switch (pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.enable";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.enable", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
 //===----------------------------------------------------------------------===//
@@ -2993,14 +2958,15 @@ TruncNode::printInputEnable(PrintType pt) {
 std::string
 STIoFPNode::printDefinition(PrintType _pt) {
   string _text;
-  string _name(this->getName());
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "  val $name = Module(new $type(NumOuts = $num_out))\n\n";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$num_out", std::to_string(this->numDataOutputPort()));
-      helperReplace(_text, "$type", "STIoFPNode");
+      static const TemplateString _tmpl(
+          "  val $name = Module(new $type(NumOuts = $num_out))\n\n",
+          {"$name", "$num_out", "$type"});
+      _text = _tmpl.render({_name.c_str(),
+                            std::to_string(this->numDataOutputPort()),
+                            "STIoFPNode"});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
@@ -3009,55 +2975,44 @@ STIoFPNode::printDefinition(PrintType _pt) {
   return _text;
 }
 
-std::string
-STIoFPNode::printInputData(PrintType _pt, uint32_t _id) {
-  string _name(this->getName());
-  std::replace(_name.begin(), _name.end(), '.', '_');
-  string _text;
+void
+STIoFPNode::emitInputData(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      _text = "$name.io.Input";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.Input", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
       break;
     default: break;
   }
-
-  return _text;
 }
 
-std::string
-STIoFPNode::printOutputData(PrintType _pt, uint32_t _id) {
-  string _text;
-  string _name(this->getName());
+void
+STIoFPNode::emitOutputData(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.Out($id)";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _id);
+      static const TemplateString _tmpl("$name.io.Out($id)", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _id});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-STIoFPNode::printInputEnable(PrintType pt) {
-  string _text;
-  string _name(this->getName());
+void
+STIoFPNode::emitInputEnable(raw_ostream& _out, PrintType pt) {
+  auto& _name = this->getScalaName();
   switch (pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.enable";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.enable", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
 //===----------------------------------------------------------------------===//
@@ -3067,14 +3022,15 @@ STIoFPNode::printInputEnable(PrintType pt) {
 std::string
 FPToUINode::printDefinition(PrintType _pt) {
   string _text;
-  string _name(this->getName());
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "  val $name = Module(new $type(NumOuts = $num_out))\n\n";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$num_out", std::to_string(this->numDataOutputPort()));
-      helperReplace(_text, "$type", "FPToUINode");
+      static const TemplateString _tmpl(
+          "  val $name = Module(new $type(NumOuts = $num_out))\n\n",
+          {"$name", "$num_out", "$type"});
+      _text = _tmpl.render({_name.c_str(),
+                            std::to_string(this->numDataOutputPort()),
+                            "FPToUINode"});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
@@ -3083,55 +3039,44 @@ FPToUINode::printDefinition(PrintType _pt) {
   return _text;
 }
 
-std::string
-FPToUINode::printInputData(PrintType _pt, uint32_t _id) {
-  string _name(this->getName());
-  std::replace(_name.begin(), _name.end(), '.', '_');
-  string _text;
+void
+FPToUINode::emitInputData(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      _text = "$name.io.Input";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.Input", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
       break;
     default: break;
   }
-
-  return _text;
 }
 
-std::string
-FPToUINode::printOutputData(PrintType _pt, uint32_t _id) {
-  string _text;
-  string _name(this->getName());
+void
+FPToUINode::emitOutputData(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.Out($id)";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _id);
+      static const TemplateString _tmpl("$name.io.Out($id)", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _id});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-FPToUINode::printInputEnable(PrintType pt) {
-  string _text;
-  string _name(this->getName());
+void
+FPToUINode::emitInputEnable(raw_ostream& _out, PrintType pt) {
+  auto& _name = this->getScalaName();
   switch (pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.enable";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.enable", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
 //===----------------------------------------------------------------------===//
@@ -3140,21 +3085,15 @@ FPToUINode::printInputEnable(PrintType pt) {
 std::string
 GepNode::printDefinition(PrintType _pt) {
   string _text("");
-  string _name(this->getName());
+  auto& _name = this->getScalaName();
 
   switch (_pt) {
     case PrintType::Scala: {
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "  val $name = Module(new $type(NumIns = $num_ins, "
-              "NumOuts = $num_out, "
-              "ID = $id)(ElementSize = $size, ArraySize = $array))\n\n";
-      helperReplace(_text, "$type", "GepNode");
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", std::to_string(this->getID()));
-      helperReplace(_text, "$num_out", std::to_string(this->numDataOutputPort()));
-
-      // The first input is always baseaddress
-      helperReplace(_text, "$num_ins", std::to_string(this->numDataInputPort() - 1));
+      static const TemplateString _tmpl(
+          "  val $name = Module(new $type(NumIns = $num_ins, "
+          "NumOuts = $num_out, "
+          "ID = $id)(ElementSize = $size, ArraySize = $array))\n\n",
+          {"$type", "$name", "$id", "$num_out", "$num_ins", "$size", "$array"});
 
       stringstream _array;
       std::copy(this->gep_info.element_size.begin(),
@@ -3162,17 +3101,19 @@ GepNode::printDefinition(PrintType _pt) {
                 std::experimental::make_ostream_joiner(_array, ", "));
 
       /**
-       * TODO: Currently our simulation framework only supports 64bit data
-       * hence, after initialization we only write 64bit data to the
-       * memory even the actual data size 32bit. We need to address this
-       * limitation from simulation and then uncomment the follwoing line
-       * to use proper elementSize instead of hard-coded version.
+       * With packed memory the elements take their real size, otherwise the
+       * simulator writes every element as 64bit data and the index is scaled
+       * by 8 bytes whatever the element type is.
        */
-      // helperReplace(_text, "$size",
-      //*std::prev(this->gep_info.element_size.end()));
-      helperReplace(_text, "$size", 8);
-
-      helperReplace(_text, "$array", "List(" + _array.str() + ")");
+      uint32_t _element_size = packedMemory ? this->gep_info.overall_size : 8;
+      _text = _tmpl.render({"GepNode",
+                            _name.c_str(),
+                            std::to_string(this->getID()),
+                            std::to_string(this->numDataOutputPort()),
+                            // The first input is always baseaddress
+                            std::to_string(this->numDataInputPort() - 1),
+                            _element_size,
+                            "List(" + _array.str() + ")"});
 
       break;
     }
@@ -3181,84 +3122,68 @@ GepNode::printDefinition(PrintType _pt) {
   return _text;
 }
 
-std::string
-GepNode::printInputEnable(PrintType pt, uint32_t _id) {
-  string _text;
-  string _name(this->getName());
+void
+GepNode::emitInputEnable(raw_ostream& _out, PrintType pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.enable($id)";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _id);
+      static const TemplateString _tmpl("$name.io.enable($id)", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _id});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-GepNode::printInputEnable(PrintType pt) {
-  string _text;
-  string _name(this->getName());
+void
+GepNode::emitInputEnable(raw_ostream& _out, PrintType pt) {
+  auto& _name = this->getScalaName();
   switch (pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.enable";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.enable", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-GepNode::printOutputData(PrintType _pt, uint32_t _idx) {
-  string _text;
-  string _name(this->getName());
+void
+GepNode::emitOutputData(raw_ostream& _out, PrintType _pt, uint32_t _idx) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.Out($id)";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _idx);
+      static const TemplateString _tmpl("$name.io.Out($id)", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _idx});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-GepNode::printInputData(PrintType _pt, uint32_t _id) {
-  string _name(this->getName());
-  std::replace(_name.begin(), _name.end(), '.', '_');
-  string _text;
+void
+GepNode::emitInputData(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
       if (_id == 0)
-        _text = "$name.io.baseAddress";
+        _out << _name << ".io.baseAddress";
       // else if (_id == 1){
       //    if(this->numDataInputPort() == 2)
       //        _text = "$name.io.idx";
       //    else
       //        _text = "$name.io.idx1";
       //}
-      else
-        _text = "$name.io.idx($ix)";
-
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$ix", _id - 1);
+      else {
+        static const TemplateString _tmpl("$name.io.idx($ix)", {"$name", "$ix"});
+        _tmpl.render(_out, {_name.c_str(), _id - 1});
+      }
       break;
     default: break;
   }
-
-  return _text;
 }
 
 //===----------------------------------------------------------------------===//
@@ -3285,7 +3210,7 @@ LoopNode::setEndingInstructions() {
 std::string
 LoopNode::printDefinition(PrintType _pt) {
   string _text;
-  string _name(this->getName());
+  auto& _name = this->getScalaName();
 
   auto make_argument_port = [](const auto& _list) {
     std::vector<uint32_t> _arg_count;
@@ -3298,23 +3223,29 @@ LoopNode::printDefinition(PrintType _pt) {
 
   switch (_pt) {
     case PrintType::Scala: {
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "  val $name = Module(new $type(NumIns = "
-              "List($<input_vector>), "
-              "NumOuts = List($<num_out>), "
-              "NumCarry = List($<num_carry>), "
-              "NumExits = $num_exit, ID = $id))\n\n";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", this->getID());
-      helperReplace(_text, "$type", "LoopBlockNode");
-      helperReplace(_text, "$num_exit", static_cast<uint32_t>(this->loop_exits.size()));
+      static const TemplateString _tmpl(
+          "  val $name = Module(new $type(NumIns = "
+          "List($<input_vector>), "
+          "NumOuts = List($<num_out>), "
+          "NumCarry = List($<num_carry>), "
+          "NumExits = $num_exit, ID = $id))\n\n",
+          {"$name",
+           "$id",
+           "$type",
+           "$num_exit",
+           "$<input_vector>",
+           "$<num_out>",
+           "$<num_carry>"});
 
       auto live_in_args = make_argument_port(live_in_lists());
-      helperReplace(_text, "$<input_vector>", live_in_args, ", ");
-
-      helperReplace(_text, "$<num_out>", make_argument_port(live_out_lists()), ", ");
-
-      helperReplace(_text, "$<num_carry>", make_argument_port(carry_depen_lists()), ", ");
+      _text             = _tmpl.render(
+          {_name.c_str(),
+           this->getID(),
+           "LoopBlockNode",
+           static_cast<uint32_t>(this->loop_exits.size()),
+           TemplateArg(live_in_args, ", "),
+           TemplateArg(make_argument_port(live_out_lists()), ", "),
+           TemplateArg(make_argument_port(carry_depen_lists()), ", ")});
 
       break;
     }
@@ -3324,27 +3255,21 @@ LoopNode::printDefinition(PrintType _pt) {
   return _text;
 }
 
-std::string
-LoopNode::printOutputEnable(PrintType _pt) {
-  string _name(this->getName());
-  std::replace(_name.begin(), _name.end(), '.', '_');
-  string _text;
+void
+LoopNode::emitOutputEnable(raw_ostream& _out, PrintType _pt) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      _text = "$name.io.Out.endEnable";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.Out.endEnable", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
       break;
     default: break;
   }
-
-  return _text;
 }
 
-std::string
-LoopNode::printOutputEnable(PrintType _pt, uint32_t _id) {
-  string _name(this->getName());
-  std::replace(_name.begin(), _name.end(), '.', '_');
-  string _text;
+void
+LoopNode::emitOutputEnable(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   auto node   = this->returnControlOutputPortNode(_id);
   auto node_t = find_if(port_type.begin(), port_type.end(), [node](auto _nt) -> bool {
     return _nt.first == node;
@@ -3353,25 +3278,20 @@ LoopNode::printOutputEnable(PrintType _pt, uint32_t _id) {
   switch (_pt) {
     case PrintType::Scala:
       if (node_t->second == PortType::LoopFinish)
-        _text = "$name.io.loopfinish";
+        _out << _name << ".io.loopfinish";
       else if (node_t->second == PortType::Active_Loop_Start)
-        _text = "$name.io.activate_loop_start";
+        _out << _name << ".io.activate_loop_start";
       else if (node_t->second == PortType::Enable)
-        _text = "$name.io.???";
+        _out << _name << ".io.???";
       //_text = "UKNOWN";
-      helperReplace(_text, "$name", _name.c_str());
       break;
     default: break;
   }
-
-  return _text;
 }
 
-std::string
-LoopNode::printOutputEnable(PrintType _pt, PortEntry _port) {
-  string _name(this->getName());
-  std::replace(_name.begin(), _name.end(), '.', '_');
-  string _text;
+void
+LoopNode::emitOutputEnable(raw_ostream& _out, PrintType _pt, PortEntry _port) {
+  auto& _name = this->getScalaName();
 
   auto port_equal = [](auto port_1, auto port_2) -> bool {
     return ((port_1.first == port_2.first)
@@ -3381,55 +3301,49 @@ LoopNode::printOutputEnable(PrintType _pt, PortEntry _port) {
   switch (_pt) {
     case PrintType::Scala:
       if (port_equal(this->activate_loop_start, _port))
-        _text = "$name.io.activate_loop_start";
+        _out << _name << ".io.activate_loop_start";
       else if (port_equal(this->activate_loop_back, _port))
-        _text = "$name.io.activate_loop_back";
+        _out << _name << ".io.activate_loop_back";
       else {
         auto out_port = find_if(this->loop_exits.begin(),
                                 this->loop_exits.end(),
                                 std::bind(port_equal, _1, _port));
 
         if (out_port != this->loop_exits.end()) {
-          _text        = "$name.io.loopExit($id)";
+          static const TemplateString _tmpl("$name.io.loopExit($id)",
+                                            {"$id", "$name"});
           uint32_t pos = std::distance(this->loop_exits.begin(), out_port);
-          helperReplace(_text, "$id", pos);
+          _tmpl.render(_out, {pos, _name.c_str()});
 
         } else
-          _text = "$name.io.XXX";
+          _out << _name << ".io.XXX";
       }
 
-      helperReplace(_text, "$name", _name.c_str());
       break;
     default: break;
   }
-
-  return _text;
 }
 
-std::string
-LoopNode::printInputEnable(PrintType _pt, uint32_t _id) {
-  string _text;
-  string _name(this->getName());
+void
+LoopNode::emitInputEnable(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
       if (_id == 0)
-        _text = "$name.io.enable";
+        _out << _name << ".io.enable";
       else if (_id == 1)
-        _text = "$name.io.loopBack(0)";
-      else if (_id >= 2)
-        _text = "$name.io.loopFinish($id)";
-      else
-        _text = "XXXXXX";
-
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _id - 2);
+        _out << _name << ".io.loopBack(0)";
+      else if (_id >= 2) {
+        static const TemplateString _tmpl("$name.io.loopFinish($id)",
+                                          {"$name", "$id"});
+        _tmpl.render(_out, {_name.c_str(), _id - 2});
+      } else
+        _out << "XXXXXX";
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
 //===----------------------------------------------------------------------===//
@@ -3438,19 +3352,18 @@ LoopNode::printInputEnable(PrintType _pt, uint32_t _id) {
 std::string
 ReattachNode::printDefinition(PrintType _pt) {
   string _text;
-  string _name(this->getName());
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "  val $name = Module(new $type(NumPredOps= "
-              "$num_out, ID = $id))\n\n";
-      helperReplace(_text, "$name", _name.c_str());
-      if (this->numDataInputPort() == 0)
-        helperReplace(_text, "$num_out", std::to_string(1));
-      else
-        helperReplace(_text, "$num_out", std::to_string(this->numDataInputPort()));
-      helperReplace(_text, "$id", this->getID());
-      helperReplace(_text, "$type", "Reattach");
+      static const TemplateString _tmpl(
+          "  val $name = Module(new $type(NumPredOps= "
+          "$num_out, ID = $id))\n\n",
+          {"$name", "$num_out", "$id", "$type"});
+      _text = _tmpl.render(
+          {_name.c_str(),
+           (this->numDataInputPort() == 0) ? 1u : this->numDataInputPort(),
+           this->getID(),
+           "Reattach"});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
@@ -3459,86 +3372,73 @@ ReattachNode::printDefinition(PrintType _pt) {
   return _text;
 }
 
-std::string
-ReattachNode::printInputEnable(PrintType _pt) {
-  string _text;
-  string _name(this->getName());
+void
+ReattachNode::emitInputEnable(raw_ostream& _out, PrintType _pt) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.enable.enq(ControlBundle.active())";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.enable.enq(ControlBundle.active())",
+                                        {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-ReattachNode::printInputEnable(PrintType _pt, uint32_t _id) {
-  string _text;
-  string _name(this->getName());
+void
+ReattachNode::emitInputEnable(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.enable";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.enable", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-ReattachNode::printOutputEnable(PrintType _pt, uint32_t _id) {
-  string _text;
-  string _name(this->getName());
+void
+ReattachNode::emitOutputEnable(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.Out($id)";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _id);
+      static const TemplateString _tmpl("$name.io.Out($id)", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _id});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-ReattachNode::printInputData(PrintType _pt, uint32_t _id) {
-  string _text;
-  string _name(this->getName());
+void
+ReattachNode::emitInputData(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.predicateIn($id)";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _id);
+      static const TemplateString _tmpl("$name.io.predicateIn($id)", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _id});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
 std::string
 ReattachNode::printGround(PrintType _pt) {
-  string _name(this->getName());
-  std::replace(_name.begin(), _name.end(), '.', '_');
+  auto& _name = this->getScalaName();
   string _text;
   switch (_pt) {
     case PrintType::Scala:
-      _text = "$name.io.predicateIn(0).enq(DataBundle.active(1.U))";
-
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl(
+          "$name.io.predicateIn(0).enq(DataBundle.active(1.U))",
+          {"$name"});
+      _text = _tmpl.render({_name.c_str()});
       break;
     default: break;
   }
@@ -3552,14 +3452,12 @@ ReattachNode::printGround(PrintType _pt) {
 std::string
 DetachNode::printDefinition(PrintType _pt) {
   string _text;
-  string _name(this->getName());
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "  val $name = Module(new $type(ID = $id))\n\n";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", this->getID());
-      helperReplace(_text, "$type", "Detach");
+      static const TemplateString _tmpl("  val $name = Module(new $type(ID = $id))\n\n",
+                                        {"$name", "$id", "$type"});
+      _text = _tmpl.render({_name.c_str(), this->getID(), "Detach"});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
@@ -3568,39 +3466,32 @@ DetachNode::printDefinition(PrintType _pt) {
   return _text;
 }
 
-std::string
-DetachNode::printInputEnable(PrintType _pt) {
-  string _text;
-  string _name(this->getName());
+void
+DetachNode::emitInputEnable(raw_ostream& _out, PrintType _pt) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.enable";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.enable", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-DetachNode::printOutputEnable(PrintType pt, uint32_t _id) {
-  string _text;
-  string _name(this->getName());
+void
+DetachNode::emitOutputEnable(raw_ostream& _out, PrintType pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.Out($id)";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _id);
+      static const TemplateString _tmpl("$name.io.Out($id)", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _id});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
 //===----------------------------------------------------------------------===//
@@ -3609,24 +3500,22 @@ DetachNode::printOutputEnable(PrintType pt, uint32_t _id) {
 std::string
 SyncNode::printDefinition(PrintType _pt) {
   string _text;
-  string _name(this->getName());
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "  val $name = Module(new $type(ID = $id, NumInc=$num_inc, "
-              "NumDec=$num_dec, NumOuts=$num_out))\n\n";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", this->getID());
-      helperReplace(_text, "$type", "SyncTC");
-
+      static const TemplateString _tmpl(
+          "  val $name = Module(new $type(ID = $id, NumInc=$num_inc, "
+          "NumDec=$num_dec, NumOuts=$num_out))\n\n",
+          {"$name", "$id", "$type", "$num_inc", "$num_dec", "$num_out"});
       // TODO add special port for increase and decrease
-      helperReplace(_text, "$num_inc", 1);
-      helperReplace(_text, "$num_dec", 1);
-
-      if (this->numDataOutputPort() == 0)
-        helperReplace(_text, "$num_out", 1);
-      else
-        helperReplace(_text, "$num_out", this->numDataOutputPort());
+      _text = _tmpl.render({_name.c_str(),
+                            this->getID(),
+                            "SyncTC",
+                            1,
+                            1,
+                            (this->numDataOutputPort() == 0)
+                                ? 1u
+                                : this->numDataOutputPort()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
@@ -3635,61 +3524,50 @@ SyncNode::printDefinition(PrintType _pt) {
   return _text;
 }
 
-std::string
-SyncNode::printInputEnable(PrintType _pt) {
-  string _text;
-  string _name(this->getName());
+void
+SyncNode::emitInputEnable(raw_ostream& _out, PrintType _pt) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.enable";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.enable", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-SyncNode::printInputEnable(PrintType _pt, uint32_t _id) {
-  string _text;
-  string _name(this->getName());
+void
+SyncNode::emitInputEnable(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
       if (_id == 1)
-        _text = "$name.io.incIn(0)";
+        _out << _name << ".io.incIn(0)";
       else if (_id == 2)
-        _text = "$name.io.decIn(0)";
+        _out << _name << ".io.decIn(0)";
       else
         assert(!"Sync node can not have more than three control inputs!");
-      helperReplace(_text, "$name", _name.c_str());
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-SyncNode::printOutputEnable(PrintType pt, uint32_t _id) {
-  string _text;
-  string _name(this->getName());
+void
+SyncNode::emitOutputEnable(raw_ostream& _out, PrintType pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.Out($id)";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _id);
+      static const TemplateString _tmpl("$name.io.Out($id)", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _id});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
 //===----------------------------------------------------------------------===//
@@ -3699,16 +3577,17 @@ SyncNode::printOutputEnable(PrintType pt, uint32_t _id) {
 std::string
 AllocaNode::printDefinition(PrintType _pt) {
   string _text;
-  string _name(this->getName());
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "  val $name = Module(new $type(NumOuts=$num_out, ID = $id"
-              "))\n\n";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", this->getID());
-      helperReplace(_text, "$num_out", this->numDataOutputPort());
-      helperReplace(_text, "$type", "AllocaConstNode");
+      static const TemplateString _tmpl(
+          "  val $name = Module(new $type(NumOuts=$num_out, ID = $id"
+          "))\n\n",
+          {"$name", "$id", "$num_out", "$type"});
+      _text = _tmpl.render({_name.c_str(),
+                            this->getID(),
+                            this->numDataOutputPort(),
+                            "AllocaConstNode"});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
@@ -3717,129 +3596,107 @@ AllocaNode::printDefinition(PrintType _pt) {
   return _text;
 }
 
-std::string
-AllocaNode::printInputData(PrintType _pt, uint32_t _id) {
-  string _name(this->getName());
-  std::replace(_name.begin(), _name.end(), '.', '_');
-  string _text;
+void
+AllocaNode::emitInputData(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      _text = "$name.io.CmpIO";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.CmpIO", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
       break;
     default: break;
   }
-
-  return _text;
 }
 
-std::string
-AllocaNode::printOutputData(PrintType _pt, uint32_t _idx) {
-  string _text;
-  string _name(this->getName());
+void
+AllocaNode::emitOutputData(raw_ostream& _out, PrintType _pt, uint32_t _idx) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.Out($id)";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _idx);
+      static const TemplateString _tmpl("$name.io.Out($id)", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _idx});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-AllocaNode::printInputEnable(PrintType _pt) {
-  string _text;
-  string _name(this->getName());
+void
+AllocaNode::emitInputEnable(raw_ostream& _out, PrintType _pt) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.enable";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.enable", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-AllocaNode::printInputEnable(PrintType _pt, uint32_t _id) {
-  string _text;
-  string _name(this->getName());
+void
+AllocaNode::emitInputEnable(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.enable";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.enable", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-AllocaNode::printMemReadInput(PrintType _pt, uint32_t _idx) {
-  string _text;
-  string _name(this->getName());
+void
+AllocaNode::emitMemReadInput(raw_ostream& _out, PrintType _pt, uint32_t _idx) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.allocaRespIO";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.allocaRespIO", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-AllocaNode::printMemReadOutput(PrintType _pt, uint32_t _idx) {
-  string _text;
-  string _name(this->getName());
+void
+AllocaNode::emitMemReadOutput(raw_ostream& _out, PrintType _pt, uint32_t _idx) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.allocaReqIO";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.allocaReqIO", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
 std::string
 AllocaNode::printOffset(PrintType _pt) {
   string _text;
-  string _name(this->getName());
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "  $name.io.allocaInputIO.bits.size      := "
-              "$size.U\n"
-              "  $name.io.allocaInputIO.bits.numByte   := "
-              "$num_byte.U\n"
-              "  $name.io.allocaInputIO.bits.predicate := "
-              "true.B\n"
-              "  $name.io.allocaInputIO.bits.valid     := "
-              "true.B\n"
-              "  $name.io.allocaInputIO.valid          := "
-              "true.B\n\n";
-
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$num_byte", getNumByte());
-      helperReplace(_text, "$size", getSize());
+      static const TemplateString _tmpl(
+          "  $name.io.allocaInputIO.bits.size      := "
+          "$size.U\n"
+          "  $name.io.allocaInputIO.bits.numByte   := "
+          "$num_byte.U\n"
+          "  $name.io.allocaInputIO.bits.predicate := "
+          "true.B\n"
+          "  $name.io.allocaInputIO.bits.valid     := "
+          "true.B\n"
+          "  $name.io.allocaInputIO.valid          := "
+          "true.B\n\n",
+          {"$name", "$num_byte", "$size"});
+      _text = _tmpl.render({_name.c_str(), getNumByte(), getSize()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
@@ -3863,7 +3720,7 @@ CallNode::setCallOutEnable(Node* _n) {
 std::string
 CallInNode::printDefinition(PrintType _pt) {
   string _text;
-  string _name(this->getName());
+  auto& _name = this->getScalaName();
 
   auto make_argument_port = [](const auto& _list) {
     std::vector<uint32_t> _arg_count;
@@ -3876,14 +3733,15 @@ CallInNode::printDefinition(PrintType _pt) {
 
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "  val $name = Module(new $type(ID = $id"
-              ", argTypes = List($<output_vector>)))\n\n";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", this->getID());
-      helperReplace(_text, "$type", "CallInNode");
-      helperReplace(
-          _text, "$<output_vector>", make_argument_port(this->output_data_range()), ",");
+      static const TemplateString _tmpl(
+          "  val $name = Module(new $type(ID = $id"
+          ", argTypes = List($<output_vector>)))\n\n",
+          {"$name", "$id", "$type", "$<output_vector>"});
+      _text = _tmpl.render(
+          {_name.c_str(),
+           this->getID(),
+           "CallInNode",
+           TemplateArg(make_argument_port(this->output_data_range()), ",")});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
@@ -3892,56 +3750,47 @@ CallInNode::printDefinition(PrintType _pt) {
   return _text;
 }
 
-std::string
-CallInNode::printOutputData(PrintType _pt, uint32_t _id) {
-  string _text;
-  string _name(this->getName());
+void
+CallInNode::emitOutputData(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.Out.data(\"field$id\")";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _id);
+      static const TemplateString _tmpl("$name.io.Out.data(\"field$id\")",
+                                        {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _id});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-CallInNode::printOutputEnable(PrintType _pt) {
-  string _text;
-  string _name(this->getName());
+void
+CallInNode::emitOutputEnable(raw_ostream& _out, PrintType _pt) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.Out.enable.ready := true.B";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.Out.enable.ready := true.B", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-CallInNode::printOutputEnable(PrintType _pt, uint32_t _id) {
-  string _text;
-  string _name(this->getName());
+void
+CallInNode::emitOutputEnable(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.Out.enable";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.Out.enable", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
 //===----------------------------------------------------------------------===//
@@ -3950,19 +3799,21 @@ CallInNode::printOutputEnable(PrintType _pt, uint32_t _id) {
 std::string
 CallOutNode::printDefinition(PrintType _pt) {
   string _text;
-  string _name(this->getName());
+  auto& _name = this->getScalaName();
 
   switch (_pt) {
     case PrintType::Scala: {
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "  val $name = Module(new $type(ID = $id"
-              ", NumSuccOps = $num_succ, PtrsTypes = "
-              "List($<input_ptr_vector>), "
-              "ValsTypes = List($<input_val_vector>)))\n\n";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", this->getID());
-      helperReplace(_text, "$type", "CallOutDCRNode");
-      helperReplace(_text, "$num_succ", this->numControlOutputPort());
+      static const TemplateString _tmpl(
+          "  val $name = Module(new $type(ID = $id"
+          ", NumSuccOps = $num_succ, PtrsTypes = "
+          "List($<input_ptr_vector>), "
+          "ValsTypes = List($<input_val_vector>)))\n\n",
+          {"$name",
+           "$id",
+           "$type",
+           "$num_succ",
+           "$<input_ptr_vector>",
+           "$<input_val_vector>"});
 
       uint32_t num_ptrs = 0;
       uint32_t num_vals = 0;
@@ -3980,10 +3831,13 @@ CallOutNode::printDefinition(PrintType _pt) {
         }
       }
 
-      helperReplace(
-          _text, "$<input_ptr_vector>", std::vector<uint32_t>(num_ptrs, DATA_SIZE), ",");
-      helperReplace(
-          _text, "$<input_val_vector>", std::vector<uint32_t>(num_vals, DATA_SIZE), ",");
+      _text = _tmpl.render(
+          {_name.c_str(),
+           this->getID(),
+           "CallOutDCRNode",
+           this->numControlOutputPort(),
+           TemplateArg(std::vector<uint32_t>(num_ptrs, DATA_SIZE), ","),
+           TemplateArg(std::vector<uint32_t>(num_vals, DATA_SIZE), ",")});
 
       // helperReplace(_text, "$num_out", this->numDataOutputPort());
 
@@ -3995,109 +3849,95 @@ CallOutNode::printDefinition(PrintType _pt) {
   return _text;
 }
 
-std::string
-CallOutNode::printInputEnable(PrintType pt) {
-  string _text;
-  string _name(this->getName());
+void
+CallOutNode::emitInputEnable(raw_ostream& _out, PrintType pt) {
+  auto& _name = this->getScalaName();
   switch (pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.enable";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.enable", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-CallOutNode::printInputData(PrintType _pt, uint32_t _id) {
-  string _name(this->getName());
-  std::replace(_name.begin(), _name.end(), '.', '_');
-  string _text;
+void
+CallOutNode::emitInputData(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala: {
       auto iter = this->inputDataport_begin();
       std::advance(iter, _id);
+      static const TemplateString _tmpl_ptr("$name.io.inPtrs.elements(\"field$id\")",
+                                            {"$name", "$id"});
+      static const TemplateString _tmpl_val("$name.io.inVals.elements(\"field$id\")",
+                                            {"$name", "$id"});
+      const TemplateString* _tmpl = nullptr;
       if (auto instr = dyn_cast<InstructionNode>(&*iter->first)) {
         if (instr->getDataType() == Node::PointerType)
-          _text = "$name.io.inPtrs.elements(\"field$id\")";
+          _tmpl = &_tmpl_ptr;
         else
-          _text = "$name.io.inVals.elements(\"field$id\")";
+          _tmpl = &_tmpl_val;
       } else if (auto arg = dyn_cast<ArgumentNode>(&*iter->first)) {
         if (arg->getDataArgType() == Node::PointerType)
-          _text = "$name.io.inPtrs.elements(\"field$id\")";
+          _tmpl = &_tmpl_ptr;
         else
-          _text = "$name.io.inVals.elements(\"field$id\")";
+          _tmpl = &_tmpl_val;
       } else {
         std::cout << instr->getName() << "\n";
         throw std::runtime_error("Input datatype is Uknown");
       }
 
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _id);
+      _tmpl->render(_out, {_name.c_str(), _id});
       break;
     }
     default: break;
   }
-
-  return _text;
 }
 
-std::string
-CallOutNode::printOutputData(PrintType _pt, uint32_t _idx) {
-  string _text;
-  string _name(this->getName());
+void
+CallOutNode::emitOutputData(raw_ostream& _out, PrintType _pt, uint32_t _idx) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.Out($id)";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _idx);
+      static const TemplateString _tmpl("$name.io.Out($id)", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _idx});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
 //===----------------------------------------------------------------------===//
 //                            CallInNode Class
 //===----------------------------------------------------------------------===//
-std::string
-CallInNode::printInputEnable(PrintType pt) {
-  string _text;
-  string _name(this->getName());
+void
+CallInNode::emitInputEnable(raw_ostream& _out, PrintType pt) {
+  auto& _name = this->getScalaName();
   switch (pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.enable";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.enable", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-CallInNode::printInputData(PrintType _pt) {
-  string _name(this->getName());
-  std::replace(_name.begin(), _name.end(), '.', '_');
-  string _text;
+void
+CallInNode::emitInputData(raw_ostream& _out, PrintType _pt) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      _text = "$name.io.In";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.In", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
       break;
     default: break;
   }
-
-  return _text;
 }
 
 //===----------------------------------------------------------------------===//
@@ -4106,22 +3946,22 @@ CallInNode::printInputData(PrintType _pt) {
 std::string
 ScratchpadNode::printDefinition(PrintType _pt) {
   string _text;
-  string _name(this->getName());
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "  //$name"
-              "\n  val $name = Module(new CacheMemoryEngine(ID = $id, "
-              "NumRead = $num_read, NumWrite = $num_write))\n\n"
-              "  $alloca_mem_req <> $name.io.cache.MemReq\n"
-              "  $name.io.cache.MemResp <> $alloca_mem_resp\n\n";
-
-      helperReplace(_text, "$id", this->getID());
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$alloca", this->getAllocaNode()->getName());
-      helperReplace(_text, "$num_read", this->numReadDataInputPort());
-      helperReplace(_text, "$num_write", this->numWriteDataInputPort());
-      helperReplace(_text, "$size", this->getMemSize());
+      static const TemplateString _tmpl(
+          "  //$name"
+          "\n  val $name = Module(new CacheMemoryEngine(ID = $id, "
+          "NumRead = $num_read, NumWrite = $num_write))\n\n"
+          "  $alloca_mem_req <> $name.io.cache.MemReq\n"
+          "  $name.io.cache.MemResp <> $alloca_mem_resp\n\n",
+          {"$id", "$name", "$alloca", "$num_read", "$num_write", "$size"});
+      _text = _tmpl.render({this->getID(),
+                            _name.c_str(),
+                            this->getAllocaNode()->getName(),
+                            this->numReadDataInputPort(),
+                            this->numWriteDataInputPort(),
+                            this->getMemSize()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
@@ -4130,76 +3970,60 @@ ScratchpadNode::printDefinition(PrintType _pt) {
   return _text;
 }
 
-std::string
-ScratchpadNode::printMemReadInput(PrintType _pt, uint32_t _idx) {
-  string _text;
-  string _name(this->getName());
+void
+ScratchpadNode::emitMemReadInput(raw_ostream& _out, PrintType _pt, uint32_t _idx) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.rd.mem($id).MemReq";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _idx);
+      static const TemplateString _tmpl("$name.io.rd.mem($id).MemReq", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _idx});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-ScratchpadNode::printMemReadOutput(PrintType _pt, uint32_t _idx) {
-  string _text;
-  string _name(this->getName());
+void
+ScratchpadNode::emitMemReadOutput(raw_ostream& _out, PrintType _pt, uint32_t _idx) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.rd.mem($id).MemResp";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _idx);
+      static const TemplateString _tmpl("$name.io.rd.mem($id).MemResp", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _idx});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-ScratchpadNode::printMemWriteInput(PrintType _pt, uint32_t _idx) {
-  string _text;
-  string _name(this->getName());
+void
+ScratchpadNode::emitMemWriteInput(raw_ostream& _out, PrintType _pt, uint32_t _idx) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.wr.mem($id).MemReq";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _idx);
+      static const TemplateString _tmpl("$name.io.wr.mem($id).MemReq", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _idx});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-ScratchpadNode::printMemWriteOutput(PrintType _pt, uint32_t _idx) {
-  string _text;
-  string _name(this->getName());
+void
+ScratchpadNode::emitMemWriteOutput(raw_ostream& _out, PrintType _pt, uint32_t _idx) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.wr.mem($id).MemResp";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _idx);
+      static const TemplateString _tmpl("$name.io.wr.mem($id).MemResp", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _idx});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
 //===----------------------------------------------------------------------===//
@@ -4208,14 +4032,14 @@ ScratchpadNode::printMemWriteOutput(PrintType _pt, uint32_t _idx) {
 std::string
 FloatingPointNode::printDefinition(PrintType _pt) {
   string _text;
-  string _name(this->getName());
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "  val SharedFPU = Module(new SharedFPU(NumOps = $op, "
-              "PipeDepth = 32)(fType))\n\n";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$op", this->numReadDataInputPort());
+      static const TemplateString _tmpl(
+          "  val SharedFPU = Module(new SharedFPU(NumOps = $op, "
+          "PipeDepth = 32)(fType))\n\n",
+          {"$name", "$op"});
+      _text = _tmpl.render({_name.c_str(), this->numReadDataInputPort()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
@@ -4224,40 +4048,32 @@ FloatingPointNode::printDefinition(PrintType _pt) {
   return _text;
 }
 
-std::string
-FloatingPointNode::printMemReadInput(PrintType _pt, uint32_t _idx) {
-  string _text;
-  string _name(this->getName());
+void
+FloatingPointNode::emitMemReadInput(raw_ostream& _out, PrintType _pt, uint32_t _idx) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.InData($id)";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _idx);
+      static const TemplateString _tmpl("$name.io.InData($id)", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _idx});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-FloatingPointNode::printMemReadOutput(PrintType _pt, uint32_t _idx) {
-  string _text;
-  string _name(this->getName());
+void
+FloatingPointNode::emitMemReadOutput(raw_ostream& _out, PrintType _pt, uint32_t _idx) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.OutData($id)";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _idx);
+      static const TemplateString _tmpl("$name.io.OutData($id)", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _idx});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
 //===----------------------------------------------------------------------===//
@@ -4267,16 +4083,17 @@ FloatingPointNode::printMemReadOutput(PrintType _pt, uint32_t _idx) {
 std::string
 BitcastNode::printDefinition(PrintType _pt) {
   string _text;
-  string _name(this->getName());
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "  val $name = Module(new $type(NumOuts = "
-              "$num_out, ID = $id))\n\n";
-      helperReplace(_text, "$id", std::to_string(this->getID()));
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$type", "BitCastNode");
-      helperReplace(_text, "$num_out", std::to_string(this->numDataOutputPort()));
+      static const TemplateString _tmpl(
+          "  val $name = Module(new $type(NumOuts = "
+          "$num_out, ID = $id))\n\n",
+          {"$id", "$name", "$type", "$num_out"});
+      _text = _tmpl.render({std::to_string(this->getID()),
+                            _name.c_str(),
+                            "BitCastNode",
+                            std::to_string(this->numDataOutputPort())});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
@@ -4285,33 +4102,111 @@ BitcastNode::printDefinition(PrintType _pt) {
   return _text;
 }
 
-std::string
-BitcastNode::printInputEnable(PrintType _pt) {
-  string _text;
-  string _name(this->getName());
+void
+BitcastNode::emitInputEnable(raw_ostream& _out, PrintType _pt) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.enable";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl("$name.io.enable", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
     default: assert(!"Uknown print type!");
   }
-  return _text;
 }
 
-std::string
-BitcastNode::printOutputData(PrintType _pt, uint32_t _id) {
-  string _text;
-  string _name(this->getName());
+void
+BitcastNode::emitOutputData(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
+  switch (_pt) {
+    case PrintType::Scala:
+      static const TemplateString _tmpl("$name.io.Out($id)", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _id});
+
+      break;
+    case PrintType::Dot: assert(!"Dot file format is not supported!");
+    default: assert(!"Uknown print type!");
+  }
+}
+
+void
+BitcastNode::emitInputData(raw_ostream& _out, PrintType _pt, uint32_t _idx) {
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.Out($id)";
-      helperReplace(_text, "$name", _name.c_str());
-      helperReplace(_text, "$id", _id);
+      static const TemplateString _tmpl("$name.io.Input", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
+
+      break;
+    case PrintType::Dot: assert(!"Dot file format is not supported!");
+    default: assert(!"Uknown print type!");
+  }
+}
+
+//===----------------------------------------------------------------------===//
+//                            FusedComputeNode Class
+//===----------------------------------------------------------------------===//
+
+/**
+ * The module latches the enable and every input, then computes the expression
+ * over the latched data in one cycle and holds the result until all of its
+ * outputs have taken it. The result is predicated off when the enable or any
+ * of the inputs is.
+ */
+std::string
+FusedComputeNode::printModule(PrintType _pt) {
+  string _text;
+  switch (_pt) {
+    case PrintType::Scala:
+      static const TemplateString _tmpl(
+          "class $module(NumIns: Int, NumOuts: Int, ID: Int)(implicit val p: "
+          "Parameters)\n"
+          "    extends Module with HasAccelParams {\n"
+          "  val io = IO(new Bundle {\n"
+          "    val enable = Flipped(Decoupled(new ControlBundle))\n"
+          "    val In = Flipped(Vec(NumIns, Decoupled(new DataBundle)))\n"
+          "    val Out = Vec(NumOuts, Decoupled(new DataBundle))\n"
+          "  })\n\n"
+          "  val enable_R = RegInit(ControlBundle.default)\n"
+          "  val enable_valid_R = RegInit(false.B)\n"
+          "  val in_R = Seq.fill(NumIns)(RegInit(DataBundle.default))\n"
+          "  val in_valid_R = Seq.fill(NumIns)(RegInit(false.B))\n"
+          "  val out_R = RegInit(DataBundle.default)\n"
+          "  val out_valid_R = Seq.fill(NumOuts)(RegInit(false.B))\n\n"
+          "  io.enable.ready := ~enable_valid_R\n"
+          "  when(io.enable.fire) {\n"
+          "    enable_R := io.enable.bits\n"
+          "    enable_valid_R := true.B\n"
+          "  }\n"
+          "  for (i <- 0 until NumIns) {\n"
+          "    io.In(i).ready := ~in_valid_R(i)\n"
+          "    when(io.In(i).fire) {\n"
+          "      in_R(i) := io.In(i).bits\n"
+          "      in_valid_R(i) := true.B\n"
+          "    }\n"
+          "  }\n"
+          "  for (i <- 0 until NumOuts) {\n"
+          "    io.Out(i).bits := out_R\n"
+          "    io.Out(i).valid := out_valid_R(i)\n"
+          "    when(io.Out(i).fire) {\n"
+          "      out_valid_R(i) := false.B\n"
+          "    }\n"
+          "  }\n\n"
+          "  val in = in_R.map(_.data)\n"
+          "  val busy = out_valid_R.foldLeft(false.B)(_ || _)\n"
+          "  when(enable_valid_R && in_valid_R.foldLeft(true.B)(_ && _) && !busy) {\n"
+          "    out_R.data := $expr\n"
+          "    out_R.predicate := enable_R.control && "
+          "in_R.foldLeft(true.B)(_ && _.predicate)\n"
+          "    out_R.taskID := enable_R.taskID\n"
+          "    out_valid_R.foreach(_ := true.B)\n"
+          "    enable_valid_R := false.B\n"
+          "    in_valid_R.foreach(_ := false.B)\n"
+          "  }\n"
+          "}\n\n",
+          {"$module", "$expr"});
+      _text = _tmpl.render({this->getModuleName(), this->getExpression()});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
@@ -4321,14 +4216,20 @@ BitcastNode::printOutputData(PrintType _pt, uint32_t _id) {
 }
 
 std::string
-BitcastNode::printInputData(PrintType _pt, uint32_t _idx) {
+FusedComputeNode::printDefinition(PrintType _pt) {
   string _text;
-  string _name(this->getName());
+  auto& _name = this->getScalaName();
   switch (_pt) {
     case PrintType::Scala:
-      std::replace(_name.begin(), _name.end(), '.', '_');
-      _text = "$name.io.Input";
-      helperReplace(_text, "$name", _name.c_str());
+      static const TemplateString _tmpl(
+          "  val $name = Module(new $module(NumIns = $num_in, NumOuts = $num_out, "
+          "ID = $id))\n\n",
+          {"$name", "$module", "$num_in", "$num_out", "$id"});
+      _text = _tmpl.render({_name.c_str(),
+                            this->getModuleName(),
+                            std::to_string(this->numDataInputPort()),
+                            std::to_string(this->numDataOutputPort()),
+                            std::to_string(this->getID())});
 
       break;
     case PrintType::Dot: assert(!"Dot file format is not supported!");
@@ -4336,3 +4237,45 @@ BitcastNode::printInputData(PrintType _pt, uint32_t _idx) {
   }
   return _text;
 }
+
+void
+FusedComputeNode::emitInputEnable(raw_ostream& _out, PrintType _pt) {
+  auto& _name = this->getScalaName();
+  switch (_pt) {
+    case PrintType::Scala:
+      static const TemplateString _tmpl("$name.io.enable", {"$name"});
+      _tmpl.render(_out, {_name.c_str()});
+
+      break;
+    case PrintType::Dot: assert(!"Dot file format is not supported!");
+    default: assert(!"Uknown print type!");
+  }
+}
+
+void
+FusedComputeNode::emitOutputData(raw_ostream& _out, PrintType _pt, uint32_t _id) {
+  auto& _name = this->getScalaName();
+  switch (_pt) {
+    case PrintType::Scala:
+      static const TemplateString _tmpl("$name.io.Out($id)", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _id});
+
+      break;
+    case PrintType::Dot: assert(!"Dot file format is not supported!");
+    default: assert(!"Uknown print type!");
+  }
+}
+
+void
+FusedComputeNode::emitInputData(raw_ostream& _out, PrintType _pt, uint32_t _idx) {
+  auto& _name = this->getScalaName();
+  switch (_pt) {
+    case PrintType::Scala:
+      static const TemplateString _tmpl("$name.io.In($id)", {"$name", "$id"});
+      _tmpl.render(_out, {_name.c_str(), _idx});
+
+      break;
+    case PrintType::Dot: assert(!"Dot file format is not supported!");
+    default: assert(!"Uknown print type!");
+  }
+}
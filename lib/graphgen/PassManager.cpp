@@ -0,0 +1,70 @@
+#define DEBUG_TYPE "graphgen"
+
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include "Dandelion/PassManager.h"
+#include "Dandelion/Stats.h"
+
+#include <algorithm>
+
+using namespace llvm;
+using namespace dandelion;
+
+void
+passes::AnalysisManager::invalidate(const passes::PreservedAnalyses& _preserved) {
+  for (auto _it = results.begin(); _it != results.end();) {
+    if (_preserved.isPreserved(_it->first))
+      ++_it;
+    else
+      _it = results.erase(_it);
+  }
+}
+
+void
+passes::PassManager::addPass(std::unique_ptr<GraphPass> _pass) {
+  pipeline.push_back(std::move(_pass));
+}
+
+bool
+passes::PassManager::addPass(StringRef _name) {
+  auto _pass = createGraphPass(_name);
+  if (!_pass)
+    return false;
+  addPass(std::move(_pass));
+  return true;
+}
+
+bool
+passes::PassManager::hasPass(StringRef _name) const {
+  return std::any_of(pipeline.begin(), pipeline.end(), [_name](auto& _pass) {
+    return _name == _pass->getName();
+  });
+}
+
+void
+passes::PassManager::print(raw_ostream& _out) const {
+  for (auto& _pass : pipeline)
+    _out << (&_pass == &pipeline.front() ? "" : ",") << _pass->getName();
+}
+
+/**
+ * Runs the passes in order, the analyses a pass didn't preserve are dropped
+ * before the next one so it can't see a stale result
+ */
+void
+passes::PassManager::run(Graph& _graph) {
+  auto& _name = _graph.graph_info.Name;
+  passes::AnalysisManager _am(_graph);
+
+  DEBUG(dbgs() << "Running graph passes on " << _name << ": ";
+        print(dbgs());
+        dbgs() << "\n");
+
+  for (auto& _pass : pipeline) {
+    DEBUG(dbgs() << "\t Running " << _pass->getName() << "\n");
+
+    stats::StageTimer _timer(_name, _pass->getName());
+    _am.invalidate(_pass->run(_graph, _am));
+  }
+}
@@ -0,0 +1,200 @@
+#define DEBUG_TYPE "graphgen"
+
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/raw_ostream.h"
+
+#ifdef __APPLE__
+#include "json/json.h"
+#else
+#include "jsoncpp/json/json.h"
+#endif
+
+#include "Dandelion/Stats.h"
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+using namespace llvm;
+using namespace dandelion;
+
+namespace {
+
+struct StageRecord {
+  std::string name;
+  bool nested;
+  uint64_t calls;
+  double wall_ms;
+  uint64_t peak_rss_delta_kb;
+};
+
+struct GraphRecord {
+  // Stages in the order they first run
+  std::vector<StageRecord> stages;
+  // Group (nodes, edges or ports) -> kind -> count
+  std::map<std::string, std::map<std::string, uint64_t>> counts;
+};
+
+bool enabled = false;
+
+// Number of the stage timers running on the thread
+thread_local uint32_t stage_depth = 0;
+
+std::mutex records_lock;
+// Graphs in the order they are first seen
+std::vector<std::string> graph_order;
+std::map<std::string, GraphRecord> graph_records;
+
+GraphRecord&
+getGraphRecord(StringRef _graph) {
+  auto _it = graph_records.find(_graph.str());
+  if (_it != graph_records.end())
+    return _it->second;
+
+  graph_order.push_back(_graph.str());
+  return graph_records[_graph.str()];
+}
+
+}  // namespace
+
+void
+stats::enable() {
+  enabled = true;
+}
+
+bool
+stats::isEnabled() {
+  return enabled;
+}
+
+uint64_t
+stats::getPeakRSS() {
+#ifdef _WIN32
+  return 0;
+#else
+  struct rusage _usage;
+  if (getrusage(RUSAGE_SELF, &_usage) != 0)
+    return 0;
+#ifdef __APPLE__
+  // Darwin reports it in bytes
+  return _usage.ru_maxrss / 1024;
+#else
+  return _usage.ru_maxrss;
+#endif
+#endif
+}
+
+void
+stats::addStage(StringRef graph,
+                StringRef stage,
+                double wall_ms,
+                uint64_t peak_rss_delta_kb,
+                bool nested) {
+  std::lock_guard<std::mutex> _guard(records_lock);
+  auto& _stages = getGraphRecord(graph).stages;
+
+  auto _it = std::find_if(_stages.begin(), _stages.end(), [stage, nested](auto& _rec) {
+    return _rec.name == stage && _rec.nested == nested;
+  });
+  if (_it == _stages.end()) {
+    _stages.push_back(StageRecord{stage.str(), nested, 0, 0, 0});
+    _it = std::prev(_stages.end());
+  }
+
+  _it->calls++;
+  _it->wall_ms += wall_ms;
+  _it->peak_rss_delta_kb += peak_rss_delta_kb;
+}
+
+void
+stats::setCount(StringRef graph, StringRef group, StringRef kind, uint64_t count) {
+  std::lock_guard<std::mutex> _guard(records_lock);
+  getGraphRecord(graph).counts[group.str()][kind.str()] = count;
+}
+
+bool
+stats::writeJSON(StringRef path) {
+  Json::Value _root_json;
+
+  {
+    std::lock_guard<std::mutex> _guard(records_lock);
+    for (auto& _name : graph_order) {
+      auto& _graph = graph_records[_name];
+
+      Json::Value _graph_entry;
+      _graph_entry["name"] = _name;
+
+      // Stages are kept in an array, JSON objects lose the running order
+      double _total_ms = 0;
+      for (auto& _stage : _graph.stages) {
+        Json::Value _stage_entry;
+        _stage_entry["name"]              = _stage.name;
+        _stage_entry["calls"]             = Json::UInt64(_stage.calls);
+        _stage_entry["wall_ms"]           = _stage.wall_ms;
+        _stage_entry["peak_rss_delta_kb"] = Json::UInt64(_stage.peak_rss_delta_kb);
+
+        // The outer stage already counts the nested ones
+        if (_stage.nested)
+          _stage_entry["nested"] = true;
+        else
+          _total_ms += _stage.wall_ms;
+        _graph_entry["stages"].append(_stage_entry);
+      }
+      _graph_entry["wall_ms"] = _total_ms;
+
+      for (auto& _group : _graph.counts) {
+        for (auto& _count : _group.second)
+          _graph_entry[_group.first][_count.first] = Json::UInt64(_count.second);
+      }
+
+      _root_json["graphs"].append(_graph_entry);
+    }
+  }
+  _root_json["peak_rss_kb"] = Json::UInt64(getPeakRSS());
+
+  std::error_code _errc;
+  raw_fd_ostream _out(path, _errc, sys::fs::F_None);
+  if (_errc)
+    return false;
+
+  std::stringstream _out_json;
+  _out_json << _root_json;
+  _out << _out_json.str();
+  return true;
+}
+
+//===----------------------------------------------------------------------===//
+//                            StageTimer Class
+//===----------------------------------------------------------------------===//
+
+stats::StageTimer::StageTimer(StringRef _graph, const char* _stage)
+  : stage(_stage), active(stats::isEnabled()), nested(false), start_rss(0) {
+  if (!active)
+    return;
+
+  nested    = stage_depth++ > 0;
+  graph     = _graph.str();
+  start_rss = getPeakRSS();
+  start     = std::chrono::steady_clock::now();
+}
+
+stats::StageTimer::~StageTimer() {
+  if (!active)
+    return;
+
+  auto _wall = std::chrono::steady_clock::now() - start;
+  stage_depth--;
+  addStage(graph,
+           stage,
+           std::chrono::duration<double, std::milli>(_wall).count(),
+           getPeakRSS() - start_rss,
+           nested);
+}
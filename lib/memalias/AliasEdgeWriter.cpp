@@ -7,6 +7,7 @@
 #include "llvm/Analysis/AliasAnalysis.h"
 #include "llvm/Analysis/BasicAliasAnalysis.h"
 #include "llvm/Analysis/CFG.h"
+#include "llvm/Analysis/MemoryLocation.h"
 #include "llvm/Analysis/TypeBasedAliasAnalysis.h"
 #include "llvm/IR/BasicBlock.h"
 #include "llvm/IR/CFG.h"
@@ -35,6 +36,7 @@ void AliasEdgeWriter::writeEdges(CallInst *CI, Function *OF) {
     // Get all the things we need to check
     // aliasing for
     SetVector<Instruction *> MemOps;
+    AnalyzedFunctions.insert(OF);
     ReversePostOrderTraversal<Function *> RPOT(OF);
     for (auto BB = RPOT.begin(); BB != RPOT.end(); ++BB) {
         for (auto &I : **BB) {
@@ -57,9 +59,11 @@ void AliasEdgeWriter::writeEdges(CallInst *CI, Function *OF) {
 
     // Setup Arg-Param Map for use with IPAA
     // What if I set this up for all functions and their callsites
+    // Without a callsite the arguments stay unknown
     ValueToValueMapTy ArgParamMap;
     uint32_t Idx = 0;
     for (auto &A : OF->args()) {
+        if (!CI) break;
         ArgParamMap[&A] = CI->getArgOperand(Idx++);
     }
 
@@ -107,76 +111,140 @@ void AliasEdgeWriter::writeEdges(CallInst *CI, Function *OF) {
         return V;
     };
 
-    Data["num-aa-pairs"] = 0;
-    Data["num-no-alias"] = 0;
-    Data["num-must-alias"] = 0;
-    Data["num-partial-alias"] = 0;
-    Data["num-may-alias-naive"] = 0;
-    Data["num-ld-ld-pairs"] = 0;
-    Data["num-ipaa-no-alias"] = 0;
-    Data["num-ipaa-may-alias"] = 0;
-
-    for (auto MB = MemOps.begin(), ME = MemOps.end(); MB != ME; MB++) {
-        for (auto NB = next(MB); NB != ME; NB++) {
-            Data["num-aa-pairs"]++;
-
-            if (isa<LoadInst>(*MB) && isa<LoadInst>(*NB)) {
-                Data["num-ld-ld-pairs"]++;
-                continue;
-            }
+    // Memory operations are bucketed by the object getPtr finds under their
+    // pointer. Distinct identified objects can't alias, so only the pairs
+    // inside a bucket and the pairs with an operation of unknown object are
+    // queried.
+    auto getObject = [](Value *P) -> Value * {
+        if (P && (isa<AllocaInst>(P) || isa<GlobalVariable>(P) ||
+                  isNoAliasCall(P)))
+            return P;
+        return nullptr;
+    };
 
-            switch (
-                AA.alias(MemoryLocation::get(*MB), MemoryLocation::get(*NB))) {
-                case AliasResult::NoAlias:
-                    Data["num-no-alias"]++;
-                    break;
-                case AliasResult::MustAlias:
-                    Data["num-must-alias"]++;
-                    AliasEdges.push_back({getUID(*MB), getUID(*NB)});
-                    NaiveAliasEdges.push_back({getUID(*MB), getUID(*NB)});
-                    MustAliasEdges.push_back({getUID(*MB), getUID(*NB)});
-
-                    AliasEdgesMap[*MB].push_back(*NB);
-                    NaiveAliasEdgesMap[*MB].push_back(*NB);
-                    MustAliasEdgesMap[*MB].push_back(*NB);
-                    break;
-                case AliasResult::PartialAlias:
-                    Data["num-partial-alias"]++;
-                    MayAliasEdges.push_back({getUID(*MB), getUID(*NB)});
-                    AliasEdges.push_back({getUID(*MB), getUID(*NB)});
-                    NaiveAliasEdges.push_back({getUID(*MB), getUID(*NB)});
-
-                    MayAliasEdgesMap[*MB].push_back(*NB);
-                    AliasEdgesMap[*MB].push_back(*NB);
-                    NaiveAliasEdgesMap[*MB].push_back(*NB);
-
-                    break;
-                case AliasResult::MayAlias: {
-                    Data["num-may-alias-naive"]++;
-                    auto *P = getPtrWrapper(*MB);
-                    auto *Q = getPtrWrapper(*NB);
-                    NaiveAliasEdges.push_back({getUID(*MB), getUID(*NB)});
-                    NaiveAliasEdgesMap[*MB].push_back(*NB);
-                    if (P && Q && P != Q) {
-                        if (!isa<AllocaInst>(P) && !isa<GlobalValue>(P)) {
-                            DEBUG(errs() << "checkP: " << *P << "\n");
-                            DEBUG(errs() << "checkQ: " << *Q << "\n");
-                        }
-                        Data["num-ipaa-no-alias"]++;
-                    } else {
-                        Data["num-ipaa-may-alias"]++;
-                        AliasEdges.push_back({getUID(*MB), getUID(*NB)});
-                        MayAliasEdges.push_back({getUID(*MB), getUID(*NB)});
-
-                        AliasEdgesMap[*MB].push_back(*NB);
-                        MayAliasEdgesMap[*MB].push_back(*NB);
+    SmallVector<Value *, 64> Ptrs;
+    SmallVector<Value *, 64> Objects;
+    SmallVector<MemoryLocation, 64> Locs;
+    DenseMap<Value *, SmallVector<uint32_t, 16>> Buckets;
+    SmallVector<uint32_t, 16> Unknown;
+    uint64_t NumLoads = 0;
+    for (uint32_t Idx = 0; Idx < MemOps.size(); Idx++) {
+        auto *I = MemOps[Idx];
+        Ptrs.push_back(getPtrWrapper(I));
+        Objects.push_back(getObject(Ptrs.back()));
+        Locs.push_back(MemoryLocation::get(I));
+        if (Objects.back())
+            Buckets[Objects.back()].push_back(Idx);
+        else
+            Unknown.push_back(Idx);
+        if (isa<LoadInst>(I)) NumLoads++;
+    }
+
+    // Memory operations which access the same pointer with the same size
+    // share their queries
+    DenseMap<pair<MemoryLocation, MemoryLocation>, AliasResult> AliasCache;
+    auto getAlias = [&](uint32_t M, uint32_t N) -> AliasResult {
+        auto Key = make_pair(Locs[M], Locs[N]);
+        auto It = AliasCache.find(Key);
+        if (It != AliasCache.end()) return It->second;
+        auto Result = AA.alias(Key.first, Key.second);
+        AliasCache.insert({Key, Result});
+        return Result;
+    };
+
+    uint64_t NumQueried = 0, NumNoAlias = 0, NumMustAlias = 0,
+             NumPartialAlias = 0, NumMayAliasNaive = 0, NumIPAANoAlias = 0,
+             NumIPAAMayAlias = 0;
+
+    auto checkPair = [&](uint32_t M, uint32_t N) {
+        auto *MB = MemOps[M], *NB = MemOps[N];
+        if (isa<LoadInst>(MB) && isa<LoadInst>(NB)) return;
+        NumQueried++;
+
+        switch (getAlias(M, N)) {
+            case AliasResult::NoAlias:
+                NumNoAlias++;
+                break;
+            case AliasResult::MustAlias:
+                NumMustAlias++;
+                AliasEdges.push_back({getUID(MB), getUID(NB)});
+                NaiveAliasEdges.push_back({getUID(MB), getUID(NB)});
+                MustAliasEdges.push_back({getUID(MB), getUID(NB)});
+
+                AliasEdgesMap[MB].push_back(NB);
+                NaiveAliasEdgesMap[MB].push_back(NB);
+                MustAliasEdgesMap[MB].push_back(NB);
+                break;
+            case AliasResult::PartialAlias:
+                NumPartialAlias++;
+                MayAliasEdges.push_back({getUID(MB), getUID(NB)});
+                AliasEdges.push_back({getUID(MB), getUID(NB)});
+                NaiveAliasEdges.push_back({getUID(MB), getUID(NB)});
+
+                MayAliasEdgesMap[MB].push_back(NB);
+                AliasEdgesMap[MB].push_back(NB);
+                NaiveAliasEdgesMap[MB].push_back(NB);
+
+                break;
+            case AliasResult::MayAlias: {
+                NumMayAliasNaive++;
+                auto *P = Ptrs[M];
+                auto *Q = Ptrs[N];
+                NaiveAliasEdges.push_back({getUID(MB), getUID(NB)});
+                NaiveAliasEdgesMap[MB].push_back(NB);
+                if (P && Q && P != Q) {
+                    if (!isa<AllocaInst>(P) && !isa<GlobalValue>(P)) {
+                        DEBUG(errs() << "checkP: " << *P << "\n");
+                        DEBUG(errs() << "checkQ: " << *Q << "\n");
                     }
-                    break;
+                    NumIPAANoAlias++;
+                } else {
+                    NumIPAAMayAlias++;
+                    AliasEdges.push_back({getUID(MB), getUID(NB)});
+                    MayAliasEdges.push_back({getUID(MB), getUID(NB)});
+
+                    AliasEdgesMap[MB].push_back(NB);
+                    MayAliasEdgesMap[MB].push_back(NB);
                 }
+                break;
             }
         }
+    };
+
+    // The pairs are still visited in the order of the memory operations, so
+    // the edges come out the same way a full pairwise walk gives them
+    for (uint32_t M = 0; M < MemOps.size(); M++) {
+        if (!Objects[M]) {
+            for (uint32_t N = M + 1; N < MemOps.size(); N++) checkPair(M, N);
+            continue;
+        }
+
+        auto &Bucket = Buckets[Objects[M]];
+        auto BI = upper_bound(Bucket.begin(), Bucket.end(), M);
+        auto UI = upper_bound(Unknown.begin(), Unknown.end(), M);
+        while (BI != Bucket.end() || UI != Unknown.end()) {
+            if (UI == Unknown.end() || (BI != Bucket.end() && *BI < *UI))
+                checkPair(M, *BI++);
+            else
+                checkPair(M, *UI++);
+        }
     }
 
+    uint64_t NumMemOps = MemOps.size();
+    uint64_t NumPairs = NumMemOps * (NumMemOps - (NumMemOps > 0)) / 2;
+    uint64_t NumLdLdPairs = NumLoads * (NumLoads - (NumLoads > 0)) / 2;
+
+    Data["num-aa-pairs"] = NumPairs;
+    Data["num-ld-ld-pairs"] = NumLdLdPairs;
+    Data["num-object-no-alias"] = NumPairs - NumLdLdPairs - NumQueried;
+    Data["num-aa-queries"] = AliasCache.size();
+    Data["num-no-alias"] = NumNoAlias;
+    Data["num-must-alias"] = NumMustAlias;
+    Data["num-partial-alias"] = NumPartialAlias;
+    Data["num-may-alias-naive"] = NumMayAliasNaive;
+    Data["num-ipaa-no-alias"] = NumIPAANoAlias;
+    Data["num-ipaa-may-alias"] = NumIPAAMayAlias;
+
     if (print) {
         ofstream MustEdgeFile((OF->getName() + ".must.txt").str(), ios::out);
         for (auto P : MustAliasEdges) {
@@ -206,6 +274,14 @@ void AliasEdgeWriter::writeEdges(CallInst *CI, Function *OF) {
 }
 
 bool AliasEdgeWriter::runOnModule(Module &M) {
+    if (!FunctionNames.empty()) {
+        for (auto &F : M) {
+            if (!F.isDeclaration() && FunctionNames.count(F.getName().str()))
+                writeEdges(nullptr, &F);
+        }
+        return false;
+    }
+
     DenseMap<StringRef, SmallVector<CallInst *, 1>> Map;
 
     for (auto &F : M) {
@@ -253,6 +329,7 @@ bool AliasEdgeWriter::doInitialization(Module &M) {
 }
 
 bool AliasEdgeWriter::doFinalization(Module &M) {
+    if (!dumpStats) return false;
     ofstream Outfile("aew.stats.txt", ios::out);
     for (auto KV : Data) {
         Outfile << KV.first << " " << KV.second << "\n";
@@ -0,0 +1,378 @@
+#!/usr/bin/env python3
+"""
+Generator benchmark over the bundled workloads.
+
+Every kernel under tests/c, tests/c/polybench, tests/c/cilk,
+tests/wokrload/MachSuite and tests/ml is lowered to LLVM IR the same way
+tests/c/Makefile does it and then handed to dandelion. For each kernel the
+wall time, the peak RSS of the dandelion process and the size of the files it
+generates are recorded into a JSON baseline (and a CSV next to it).
+
+With --compare the run is checked against an older baseline and every kernel
+which got slower, bigger or stopped generating beyond the threshold is
+reported, the script exits with 1 in that case.
+"""
+import argparse
+import csv
+import json
+import os
+import re
+import shutil
+import subprocess
+import sys
+import time
+from os import path
+
+CFLAGS = ['-O1', '-g', '-fno-unroll-loops', '-fno-vectorize', '-fno-slp-vectorize',
+          '-emit-llvm', '-S']
+OPT_PASSES = ['-mem2reg', '-loop-simplify', '-loop-simplifycfg', '-simplifycfg',
+              '-disable-loop-vectorization', '-dce']
+
+# MachSuite files which are not part of the kernel
+MACHSUITE_SUPPORT = re.compile(r'^(local_support|generate|harness|support)\.c$|_test\.c$')
+
+FIELDS = ['suite', 'kernel', 'function', 'status', 'wall_s', 'peak_rss_kb',
+          'output_bytes']
+METRICS = ['wall_s', 'peak_rss_kb', 'output_bytes']
+
+
+class Kernel:
+    def __init__(self, suite, name, sources, function, cflags=None, ll=None):
+        self.suite = suite
+        self.name = name
+        self.sources = sources
+        self.function = function
+        self.cflags = cflags or []
+        # Kernels which are already shipped as IR
+        self.ll = ll
+
+    def key(self):
+        return '{}/{}'.format(self.suite, self.name)
+
+
+def stem(file_name):
+    return path.splitext(path.basename(file_name))[0]
+
+
+def find_c_kernels(tests):
+    kernels = []
+    c_dir = path.join(tests, 'c')
+    for src in sorted(os.listdir(c_dir)):
+        if src.endswith('.c'):
+            kernels.append(Kernel('c', stem(src), [path.join(c_dir, src)], stem(src)))
+
+    cilk_dir = path.join(c_dir, 'cilk')
+    for src in sorted(os.listdir(cilk_dir)):
+        if src.endswith('.c'):
+            kernels.append(Kernel('cilk', stem(src), [path.join(cilk_dir, src)],
+                                  stem(src), ['-fcilkplus']))
+    return kernels
+
+
+def find_polybench_kernels(tests):
+    kernels = []
+    root = path.join(tests, 'c', 'polybench')
+    utilities = path.join(root, 'utilities')
+    for dir_path, _, files in sorted(os.walk(root)):
+        if dir_path.startswith(utilities):
+            continue
+        for src in sorted(files):
+            name = stem(src)
+            # Only <kernel>/<kernel>.c, e.g. nussinov/Nussinov.orig.c is skipped
+            if not src.endswith('.c') or name != path.basename(dir_path):
+                continue
+            # Kernels are static, they would be inlined into main otherwise
+            kernels.append(Kernel('polybench', name, [path.join(dir_path, src)],
+                                  'kernel_' + name.replace('-', '_'),
+                                  ['-I' + utilities, '-I' + dir_path, '-fno-inline']))
+    return kernels
+
+
+def find_machsuite_kernels(tests):
+    kernels = []
+    root = path.join(tests, 'wokrload', 'MachSuite')
+    common = path.join(root, 'common')
+    for bench in sorted(os.listdir(root)):
+        if bench in ['common', 'templates'] or not path.isdir(path.join(root, bench)):
+            continue
+        for variant in sorted(os.listdir(path.join(root, bench))):
+            var_dir = path.join(root, bench, variant)
+            support = path.join(var_dir, 'local_support.c')
+            if not path.isfile(support):
+                continue
+
+            # The top function is the one run_benchmark calls
+            with open(support) as support_file:
+                body = re.search(r'run_benchmark\s*\([^)]*\)\s*\{(.*?)\n\}',
+                                 support_file.read(), re.S)
+            calls = re.findall(r'(\w+)\s*\(', body.group(1)) if body else []
+            if not calls:
+                continue
+
+            sources = [path.join(var_dir, src) for src in sorted(os.listdir(var_dir))
+                       if src.endswith('.c') and not MACHSUITE_SUPPORT.search(src)]
+            kernels.append(Kernel('machsuite', '{}-{}'.format(bench, variant), sources,
+                                  calls[0], ['-I' + common, '-I' + var_dir]))
+    return kernels
+
+
+def find_ml_kernels(tests):
+    kernels = []
+    ml_dir = path.join(tests, 'ml')
+    for src in sorted(os.listdir(ml_dir)):
+        if not src.endswith('.ll'):
+            continue
+        ll = path.join(ml_dir, src)
+        with open(ll) as ll_file:
+            function = re.search(r'^define [^@]*@([\w.$]+)\(', ll_file.read(), re.M)
+        if function:
+            kernels.append(Kernel('ml', stem(src), [], function.group(1), ll=ll))
+    return kernels
+
+
+def run(cmd, cwd, log, timeout=None):
+    """
+    Runs the command with its stderr going to the log file, returns its exit code
+    (None on timeout), wall time in seconds and the peak RSS of the process in KB
+    """
+    with open(log, 'w') as err, open(os.devnull, 'w') as devnull:
+        start = time.perf_counter()
+        proc = subprocess.Popen(cmd, cwd=cwd, stdout=devnull, stderr=err)
+
+        # wait4 reports the usage of this child alone, RUSAGE_CHILDREN keeps the
+        # maximum over every child we have waited for
+        while True:
+            pid, status, usage = os.wait4(proc.pid, os.WNOHANG)
+            if pid:
+                break
+            if timeout and time.perf_counter() - start > timeout:
+                proc.kill()
+                os.wait4(proc.pid, 0)
+                proc.returncode = -1
+                return None, time.perf_counter() - start, 0
+            time.sleep(0.005)
+        wall = time.perf_counter() - start
+
+    proc.returncode = os.WEXITSTATUS(status) if os.WIFEXITED(status) else -1
+    rss = usage.ru_maxrss
+    if sys.platform == 'darwin':
+        rss //= 1024
+    return proc.returncode, wall, rss
+
+
+def compile_kernel(kernel, args, work_dir):
+    """
+    Lowers the kernel to LLVM IR, returns the IR file or None
+    """
+    if kernel.ll:
+        return kernel.ll
+
+    clang = path.join(args.llvm_bin, 'clang')
+    opt = path.join(args.llvm_bin, 'opt')
+    ll = path.join(work_dir, kernel.name + '.ll')
+
+    for src in kernel.sources:
+        bc = path.join(work_dir, stem(src) + '.c.ll')
+        clang_cmd = [clang] + CFLAGS + kernel.cflags + [src, '-o', bc]
+        if subprocess.call(clang_cmd, stderr=subprocess.DEVNULL) != 0:
+            continue
+        if subprocess.call([opt, '-S'] + OPT_PASSES + [bc, '-o', ll],
+                           stderr=subprocess.DEVNULL) != 0:
+            continue
+        with open(ll) as ll_file:
+            if re.search(r'^define [^@]*@{}\('.format(re.escape(kernel.function)),
+                         ll_file.read(), re.M):
+                return ll
+    return None
+
+
+def dir_size(dir_path):
+    return sum(path.getsize(path.join(root, f))
+               for root, _, files in os.walk(dir_path) for f in files)
+
+
+def bench_kernel(kernel, args):
+    result = {'suite': kernel.suite, 'kernel': kernel.name, 'function': kernel.function,
+              'status': 'ok', 'wall_s': 0.0, 'peak_rss_kb': 0, 'output_bytes': 0}
+
+    work_dir = path.join(args.work_dir, kernel.suite, kernel.name)
+    shutil.rmtree(work_dir, ignore_errors=True)
+    os.makedirs(work_dir)
+
+    ll = compile_kernel(kernel, args, work_dir)
+    if not ll:
+        result['status'] = 'compile-error'
+        return result
+
+    stats = path.join(work_dir, kernel.name + '.stats.json')
+    for i in range(args.repeat):
+        # Every run starts from an empty output directory
+        out_dir = path.join(work_dir, 'out')
+        shutil.rmtree(out_dir, ignore_errors=True)
+        os.makedirs(out_dir)
+
+        cmd = [args.dandelion, '-fn-name=' + kernel.function, '-config=' + args.config,
+               '-stats-json=' + stats, ll, '-o', kernel.name] + args.dandelion_args
+        code, wall, rss = run(cmd, out_dir, path.join(work_dir, 'dandelion.log'),
+                              args.timeout)
+        if code is None:
+            result['status'] = 'timeout'
+            return result
+        if code != 0:
+            result['status'] = 'error'
+            return result
+
+        # Best of the runs, the slower ones only add the noise of the machine
+        if i == 0 or wall < result['wall_s']:
+            result['wall_s'] = wall
+        result['peak_rss_kb'] = max(result['peak_rss_kb'], rss)
+
+    result['output_bytes'] = dir_size(out_dir)
+    if path.isfile(stats):
+        with open(stats) as stats_file:
+            result['stats'] = json.load(stats_file)
+    return result
+
+
+def write_results(results, output):
+    os.makedirs(path.dirname(path.abspath(output)), exist_ok=True)
+    with open(output, 'w') as json_file:
+        json.dump({'kernels': results}, json_file, indent=2)
+
+    with open(path.splitext(output)[0] + '.csv', 'w', newline='') as csv_file:
+        writer = csv.DictWriter(csv_file, fieldnames=FIELDS, extrasaction='ignore')
+        writer.writeheader()
+        writer.writerows(results)
+
+
+def load_results(baseline):
+    with open(baseline) as baseline_file:
+        if baseline.endswith('.csv'):
+            results = list(csv.DictReader(baseline_file))
+        else:
+            results = json.load(baseline_file)['kernels']
+    return {'{}/{}'.format(r['suite'], r['kernel']): r for r in results}
+
+
+def compare(results, baseline, args):
+    """
+    Prints the kernels which regressed against the baseline, returns their number
+    """
+    old = load_results(baseline)
+    regressions = 0
+
+    for result in results:
+        key = '{}/{}'.format(result['suite'], result['kernel'])
+        if key not in old:
+            print('  new      {}'.format(key))
+            continue
+
+        before = old[key]
+        if before['status'] != result['status']:
+            if result['status'] != 'ok':
+                regressions += 1
+            print('  {:8} {} ({} -> {})'.format(
+                'FAIL' if result['status'] != 'ok' else 'fixed', key, before['status'],
+                result['status']))
+            continue
+        if result['status'] != 'ok':
+            continue
+
+        for metric in METRICS:
+            was, now = float(before[metric]), float(result[metric])
+            # Very short runs are only noise
+            if metric == 'wall_s' and max(was, now) < args.min_time:
+                continue
+            if was == 0:
+                continue
+
+            change = (now - was) / was
+            if change > args.threshold:
+                regressions += 1
+                print('  SLOWER   {} {}: {:.4g} -> {:.4g} (+{:.1f}%)'.format(
+                    key, metric, was, now, change * 100))
+            elif change < -args.threshold:
+                print('  faster   {} {}: {:.4g} -> {:.4g} ({:.1f}%)'.format(
+                    key, metric, was, now, change * 100))
+
+    # Kernels of the baseline which were not part of this run at all
+    keys = set('{}/{}'.format(r['suite'], r['kernel']) for r in results)
+    for key in sorted(set(old) - keys):
+        if selected(old[key]['suite'], key, args):
+            print('  missing  {}'.format(key))
+    return regressions
+
+
+def selected(suite, key, args):
+    return (not args.suite or suite in args.suite) and re.search(args.filter, key)
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(
+        description='Measure the dandelion generator over the bundled workloads')
+
+    parser.add_argument('--dandelion', required=True, help='dandelion binary')
+    parser.add_argument('--llvm-bin', required=True, help='directory of clang and opt')
+    parser.add_argument('--config', required=True, help='dandelion config file')
+    parser.add_argument('--tests', required=True, help='tests directory of the repo')
+    parser.add_argument('--work-dir', required=True,
+                        help='directory of the generated IR and outputs')
+    parser.add_argument('-o', '--output', required=True,
+                        help='result JSON file, a CSV is written next to it')
+    parser.add_argument('--suite', action='append',
+                        choices=['c', 'cilk', 'polybench', 'machsuite', 'ml'],
+                        help='only run these suites (default: all)')
+    parser.add_argument('--filter', default='', help='regex on <suite>/<kernel>')
+    parser.add_argument('--repeat', type=int, default=1,
+                        help='runs per kernel, the fastest one is kept')
+    parser.add_argument('--timeout', type=float, default=600,
+                        help='seconds before a kernel is given up')
+    parser.add_argument('--compare', default='', help='baseline JSON or CSV file')
+    parser.add_argument('--threshold', type=float, default=0.10,
+                        help='allowed relative growth of a metric (default: 0.10)')
+    parser.add_argument('--min-time', type=float, default=0.05,
+                        help='wall times below this many seconds are not compared')
+    parser.add_argument('dandelion_args', nargs='*',
+                        help='extra dandelion options, after --')
+
+    args = parser.parse_args(argv)
+
+    for tool in [args.dandelion, path.join(args.llvm_bin, 'clang'),
+                 path.join(args.llvm_bin, 'opt')]:
+        if not os.access(tool, os.X_OK):
+            print('{} is not an executable!'.format(tool))
+            return 2
+
+    kernels = []
+    kernels += find_c_kernels(args.tests)
+    kernels += find_polybench_kernels(args.tests)
+    kernels += find_machsuite_kernels(args.tests)
+    kernels += find_ml_kernels(args.tests)
+
+    kernels = [k for k in kernels if selected(k.suite, k.key(), args)]
+
+    results = []
+    for kernel in kernels:
+        result = bench_kernel(kernel, args)
+        results.append(result)
+        print('{:40} {:14} {:8.3f}s {:9}KB {:10}B'.format(
+            kernel.key(), result['status'], result['wall_s'], result['peak_rss_kb'],
+            result['output_bytes']))
+        sys.stdout.flush()
+
+    write_results(results, args.output)
+    print('Results are written to: {}'.format(args.output))
+
+    if args.compare:
+        print('Comparing against: {} (threshold {:.0f}%)'.format(
+            args.compare, args.threshold * 100))
+        regressions = compare(results, args.compare, args)
+        if regressions:
+            print('{} regression(s)'.format(regressions))
+            return 1
+        print('No regressions')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
@@ -0,0 +1,159 @@
+#!/usr/bin/env python3
+"""
+Generator scaling benchmark.
+
+Sweeps the size of a synthetic kernel made by synth-kernel, runs dandelion on
+each one and records the wall time and peak RSS against the size of the graph
+dandelion built (nodes and edges from -stats-json). The results are written as
+a CSV, and when matplotlib is around they are plotted as well. A straight line
+on the log-log plot with a slope above one is the super linear behaviour this
+is meant to catch.
+"""
+import argparse
+import csv
+import importlib.util
+import json
+import os
+import shutil
+import sys
+from os import path
+
+# run() is shared with the workload benchmark
+spec = importlib.util.spec_from_file_location(
+    'bench_generator', path.join(path.dirname(path.abspath(__file__)), 'bench-generator.py'))
+bench_generator = importlib.util.module_from_spec(spec)
+spec.loader.exec_module(bench_generator)
+
+FIELDS = ['instructions', 'loop_depth', 'fanout', 'mem_ops', 'callees', 'status',
+          'graph_nodes', 'graph_edges', 'wall_s', 'peak_rss_kb']
+
+
+def graph_size(stats_file):
+    """
+    Sums the node and edge counts of every graph in a -stats-json file
+    """
+    with open(stats_file) as stats:
+        graphs = json.load(stats).get('graphs', [])
+    # "instructions" only breaks the instruction nodes down by their type
+    nodes = sum(sum(g.get('nodes', {}).values()) for g in graphs)
+    edges = sum(sum(g.get('edges', {}).values()) for g in graphs)
+    return nodes, edges
+
+
+def bench_size(size, args):
+    mem_ops = max(1, size * args.mem_ratio // 100)
+    result = {'instructions': size, 'loop_depth': args.loop_depth, 'fanout': args.fanout,
+              'mem_ops': mem_ops, 'callees': args.callees, 'status': 'ok',
+              'graph_nodes': 0, 'graph_edges': 0, 'wall_s': 0.0, 'peak_rss_kb': 0}
+
+    work_dir = path.join(args.work_dir, 'synth{}'.format(size))
+    shutil.rmtree(work_dir, ignore_errors=True)
+    os.makedirs(work_dir)
+
+    kernel = path.join(work_dir, 'synth.bc')
+    code, _, _ = bench_generator.run(
+        [args.synth_kernel, '-fn-name=synth', '-instructions={}'.format(size),
+         '-loop-depth={}'.format(args.loop_depth), '-fanout={}'.format(args.fanout),
+         '-mem-ops={}'.format(mem_ops), '-callees={}'.format(args.callees),
+         '-o', kernel], work_dir, path.join(work_dir, 'synth-kernel.log'))
+    if code != 0:
+        result['status'] = 'synth-error'
+        return result
+
+    stats = path.join(work_dir, 'synth.stats.json')
+    code, wall, rss = bench_generator.run(
+        [args.dandelion, '-fn-name=synth', '-config=' + args.config,
+         '-stats-json=' + stats, kernel, '-o', 'synth'] + args.dandelion_args,
+        work_dir, path.join(work_dir, 'dandelion.log'), args.timeout)
+    if code is None:
+        result['status'] = 'timeout'
+        return result
+    if code != 0:
+        result['status'] = 'error'
+        return result
+
+    result['wall_s'] = wall
+    result['peak_rss_kb'] = rss
+    if path.isfile(stats):
+        result['graph_nodes'], result['graph_edges'] = graph_size(stats)
+    return result
+
+
+def plot(results, output):
+    try:
+        import matplotlib
+        matplotlib.use('Agg')
+        import matplotlib.pyplot as plt
+    except ImportError:
+        print('matplotlib is not installed, skipping the plot')
+        return
+
+    done = [r for r in results if r['status'] == 'ok' and r['graph_nodes']]
+    if not done:
+        return
+
+    nodes = [r['graph_nodes'] for r in done]
+    fig, (time_ax, mem_ax) = plt.subplots(1, 2, figsize=(12, 5))
+    time_ax.loglog(nodes, [r['wall_s'] for r in done], 'o-')
+    time_ax.set_xlabel('graph nodes')
+    time_ax.set_ylabel('generation time (s)')
+    mem_ax.loglog(nodes, [r['peak_rss_kb'] / 1024 for r in done], 'o-')
+    mem_ax.set_xlabel('graph nodes')
+    mem_ax.set_ylabel('peak RSS (MB)')
+    for ax in [time_ax, mem_ax]:
+        ax.grid(True, which='both', linestyle=':')
+    fig.tight_layout()
+    fig.savefig(output)
+    print('Plot is written to: {}'.format(output))
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(
+        description='Measure how the dandelion generator scales with the kernel size')
+
+    parser.add_argument('--dandelion', required=True, help='dandelion binary')
+    parser.add_argument('--synth-kernel', required=True, help='synth-kernel binary')
+    parser.add_argument('--config', required=True, help='dandelion config file')
+    parser.add_argument('--work-dir', required=True,
+                        help='directory of the generated kernels and outputs')
+    parser.add_argument('-o', '--output', required=True,
+                        help='result CSV file, the plot is written next to it')
+    parser.add_argument('--sizes', default='64,256,1024,4096,16384',
+                        help='instructions of the swept kernels, comma separated')
+    parser.add_argument('--loop-depth', type=int, default=2)
+    parser.add_argument('--fanout', type=int, default=2)
+    parser.add_argument('--mem-ratio', type=int, default=10,
+                        help='memory operations per hundred instructions')
+    parser.add_argument('--callees', type=int, default=0)
+    parser.add_argument('--timeout', type=float, default=1800,
+                        help='seconds before a size is given up')
+    parser.add_argument('dandelion_args', nargs='*',
+                        help='extra dandelion options, after --')
+
+    args = parser.parse_args(argv)
+
+    results = []
+    for size in [int(s) for s in args.sizes.split(',')]:
+        result = bench_size(size, args)
+        results.append(result)
+        print('{:8} instructions {:12} {:8} nodes {:8} edges {:9.3f}s {:9}KB'.format(
+            size, result['status'], result['graph_nodes'], result['graph_edges'],
+            result['wall_s'], result['peak_rss_kb']))
+        sys.stdout.flush()
+        # Bigger kernels won't do any better
+        if result['status'] == 'timeout':
+            break
+
+    os.makedirs(path.dirname(path.abspath(args.output)), exist_ok=True)
+    with open(args.output, 'w', newline='') as csv_file:
+        writer = csv.DictWriter(csv_file, fieldnames=FIELDS)
+        writer.writeheader()
+        writer.writerows(results)
+    print('Results are written to: {}'.format(args.output))
+
+    plot(results, path.splitext(args.output)[0] + '.png')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
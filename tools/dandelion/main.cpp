@@ -10,6 +10,7 @@
 #include "llvm/Analysis/TargetLibraryInfo.h"
 #include "llvm/Analysis/TypeBasedAliasAnalysis.h"
 #include "llvm/AsmParser/Parser.h"
+#include "llvm/Bitcode/BitcodeReader.h"
 #include "llvm/Bitcode/BitcodeWriter.h"
 #include "llvm/CodeGen/CommandFlags.def"
 #include "llvm/CodeGen/LinkAllAsmWriterComponents.h"
@@ -28,7 +29,9 @@
 #include "llvm/Support/FileUtilities.h"
 #include "llvm/Support/FormattedStream.h"
 #include "llvm/Support/Host.h"
+#include "llvm/Support/MD5.h"
 #include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/PrettyStackTrace.h"
 #include "llvm/Support/Program.h"
@@ -36,18 +39,25 @@
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/TargetRegistry.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Target/TargetMachine.h"
 #include "llvm/Transforms/Scalar.h"
 
 #include <experimental/iterator>
+#include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <iostream>
 
 #include "AliasEdgeWriter.h"
 #include "Common.h"
+#include "Dandelion/Graph.h"
+#include "Dandelion/MuIRBinary.h"
+#include "Dandelion/PassManager.h"
+#include "Dandelion/Stats.h"
 #include "GEPSplitter.h"
 #include "GraphGeneratorPass.h"
 //#include "LoopClouser.h"
@@ -79,7 +89,7 @@ getInstList(Function* func) {
 static cl::OptionCategory dandelionCategory{"dandelion options"};
 
 cl::opt<string> inPath(cl::Positional,
-                       cl::desc("<Module to analyze>"),
+                       cl::desc("<Module or binary muIR file to analyze>"),
                        cl::value_desc("bitcode filename"),
                        cl::init(""),
                        cl::Required,
@@ -122,12 +132,64 @@ cl::opt<bool> dump_muir("dump-muir",
                         cl::init(false),
                         cl::cat{dandelionCategory});
 
+cl::opt<bool> muir_binary("muir-binary",
+                          cl::desc("Dumping muIR in the binary format"),
+                          cl::value_desc("T/F {default = false}"),
+                          cl::init(false),
+                          cl::cat{dandelionCategory});
+
 cl::opt<bool> verbose("verbose",
                       cl::desc("Verbose execution"),
                       cl::value_desc("T/F {default = false}"),
                       cl::init(false),
                       cl::cat{dandelionCategory});
 
+cl::opt<unsigned> numThreads("j",
+                             cl::desc("Number of kernels generated in parallel"),
+                             cl::value_desc("N {default = 1}"),
+                             cl::init(1),
+                             cl::cat{dandelionCategory});
+
+cl::opt<string> cacheDir("cache-dir",
+                         cl::desc("Directory of the generated kernels cache"),
+                         cl::value_desc("directory"),
+                         cl::init(""),
+                         cl::cat{dandelionCategory});
+
+cl::opt<string> statsJson("stats-json",
+                          cl::desc("Dumping per stage time, memory and graph sizes"),
+                          cl::value_desc("filename"),
+                          cl::init(""),
+                          cl::cat{dandelionCategory});
+
+cl::opt<bool> aliasEdges("alias-edges",
+                         cl::desc("Order only the memory operations alias analysis "
+                                  "can't separate"),
+                         cl::value_desc("T/F {default = true}"),
+                         cl::init(true),
+                         cl::cat{dandelionCategory});
+
+cl::opt<bool> memoryBanks("mem-banks",
+                          cl::desc("Give each memory object no other pointer can "
+                                   "reach a memory unit of its own"),
+                          cl::value_desc("T/F {default = true}"),
+                          cl::init(true),
+                          cl::cat{dandelionCategory});
+
+cl::opt<bool> packedMemory("packed-mem",
+                           cl::desc("Lay the memory out with the real data sizes "
+                                    "instead of a 64bit word per element"),
+                           cl::value_desc("T/F {default = true}"),
+                           cl::init(true),
+                           cl::cat{dandelionCategory});
+
+cl::opt<bool> narrowWidths("narrow-widths",
+                           cl::desc("Narrow the integer nodes to the widths their "
+                                    "values can take"),
+                           cl::value_desc("T/F {default = true}"),
+                           cl::init(true),
+                           cl::cat{dandelionCategory});
+
 cl::opt<string> outFile("o",
                         cl::desc("tapas output file"),
                         cl::value_desc("filename"),
@@ -141,6 +203,21 @@ cl::opt<char> HWoptLevel("H",
                          cl::ZeroOrMore,
                          cl::init('1'));
 
+cl::list<string> graphPasses("graph-passes",
+                             cl::desc("Graph passes to run in place of the -H "
+                                      "pipeline, comma separated (ground-stores "
+                                      "always runs)"),
+                             cl::value_desc("pass names"),
+                             cl::CommaSeparated,
+                             cl::cat{dandelionCategory});
+
+cl::opt<unsigned> fuseDelay("fuse-delay",
+                            cl::desc("Delay budget in gate levels of the operation "
+                                     "chains fuse-compute merges"),
+                            cl::value_desc("levels {default = 12}"),
+                            cl::init(12),
+                            cl::cat{dandelionCategory});
+
 static cl::opt<char> optLevel("O",
                               cl::desc("Optimization level. [-O0, -O1, -O2, or -O3] "
                                        "(default = '-O2')"),
@@ -411,8 +488,18 @@ runRootGraph(llvm::Function& function, SetVector<Function*> call_inst, string fi
     exit(-1);
   }
 
-  std::error_code errc;
-  raw_fd_ostream out(file_name + "_root.scala", errc, sys::fs::F_None);
+  // Each kernel has its shared memory port and one port for each of its memory
+  // banks, the partition is the same one the graph generator used
+  std::map<Function*, uint32_t> mem_banks;
+  uint32_t num_mem_ports = 0;
+  for (auto func : call_inst) {
+    if (memoryBanks.getValue())
+      mem_banks[func] = helpers::MemoryBanking::partition(*func).banks.size();
+    num_mem_ports += 1 + mem_banks[func];
+  }
+
+  string root_text;
+  raw_string_ostream out(root_text);
 
   string ptrs, vals, rets;
   print_port(&function, ptrs, vals, rets);
@@ -427,10 +514,10 @@ runRootGraph(llvm::Function& function, SetVector<Function*> call_inst, string fi
       << "), Returns: Seq[Int] = List(" << rets << "))\n"
       << "                  (implicit p: Parameters) extends "
          "DandelionAccelDCRModule(PtrsIn, ValsIn, Returns) {\n\n"
-         "  val NumKernels = "
-      << call_inst.size()
+         "  val NumMemPorts = "
+      << num_mem_ports
       << "\n"
-         "  val memory_arbiter = Module(new MemArbiter(NumKernels))\n\n  "
+         "  val memory_arbiter = Module(new MemArbiter(NumMemPorts))\n\n  "
          "/**\n    * Local memories\n    */\n";
 
   for (auto func : call_inst) {
@@ -509,33 +596,54 @@ runRootGraph(llvm::Function& function, SetVector<Function*> call_inst, string fi
     out << "\n";
   }
 
+  // Memory banks of each kernel get their own arbiter port after its shared
+  // memory port, the bank names follow Graph::createMemoryBank
   uint32_t ind = 0;
   for (auto func : call_inst) {
     out << "  memory_arbiter.io.cpu.MemReq(" << ind << ") <> " << func->getName()
         << ".io.MemReq\n  " << func->getName()
-        << ".io.MemResp <> memory_arbiter.io.cpu.MemResp(" << ind << ")\n\n";
+        << ".io.MemResp <> memory_arbiter.io.cpu.MemResp(" << ind << ")\n";
     ind++;
+
+    for (uint32_t bank = 1; bank <= mem_banks[func]; bank++) {
+      out << "  memory_arbiter.io.cpu.MemReq(" << ind << ") <> " << func->getName()
+          << ".mem_bank_" << bank << "_mem_req\n  " << func->getName() << ".mem_bank_"
+          << bank << "_mem_resp <> memory_arbiter.io.cpu.MemResp(" << ind << ")\n";
+      ind++;
+    }
+    out << "\n";
   }
   out << "  io.MemReq <> memory_arbiter.io.cache.MemReq\n"
          "  memory_arbiter.io.cache.MemResp <> io.MemResp\n\n"
          "}"
          "\n";
-  out.close();
+  writeIfChanged(file_name + "_root.scala", out.str());
 }
 
 /**
- * Function lists
+ * Generating the graphs of all the functions in the call list, the module
+ * is traversed only once and the analysis are shared between the functions
  */
 static void
-runGraphGen(Module& M, string file_name) {
-  // Check wether xketch outpufile name has been specified
-  if (file_name.empty()) {
-    errs() << "o command line option must be specified.\n";
-    exit(-1);
-  }
+runGraphGen(Module& M, SetVector<Function*>& call_inst) {
+  std::set<string> function_names;
+  // Scala outputs are kept in memory and only written if they have changed
+  std::map<string, string> out_texts;
+  std::vector<std::unique_ptr<raw_string_ostream>> out_streams;
+  std::map<string, raw_ostream*> targets;
+  for (auto ff : call_inst) {
+    string file_name = ff->getName().str();
+
+    // Check wether xketch outpufile name has been specified
+    if (file_name.empty()) {
+      errs() << "o command line option must be specified.\n";
+      exit(-1);
+    }
 
-  std::error_code errc;
-  raw_fd_ostream out(file_name + ".scala", errc, sys::fs::F_None);
+    out_streams.push_back(std::make_unique<raw_string_ostream>(out_texts[file_name]));
+    function_names.insert(file_name);
+    targets[file_name] = out_streams.back().get();
+  }
 
   legacy::PassManager pm;
   // Usefull passes
@@ -550,23 +658,182 @@ runGraphGen(Module& M, string file_name) {
   pm.add(new LoopInfoWrapperPass());
   pm.add(new DominatorTreeWrapperPass());
   // pm.add(new loopclouser::LoopClouser());
-  // pm.add(createBasicAAWrapperPass());
-  // pm.add(llvm::createTypeBasedAAWrapperPass());
-  // pm.add(createGlobalsAAWrapperPass());
-  // pm.add(createSCEVAAWrapperPass());
-  // pm.add(createScopedNoAliasAAWrapperPass());
-  // pm.add(createCFLAndersAAWrapperPass());
-  // pm.add(createAAResultsWrapperPass());
-  // pm.add(new aew::AliasEdgeWriter());
-
-  pm.add(new debuginfo::DebugInfo(file_name, false));
+
+  pm.add(new debuginfo::DebugInfo(function_names, false));
   pm.add((llvm::createStripDeadDebugInfoPass()));
-  pm.add(new helpers::GepInformation(file_name));
-  pm.add(new graphgen::GraphGeneratorPass(NodeInfo(0, file_name), out, dump_muir.getValue()));
+  pm.add(new helpers::GepInformation(function_names));
+  if (memoryBanks.getValue())
+    pm.add(new helpers::MemoryBanking(function_names));
+  // helpers::MemoryStreams isn't scheduled until muIR-lib has the
+  // UnTypStreamLoad and UnTypStreamStore modules the stream nodes print as,
+  // without it every load and store is a cache access
+  // The alias edges have to be the last analysis before the graph, any pass
+  // in between could invalidate them
+  if (aliasEdges.getValue()) {
+    pm.add(llvm::createTypeBasedAAWrapperPass());
+    pm.add(createScopedNoAliasAAWrapperPass());
+    pm.add(createCFLAndersAAWrapperPass());
+    pm.add(new aew::AliasEdgeWriter(function_names));
+  }
+  pm.add(new graphgen::GraphGeneratorPass(
+      targets, dump_muir.getValue(), muir_binary.getValue()));
   pm.add(createVerifierPass());
   pm.run(M);
 
-  out.close();
+  for (auto& out : out_streams)
+    out->flush();
+  for (auto& out : out_texts)
+    writeIfChanged(out.first + ".scala", out.second);
+}
+
+/**
+ * Generating the graphs of the call list on a thread pool, every kernel is
+ * generated from its own copy of the module in a private LLVMContext so the
+ * output doesn't depend on the number of threads
+ */
+static void
+runParallelGraphGen(Module& M, SetVector<Function*>& call_inst, unsigned num_threads) {
+  // Snapshot of the module which every worker parses in its own context
+  SmallVector<char, 0> bitcode;
+  raw_svector_ostream bitcode_out(bitcode);
+  WriteBitcodeToFile(&M, bitcode_out);
+  StringRef bitcode_ref(bitcode.data(), bitcode.size());
+
+  ThreadPool pool(std::min<unsigned>(num_threads, call_inst.size()));
+  for (auto ff : call_inst) {
+    string function_name = ff->getName().str();
+    pool.async([bitcode_ref, function_name]() {
+      LLVMContext context;
+      auto module = parseBitcodeFile(MemoryBufferRef(bitcode_ref, function_name), context);
+      if (!module) {
+        report_fatal_error("Unable to read the module of " + function_name + ": "
+                           + toString(module.takeError()));
+      }
+
+      SetVector<Function*> kernel;
+      kernel.insert((*module)->getFunction(function_name));
+      runGraphGen(**module, kernel);
+    });
+  }
+  pool.wait();
+
+  // Keep the final module the same as the serial generation
+  legacy::PassManager pm;
+  pm.add((llvm::createStripDeadDebugInfoPass()));
+  pm.run(M);
+}
+
+//===----------------------------------------------------------------------===//
+//                        Generated kernels cache
+//===----------------------------------------------------------------------===//
+
+// Bump the version whenever the generated code changes for the same input
+static const char* CacheVersion = "dandelion-cache-16";
+
+/**
+ * Returns the output files of a kernel
+ */
+static std::vector<string>
+getKernelFiles(Function& F) {
+  std::vector<string> files{F.getName().str() + ".scala"};
+  if (dump_muir.getValue())
+    files.push_back(F.getName().str()
+                    + (muir_binary.getValue() ? ".muir.bin" : ".muir.json"));
+  return files;
+}
+
+/**
+ * The cache key of a kernel is the hash of its IR after the
+ * pre-optimizations, the config file and the generator options
+ */
+static string
+getKernelHash(Function& F, StringRef config) {
+  string ir;
+  raw_string_ostream ir_out(ir);
+  ir_out << CacheVersion << "\n"
+         << F.getParent()->getDataLayoutStr() << "\n"
+         << "H" << HWoptLevel.getValue() << " muir=" << dump_muir.getValue()
+         << " muir-binary=" << muir_binary.getValue()
+         << " alias-edges=" << aliasEdges.getValue()
+         << " mem-banks=" << memoryBanks.getValue()
+         << " packed-mem=" << packedMemory.getValue()
+         << " narrow-widths=" << narrowWidths.getValue()
+         << " fuse-delay=" << fuseDelay.getValue() << " graph-passes=";
+  for (auto& pass : graphPasses)
+    ir_out << pass << ",";
+  ir_out << "\n";
+
+  // Global values the kernel is using
+  std::set<GlobalVariable*> globals;
+  for (auto& ins : llvm::instructions(F)) {
+    for (auto& op : ins.operands()) {
+      if (auto global = dyn_cast<GlobalVariable>(op->stripPointerCasts()))
+        globals.insert(global);
+    }
+  }
+  for (auto global : globals)
+    global->print(ir_out);
+
+  F.print(ir_out);
+
+  // UIDs are printed as metadata references, adding their values
+  for (auto& ins : llvm::instructions(F)) {
+    if (auto uid = ins.getMetadata("UID"))
+      ir_out << cast<MDString>(uid->getOperand(0))->getString() << " ";
+  }
+  ir_out << "\n" << config;
+
+  MD5 hash;
+  hash.update(ir_out.str());
+  MD5::MD5Result result;
+  hash.final(result);
+
+  SmallString<32> key;
+  MD5::stringifyResult(result, key);
+  return key.str().str();
+}
+
+/**
+ * Restoring the outputs of a kernel from the cache, unchanged files are not
+ * rewritten. Returns false if the kernel is not in the cache.
+ */
+static bool
+restoreKernel(Function& F, const string& key) {
+  std::vector<std::unique_ptr<MemoryBuffer>> cached;
+  for (auto& file : getKernelFiles(F)) {
+    SmallString<128> path(cacheDir.getValue());
+    sys::path::append(path, key, file);
+    auto buffer = MemoryBuffer::getFile(path);
+    if (!buffer)
+      return false;
+    cached.push_back(std::move(*buffer));
+  }
+
+  auto files = getKernelFiles(F);
+  for (uint32_t i = 0; i < files.size(); i++)
+    writeIfChanged(files[i], cached[i]->getBuffer());
+  return true;
+}
+
+/**
+ * Storing the outputs of a generated kernel into the cache
+ */
+static void
+storeKernel(Function& F, const string& key) {
+  SmallString<128> dir(cacheDir.getValue());
+  sys::path::append(dir, key);
+  if (auto errc = sys::fs::create_directories(dir)) {
+    errs() << "Unable to create cache directory " << dir << ": " << errc.message()
+           << "\n";
+    return;
+  }
+
+  for (auto& file : getKernelFiles(F)) {
+    SmallString<128> path(dir);
+    sys::path::append(path, file);
+    if (auto errc = sys::fs::copy_file(file, path))
+      errs() << "Unable to cache " << file << ": " << errc.message() << "\n";
+  }
 }
 
 void
@@ -601,6 +868,45 @@ labelFunctions(Module& M) {
   }
 }
 
+/**
+ * Writing the generator statistics if they are enabled
+ */
+static void
+writeStats() {
+  if (statsJson.getValue().empty())
+    return;
+  if (!dandelion::stats::writeJSON(statsJson.getValue()))
+    errs() << "Unable to write the statistics file: " << statsJson << "\n";
+}
+
+/**
+ * Loading a graph back from a binary muIR file, the graph passes run again
+ * and the muIR is re-emitted without any LLVM module
+ */
+static int
+runMUIRFile(const string& file_name) {
+  auto muir_file = dandelion::muir::MuIRFile::open(file_name);
+  if (!muir_file) {
+    errs() << "Error reading muIR file: " << file_name << ": "
+           << muir_file.getError().message() << "\n";
+    return -1;
+  }
+
+  auto graph = std::make_unique<dandelion::Graph>(
+      dandelion::NodeInfo(0, (*muir_file)->getName().str()));
+  graph->loadMUIRBinary(**muir_file);
+  graph->optimizationPasses();
+
+  if (muir_binary.getValue())
+    graph->printMUIRBinary();
+  else
+    graph->printMUIR();
+  graph->collectStats();
+
+  writeStats();
+  return 0;
+}
+
 
 /**
  * Function lists
@@ -630,6 +936,21 @@ main(int argc, char** argv) {
   cl::HideUnrelatedOptions(dandelionCategory);
   cl::ParseCommandLineOptions(argc, argv);
 
+  if (!statsJson.getValue().empty())
+    dandelion::stats::enable();
+
+  for (auto& pass : graphPasses) {
+    if (!dandelion::passes::isRegisteredPass(pass)) {
+      errs() << "Unknown graph pass: " << pass << "\nThe graph passes are:\n";
+      dandelion::passes::printRegisteredPasses(errs());
+      return -1;
+    }
+  }
+
+  // Binary muIR files are loaded straight into a graph
+  if (StringRef(inPath.getValue()).endswith(".muir.bin"))
+    return runMUIRFile(inPath.getValue());
+
   // Construct an IR file from the filename passed on the command line.
   SMDiagnostic err;
   LLVMContext context;
@@ -661,8 +982,33 @@ main(int argc, char** argv) {
 
       // Insert root function
       call_inst.insert(&F);
-      for (auto ff : call_inst) {
-        runGraphGen(*module, ff->getName());
+
+      // Only the kernels which are not in the cache are generated
+      SetVector<Function*> kernels;
+      std::map<Function*, string> kernel_keys;
+      if (cacheDir.getValue().empty())
+        kernels = call_inst;
+      else {
+        string config;
+        if (auto config_buffer = MemoryBuffer::getFile(config_path.getValue()))
+          config = (*config_buffer)->getBuffer().str();
+
+        for (auto ff : call_inst) {
+          kernel_keys[ff] = getKernelHash(*ff, config);
+          if (!restoreKernel(*ff, kernel_keys[ff]))
+            kernels.insert(ff);
+        }
+      }
+
+      // Every kernel may have been restored from the cache
+      if (numThreads.getValue() > 1 && kernels.size() > 1)
+        runParallelGraphGen(*module, kernels, numThreads.getValue());
+      else if (!kernels.empty())
+        runGraphGen(*module, kernels);
+
+      if (!cacheDir.getValue().empty()) {
+        for (auto ff : kernels)
+          storeKernel(*ff, kernel_keys[ff]);
       }
 
       // Create root scala file
@@ -671,6 +1017,7 @@ main(int argc, char** argv) {
   }
 
   saveModule(*module, target_fn + ".final.bc");
+  writeStats();
 
   if (verbose.getValue()) {
     std::cout
@@ -0,0 +1,332 @@
+#define DEBUG_TYPE "synth-kernel"
+
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/IR/BasicBlock.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IR/Verifier.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/PrettyStackTrace.h"
+#include "llvm/Support/Signals.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace llvm;
+using std::string;
+using std::vector;
+
+/**
+ * Synthetic kernel generator
+ *
+ * Emits a single LLVM IR function with a chosen shape so the generator can be
+ * measured on kernels much larger than the bundled ones. The function is a nest
+ * of loop-depth counted loops, already in the loop-simplify and mem2reg form
+ * the dandelion pipeline expects. The innermost body is a chain of integer
+ * operations:
+ *
+ *  - each value of the chain is folded from the fanout values before it, so
+ *    every value is used by the fanout values after it, the fold takes
+ *    fanout - 1 operations and its partial values have a single user
+ *  - mem-ops loads and stores are spread evenly over the chain, loads read
+ *    %in and stores write %out at the induction variables
+ *  - callees calls to small separate functions are spread the same way
+ *  - the innermost loop carries an accumulator across its iterations
+ *
+ * The same options always give the same function.
+ */
+
+static cl::OptionCategory synthCategory{"synth-kernel options"};
+
+cl::opt<string> outFile("o",
+                        cl::desc("Output file, .bc is written as bitcode"),
+                        cl::value_desc("filename"),
+                        cl::init("synth.ll"),
+                        cl::cat{synthCategory});
+
+cl::opt<string> fn_name("fn-name",
+                        cl::desc("Name of the generated function"),
+                        cl::value_desc("Function name"),
+                        cl::init("synth"),
+                        cl::cat{synthCategory});
+
+cl::opt<unsigned> numInstructions("instructions",
+                                  cl::desc("Arithmetic instructions in the innermost body"),
+                                  cl::value_desc("N {default = 64}"),
+                                  cl::init(64),
+                                  cl::cat{synthCategory});
+
+cl::opt<unsigned> loopDepth("loop-depth",
+                            cl::desc("Depth of the loop nest"),
+                            cl::value_desc("N {default = 1}"),
+                            cl::init(1),
+                            cl::cat{synthCategory});
+
+cl::opt<unsigned> fanout("fanout",
+                         cl::desc("Chain values using each value of the chain"),
+                         cl::value_desc("N {default = 2}"),
+                         cl::init(2),
+                         cl::cat{synthCategory});
+
+cl::opt<unsigned> memOps("mem-ops",
+                         cl::desc("Loads and stores in the innermost body"),
+                         cl::value_desc("N {default = 8}"),
+                         cl::init(8),
+                         cl::cat{synthCategory});
+
+cl::opt<unsigned> numCallees("callees",
+                             cl::desc("Calls to separate functions in the body"),
+                             cl::value_desc("N {default = 0}"),
+                             cl::init(0),
+                             cl::cat{synthCategory});
+
+cl::opt<unsigned> tripCount("trip-count",
+                            cl::desc("Iterations of each loop"),
+                            cl::value_desc("N {default = 16}"),
+                            cl::init(16),
+                            cl::cat{synthCategory});
+
+/**
+ * Operations of the chain, picked round robin
+ */
+static const Instruction::BinaryOps chain_ops[] = {Instruction::Add,
+                                                   Instruction::Mul,
+                                                   Instruction::Sub,
+                                                   Instruction::Xor,
+                                                   Instruction::And,
+                                                   Instruction::Or};
+
+/**
+ * Small leaf function, ((a * b) + a) ^ b
+ */
+static Function*
+createCallee(Module& m, unsigned index) {
+  auto& ctx       = m.getContext();
+  auto* i32_ty    = Type::getInt32Ty(ctx);
+  auto* callee_ty = FunctionType::get(i32_ty, {i32_ty, i32_ty}, false);
+
+  auto* callee = Function::Create(callee_ty,
+                                  GlobalValue::ExternalLinkage,
+                                  fn_name + "_callee" + std::to_string(index),
+                                  &m);
+  callee->addFnAttr(Attribute::NoInline);
+
+  auto _arg = callee->arg_begin();
+  Value* a  = &*_arg++;
+  Value* b  = &*_arg;
+  a->setName("a");
+  b->setName("b");
+
+  IRBuilder<> builder(BasicBlock::Create(ctx, "entry", callee));
+  auto* mul = builder.CreateMul(a, b);
+  auto* add = builder.CreateAdd(mul, a);
+  builder.CreateRet(builder.CreateXor(add, b));
+  return callee;
+}
+
+class KernelBuilder {
+  Module& module;
+  IRBuilder<> builder;
+  Function* function;
+  Value* in;
+  Value* out;
+  Value* seed;
+  vector<Function*> callees;
+
+  // Induction variables from the outermost loop in
+  vector<Value*> induction;
+
+  Value*
+  getIndex(unsigned offset) {
+    Value* _index = nullptr;
+    for (auto _iv : induction)
+      _index = _index ? builder.CreateAdd(_index, _iv) : _iv;
+    if (!_index)
+      return builder.getInt64(offset);
+    if (offset)
+      _index = builder.CreateAdd(_index, builder.getInt32(offset));
+    return builder.CreateSExt(_index, builder.getInt64Ty());
+  }
+
+  Value*
+  getElement(Value* base, unsigned offset) {
+    return builder.CreateGEP(builder.getInt32Ty(), base, getIndex(offset));
+  }
+
+  Value* emitBody(Value* acc);
+  void emitLoop(unsigned depth);
+
+public:
+  explicit KernelBuilder(Module& _module)
+    : module(_module),
+      builder(_module.getContext()),
+      function(nullptr),
+      in(nullptr),
+      out(nullptr),
+      seed(nullptr) {}
+
+  Function* build();
+};
+
+/**
+ * Emits the chain of the innermost body and returns its last value
+ */
+Value*
+KernelBuilder::emitBody(Value* acc) {
+  vector<Value*> _chain;
+  _chain.push_back(acc ? acc : seed);
+  _chain.push_back(seed);
+
+  // Memory operations and calls are placed at even distances along the chain
+  auto _slot = [](unsigned _i, unsigned _count) {
+    return (_i + 1) * numInstructions / (_count + 1);
+  };
+
+  unsigned _next_mem = 0, _next_call = 0, _i = 0;
+  for (;;) {
+    // A fold can step over the slots, they are placed once it is done
+    while (_next_mem < memOps && _slot(_next_mem, memOps) <= _i) {
+      // Loads and stores alternate, each one at its own offset
+      if (_next_mem % 2 == 0)
+        _chain.push_back(builder.CreateLoad(builder.getInt32Ty(), getElement(in, _next_mem)));
+      else
+        builder.CreateStore(_chain.back(), getElement(out, _next_mem));
+      _next_mem++;
+    }
+    while (_next_call < numCallees && _slot(_next_call, numCallees) <= _i) {
+      _chain.push_back(builder.CreateCall(callees[_next_call],
+                                          {_chain.back(), _chain[_chain.size() - 2]}));
+      _next_call++;
+    }
+    if (_i == numInstructions)
+      break;
+
+    // The next value folds the last fanout values, a fanout of one folds the
+    // last value with the seed
+    auto _width  = std::min<size_t>(std::max(1U, fanout.getValue()), _chain.size());
+    Value* _next = _chain.back();
+    for (size_t _d = 2; _d <= std::max<size_t>(_width, 2) && _i < numInstructions;
+         ++_d, ++_i) {
+      auto _op = _width == 1 ? seed : _chain[_chain.size() - _d];
+      _next = builder.CreateBinOp(chain_ops[_i % array_lengthof(chain_ops)], _next, _op);
+    }
+    _chain.push_back(_next);
+  }
+
+  // Keeps the last value of the chain observable
+  builder.CreateStore(_chain.back(), getElement(out, 0));
+  return _chain.back();
+}
+
+/**
+ * Emits a rotated counted loop at the insert point, the builder is left at the
+ * exit block of the loop
+ */
+void
+KernelBuilder::emitLoop(unsigned depth) {
+  auto& _ctx       = module.getContext();
+  auto* _preheader = builder.GetInsertBlock();
+  auto _suffix     = std::to_string(depth);
+  auto* _header    = BasicBlock::Create(_ctx, "loop" + _suffix, function);
+
+  builder.CreateBr(_header);
+  builder.SetInsertPoint(_header);
+
+  auto* _iv = builder.CreatePHI(builder.getInt32Ty(), 2, "i" + _suffix);
+  _iv->addIncoming(builder.getInt32(0), _preheader);
+  induction.push_back(_iv);
+
+  // Only the innermost loop carries a value
+  PHINode* _acc = nullptr;
+  Value* _last  = nullptr;
+  if (depth + 1 < loopDepth) {
+    emitLoop(depth + 1);
+  } else {
+    _acc = builder.CreatePHI(builder.getInt32Ty(), 2, "acc");
+    _acc->addIncoming(builder.getInt32(0), _preheader);
+    _last = emitBody(_acc);
+  }
+
+  auto* _latch = builder.GetInsertBlock();
+  auto* _exit  = BasicBlock::Create(_ctx, "loop" + _suffix + ".exit", function);
+  auto* _next  = builder.CreateAdd(_iv, builder.getInt32(1), "i" + _suffix + ".next");
+  auto* _cmp   = builder.CreateICmpULT(_next, builder.getInt32(tripCount));
+  builder.CreateCondBr(_cmp, _header, _exit);
+
+  _iv->addIncoming(_next, _latch);
+  if (_acc)
+    _acc->addIncoming(_last, _latch);
+
+  induction.pop_back();
+  builder.SetInsertPoint(_exit);
+}
+
+Function*
+KernelBuilder::build() {
+  auto& _ctx    = module.getContext();
+  auto* _i32_ty = builder.getInt32Ty();
+  auto* _ptr_ty = _i32_ty->getPointerTo();
+
+  for (unsigned _c = 0; _c < numCallees; ++_c)
+    callees.push_back(createCallee(module, _c));
+
+  auto* _fn_ty = FunctionType::get(
+      builder.getVoidTy(), {_ptr_ty, _ptr_ty, _i32_ty}, false);
+  function =
+      Function::Create(_fn_ty, GlobalValue::ExternalLinkage, fn_name.getValue(), &module);
+
+  auto _arg = function->arg_begin();
+  in        = &*_arg++;
+  out       = &*_arg++;
+  seed      = &*_arg;
+  in->setName("in");
+  out->setName("out");
+  seed->setName("seed");
+
+  builder.SetInsertPoint(BasicBlock::Create(_ctx, "entry", function));
+  if (loopDepth == 0)
+    emitBody(nullptr);
+  else
+    emitLoop(0);
+  builder.CreateRetVoid();
+
+  return function;
+}
+
+int
+main(int argc, char** argv) {
+  sys::PrintStackTraceOnErrorSignal(argv[0]);
+  llvm::PrettyStackTraceProgram X(argc, argv);
+  llvm_shutdown_obj shutdown;
+  cl::HideUnrelatedOptions(synthCategory);
+  cl::ParseCommandLineOptions(argc, argv, "Synthetic kernel generator\n");
+
+  LLVMContext context;
+  Module module(fn_name.getValue(), context);
+  KernelBuilder(module).build();
+
+  if (verifyModule(module, &errs())) {
+    errs() << "The generated module is broken!\n";
+    return -1;
+  }
+
+  std::error_code errc;
+  raw_fd_ostream out(outFile, errc, sys::fs::F_None);
+  if (errc) {
+    errs() << "Unable to create file: " << outFile << "\n" << errc.message() << "\n";
+    return -1;
+  }
+
+  if (StringRef(outFile.getValue()).endswith(".bc"))
+    WriteBitcodeToFile(&module, out);
+  else
+    module.print(out, nullptr);
+
+  return 0;
+}